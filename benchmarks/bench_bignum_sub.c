@@ -11,15 +11,29 @@
  *   собрать достаточное число сэмплов.
  *
  *   Для чистоты измерений все случайные данные (числа и сдвиги)
- *   генерируются заранее и помещаются в массив. Основной цикл,
- *   который профилируется, выполняет только копирование структуры
- *   и вызов целевой функции, исключая медленный вызов rand().
+ *   генерируются заранее и помещаются в массив, исключая медленный
+ *   вызов rand() из горячего цикла.
+ *
+ *   Режимы горячего цикла (аргумент командной строки, по умолчанию оба):
+ *   - `copy`   — end-to-end: копирование трёх структур bignum_t
+ *                (~800 байт) и вызов целевой функции;
+ *   - `kernel` — только вызов ядра напрямую на предварительно
+ *                сгенерированных массивах; результат удерживается
+ *                живым контрольной суммой и барьером компилятора.
+ *   Для каждого режима печатается время на вызов, так что стоимость
+ *   самого ядра и накладные расходы копирования читаются раздельно.
+ *
+ *   Распределение операндов выбирается ключом `--gen=NAME` (bench_inputs.h);
+ *   по умолчанию `random` — исходный init_random_bignum.
  *
  * @history
  *   - rev 1.0 (12.08.2025): Первоначальная версия.
  *   - rev 1.1 (13.08.2025): Реализована предварительная генерация данных.
  *   - rev 1.2 (13.08.2025): Добавлены локальные определения констант
  *                           BIGNUM_CAPACITY и BIGNUM_BITS для компиляции.
+ *   - rev 1.3 (17.10.2026): Добавлен режим `kernel` без копирования структур,
+ *                           время на вызов печатается для каждого режима.
+ *   - rev 1.4 (17.10.2026): Выбор генератора входных данных (--gen).
  *
  * # Сборка
  *  gcc -g -O2 -I include -no-pie -fno-omit-frame-pointer \
@@ -31,14 +45,21 @@
  *
  * # Отчёт, отфильтрованный по символу
  * /usr/local/bin/perf report -i benchmarks/reports/report_bench_bignum_sub --stdio --symbol-filter=bignum_sub
+ *
+ * # Только один режим и худший случай по заимствованию
+ *  bin/bench_bignum_sub kernel --gen=borrow-storm
  */
 
+#define _GNU_SOURCE
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <bignum.h>
 #include "bignum_sub.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
 
 // --- Локальные определения для компиляции ---
 // Эти константы должны быть синхронизированы с ассемблерным кодом.
@@ -46,6 +67,7 @@
 #define BIGNUM_BITS (BIGNUM_CAPACITY * 64)
 
 // Увеличиваем количество итераций для более надежных измерений
+// (делятся поровну между режимами при запуске обоих)
 #define ITERATIONS (100000000u * 20)
 
 // Количество предварительно сгенерированных наборов данных
@@ -54,21 +76,68 @@
 // Максимальный сдвиг
 #define MAX_SHIFT (BIGNUM_BITS - 1)
 
-/** Заполняет bignum случайными словами и устанавливает len. */
-static void init_random_bignum(bignum_t *num) {
-    int used = (rand() % BIGNUM_CAPACITY) + 1;
-    num->len = used;
-    for (int i = 0; i < used; ++i) {
-        num->words[i] = ((uint64_t)rand() << 32) | rand();
+/** End-to-end: копирование структур и вызов, как в исходной версии бенчмарка. */
+static int run_copy(const bignum_t *res, const bignum_t *a, const bignum_t *b, uint32_t iters) {
+    for (uint32_t i = 0; i < iters; ++i) {
+        // Используем предварительно сгенерированные данные, циклически обращаясь к ним
+        unsigned data_idx = i % PREGEN_DATA_COUNT;
+        
+        // Копируем исходное число, чтобы не портить эталон
+        bignum_t res_dst = res[data_idx];
+        bignum_t a_dst = a[data_idx];
+        bignum_t b_dst = b[data_idx];
+        
+        // Вызываем целевую функцию
+        bignum_sub(&res_dst, &a_dst, &b_dst);
+        
+        // Эта проверка не дает компилятору выбросить вызов функции
+        if (a_dst.len == 0xDEADBEEF) {
+            // Никогда не выполнится
+            printf("Error marker hit.\n");
+            return 1;
+        }
     }
-    for (int i = used; i < BIGNUM_CAPACITY; ++i) {
-        num->words[i] = 0;
+    return 0;
+}
+
+/** Только ядро: вызов на исходных массивах без копирования. */
+static int run_kernel(bignum_t *res, const bignum_t *a, const bignum_t *b, uint32_t iters) {
+    uint64_t checksum = 0;
+    for (uint32_t i = 0; i < iters; ++i) {
+        unsigned data_idx = i % PREGEN_DATA_COUNT;
+
+        bignum_sub_status_t st = bignum_sub(&res[data_idx], &a[data_idx], &b[data_idx]);
+
+        // Контрольная сумма по статусу и младшему слову держит результат живым
+        checksum += (uint64_t)(int64_t)st + res[data_idx].words[0];
+        BENCH_COMPILER_BARRIER();
     }
+    BENCH_KEEP(checksum);
+    return 0;
 }
 
-int main(void) {
+int main(int argc, char **argv) {
+    int do_copy = 1, do_kernel = 1;
+    const bench_gen_t *gen = bench_gen_find("random");
+    bench_gen_params_t gen_params = BENCH_GEN_PARAMS_DEFAULT;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "copy") == 0) {
+            do_kernel = 0;
+        } else if (strcmp(argv[i], "kernel") == 0) {
+            do_copy = 0;
+        } else if (strncmp(argv[i], "--gen=", 6) == 0 && bench_gen_find(argv[i] + 6)) {
+            gen = bench_gen_find(argv[i] + 6);
+        } else {
+            fprintf(stderr, "Usage: %s [copy|kernel] [--gen=NAME]\nGenerators: ", argv[0]);
+            bench_gen_list(stderr);
+            return 1;
+        }
+    }
+    if (!do_copy && !do_kernel) do_copy = do_kernel = 1;
+    uint32_t iters = (do_copy && do_kernel) ? ITERATIONS / 2 : ITERATIONS;
+
     // --- Фаза 1: Предварительная генерация данных ---
-    printf("Pregenerating %u data sets...\n", PREGEN_DATA_COUNT);
+    printf("Pregenerating %u data sets (generator: %s)...\n", PREGEN_DATA_COUNT, gen->name);
 
     bignum_t* res = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
     bignum_t* a = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
@@ -80,33 +149,27 @@ int main(void) {
         return 1;
     }
 
-    srand((unsigned)time(NULL));
+    uint64_t rng = (uint64_t)time(NULL) | 1;
+    memset(res, 0, sizeof(bignum_t) * PREGEN_DATA_COUNT);
     for (unsigned i = 0; i < PREGEN_DATA_COUNT; ++i) {
-        init_random_bignum(&a[i]);
-        init_random_bignum(&b[i]);
+        bench_gen_pair(gen, &a[i], &b[i], &gen_params, &rng);
     }
 
     // --- Фаза 2: "Горячий" цикл для профилирования ---
-    printf("Starting benchmark with %u iterations...\n", ITERATIONS);
-
-    for (uint32_t i = 0; i < ITERATIONS; ++i) {
-        // Используем предварительно сгенерированные данные, циклически обращаясь к ним
-        unsigned data_idx = i % PREGEN_DATA_COUNT;
-        
-        // Копируем исходное число, чтобы не портить эталон
-        bignum_t res_dst = res[data_idx];
-        bignum_t a_dst = a[data_idx];
-        bignum_t b_dst = b[data_idx];
-        
-        // Вызываем целевую функцию
-        bignum_sub(&res_dst, &a_dst, &b_dst);
-        
-        // Эта проверка не дает компилятору выбросить вызов функции
-        if (a_dst.len == 0xDEADBEEF) {
-            // Никогда не выполнится
-            printf("Error marker hit.\n");
-            return 1;
-        }
+    int rc = 0;
+    if (do_copy) {
+        printf("Starting benchmark [copy] with %u iterations...\n", iters);
+        uint64_t t0 = bench_now_ns();
+        rc |= run_copy(res, a, b, iters);
+        uint64_t t1 = bench_now_ns();
+        printf("  [copy]   %.2f ns/call (copy + kernel)\n", (double)(t1 - t0) / iters);
+    }
+    if (do_kernel) {
+        printf("Starting benchmark [kernel] with %u iterations...\n", iters);
+        uint64_t t0 = bench_now_ns();
+        rc |= run_kernel(res, a, b, iters);
+        uint64_t t1 = bench_now_ns();
+        printf("  [kernel] %.2f ns/call (kernel only)\n", (double)(t1 - t0) / iters);
     }
 
     printf("Benchmark finished.\n");
@@ -116,5 +179,5 @@ int main(void) {
     free(b);
     free(res);
 
-    return 0;
+    return rc;
 }
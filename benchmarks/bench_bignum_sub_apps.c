@@ -0,0 +1,423 @@
+/**
+ * @file    bench_bignum_sub_apps.c
+ * @brief   Прикладные бенчмарки: алгоритмы, построенные на bignum_sub, со сквозной пропускной способностью.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Замер одного вызова не показывает, как ядро ведёт себя внутри
+ *   настоящего алгоритма: длины операндов меняются от вызова к вызову,
+ *   результат сразу становится входом следующего шага, рядом работает
+ *   прикладной код. Здесь каждое ядро прогоняется по четырём конвейерам:
+ *
+ *   - `gcd`    — бинарный НОД (Штейн) двух чисел по --len слов:
+ *                bignum_cmp, вычитание меньшего из большего, сдвиг вправо
+ *                на число младших нулевых битов;
+ *   - `rem`    — остаток a mod m школьным сдвигом-вычитанием: m сдвигается
+ *                влево до старшего бита a и затем по одному биту вправо,
+ *                на каждом шаге пробуется a - (m << k); код
+ *                BIGNUM_SUB_NEGATIVE_RESULT служит сравнением;
+ *   - `modadd` — поток сложений по модулю p: x += y_i, затем условное
+ *                вычитание p (длина p — --len, но не больше 31 слова,
+ *                чтобы сумма помещалась в bignum_t);
+ *   - `drain`  — аккумулятор из --len слов, из которого вычитается поток
+ *                вычитаемых случайной длины; при BIGNUM_SUB_NEGATIVE_RESULT
+ *                аккумулятор перезаряжается.
+ *
+ *   Ядро вызывает только bignum_sub (или эталонное ядро из
+ *   bench_ref_kernels.h); сдвиги, сложение и сравнение — общий C-код,
+ *   одинаковый для всех ядер. Результат не может совпадать с операндом
+ *   (BIGNUM_SUB_OVERLAP), поэтому конвейеры переключают буферы.
+ *
+ *   Каждая операция конвейера работает по пулу из POOL_SIZE входов;
+ *   сэмпл — --ops операций, по --samples сэмплам берётся медиана. Печатаются
+ *   операции в секунду, нс и такты TSC на операцию, вызовы ядра на операцию
+ *   и такты на вызов (всё время конвейера, делённое на вызовы ядра).
+ *   Контрольная сумма результатов каждого ядра сверяется с bignum_sub.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *
+ * # Сборка и запуск (release)
+ *  make bench-apps
+ *  taskset 0x1 bin/bench_bignum_sub_apps --len=16 --workload=gcd,rem --csv=benchmarks/reports/current_apps.csv
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bignum_cmp.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
+#include "bench_ref_kernels.h"
+
+// Число входов в пуле конвейера (степень двойки)
+#define POOL_SIZE 64
+
+#define DEFAULT_SAMPLES 11
+#define DEFAULT_OPS     2048
+#define DEFAULT_LEN     16
+
+typedef bignum_sub_status_t (*bench_kernel_fn)(bignum_t *, const bignum_t *, const bignum_t *);
+
+typedef struct {
+    const char     *name;
+    bench_kernel_fn fn;
+} bench_kernel_t;
+
+static const bench_kernel_t kernels[] = {
+    { "bignum_sub", bignum_sub },
+    BENCH_REF_KERNELS
+};
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+typedef struct {
+    unsigned    len;
+    unsigned    samples;
+    unsigned    ops;
+    const char *workloads;   // список конвейеров через запятую или "all"
+    const char *kernels;     // список ядер через запятую или "all"
+    const char *csv_path;
+} options_t;
+
+/** Входы конвейеров: пары (x, y) из POOL_SIZE элементов. */
+typedef struct {
+    bignum_t x[POOL_SIZE];
+    bignum_t y[POOL_SIZE];
+    bignum_t m;              // modadd: модуль p
+} pool_t;
+
+/** Итог одного прогона конвейера. */
+typedef struct {
+    uint64_t calls;      // вызовы ядра
+    uint64_t checksum;   // свёртка результатов
+} run_t;
+
+/* --- Общий C-код конвейеров (одинаков для всех ядер) --- */
+
+static void bn_normalize(bignum_t *x) {
+    while (x->len > 1 && x->words[x->len - 1] == 0) x->len--;
+}
+
+static unsigned bn_bits(const bignum_t *x) {
+    uint64_t top = x->words[x->len - 1];
+    return top ? (unsigned)(x->len - 1) * 64 + 64 - (unsigned)__builtin_clzll(top) : 0;
+}
+
+/** x >>= s на месте. */
+static void bn_shr(bignum_t *x, unsigned s) {
+    unsigned ws = s / 64, bs = s % 64;
+    size_t n = x->len;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t lo = i + ws < n ? x->words[i + ws] : 0;
+        uint64_t hi = i + ws + 1 < n ? x->words[i + ws + 1] : 0;
+        x->words[i] = bs ? (lo >> bs) | (hi << (64 - bs)) : lo;
+    }
+    bn_normalize(x);
+}
+
+/** dst = src << s; старшие биты за пределами BIGNUM_CAPACITY отбрасываются. */
+static void bn_shl(bignum_t *dst, const bignum_t *src, unsigned s) {
+    unsigned ws = s / 64, bs = s % 64;
+    memset(dst->words, 0, sizeof(dst->words));
+    for (size_t i = src->len; i-- > 0;) {
+        if (i + ws < BIGNUM_CAPACITY) dst->words[i + ws] |= src->words[i] << bs;
+        if (bs && i + ws + 1 < BIGNUM_CAPACITY) dst->words[i + ws + 1] |= src->words[i] >> (64 - bs);
+    }
+    dst->len = src->len + ws + 1 > BIGNUM_CAPACITY ? BIGNUM_CAPACITY : src->len + ws + 1;
+    bn_normalize(dst);
+}
+
+/** x += y на месте; перенос за пределы BIGNUM_CAPACITY отбрасывается. */
+static void bn_add(bignum_t *x, const bignum_t *y) {
+    size_t n = x->len > y->len ? x->len : y->len;
+    unsigned char carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t yw = i < y->len ? y->words[i] : 0;
+        uint64_t s = x->words[i] + yw;
+        unsigned char c1 = s < yw;
+        x->words[i] = s + carry;
+        carry = c1 | (x->words[i] < s);
+    }
+    if (carry && n < BIGNUM_CAPACITY) x->words[n++] = 1;
+    x->len = n;
+}
+
+static uint64_t bn_fold(const bignum_t *x) {
+    uint64_t h = x->len;
+    for (size_t i = 0; i < x->len; ++i) h = (h ^ x->words[i]) * 0x100000001B3ull;
+    return h;
+}
+
+static unsigned bn_ctz(const bignum_t *x) {
+    unsigned n = 0;
+    size_t i = 0;
+    for (; i < x->len && x->words[i] == 0; ++i) n += 64;
+    return i < x->len ? n + (unsigned)__builtin_ctzll(x->words[i]) : n;
+}
+
+/* --- Конвейеры --- */
+
+/** Бинарный НОД x[k], y[k]. */
+static uint64_t op_gcd(bench_kernel_fn fn, const pool_t *p, unsigned k, uint64_t *calls) {
+    bignum_t buf[3];
+    bignum_t *u = &buf[0], *v = &buf[1], *t = &buf[2];
+    *u = p->x[k];
+    *v = p->y[k];
+    unsigned zu = bn_ctz(u), zv = bn_ctz(v);
+    bn_shr(u, zu);
+    bn_shr(v, zv);
+    for (;;) {
+        int c = bignum_cmp(u, v);
+        if (c == 0) break;
+        if (c < 0) {
+            bignum_t *s = u;
+            u = v;
+            v = s;
+        }
+        fn(t, u, v);
+        (*calls)++;
+        bn_shr(t, bn_ctz(t));   // u - v чётно и не равно нулю
+        bignum_t *s = u;
+        u = t;
+        t = s;
+    }
+    return bn_fold(u) + (zu < zv ? zu : zv);
+}
+
+/** x[k] mod y[k] сдвигом-вычитанием. */
+static uint64_t op_rem(bench_kernel_fn fn, const pool_t *p, unsigned k, uint64_t *calls) {
+    bignum_t buf[2], d;
+    bignum_t *r = &buf[0], *t = &buf[1];
+    *r = p->x[k];
+    unsigned bx = bn_bits(r), bm = bn_bits(&p->y[k]);
+    if (bx < bm) return bn_fold(r);
+    unsigned shift = bx - bm;
+    bn_shl(&d, &p->y[k], shift);
+    for (unsigned s = 0;; ++s) {
+        (*calls)++;
+        if (fn(t, r, &d) == BIGNUM_SUB_SUCCESS) {
+            bignum_t *x = r;
+            r = t;
+            t = x;
+        }
+        if (s == shift) break;
+        bn_shr(&d, 1);
+    }
+    return bn_fold(r);
+}
+
+/** Сумма потока y[0..POOL_SIZE) по модулю p, начиная с x[k]. */
+static uint64_t op_modadd(bench_kernel_fn fn, const pool_t *p, unsigned k, uint64_t *calls) {
+    bignum_t buf[2];
+    bignum_t *x = &buf[0], *t = &buf[1];
+    *x = p->x[k];
+    for (unsigned i = 0; i < POOL_SIZE; ++i) {
+        bn_add(x, &p->y[(i + k) & (POOL_SIZE - 1)]);
+        (*calls)++;
+        if (fn(t, x, &p->m) == BIGNUM_SUB_SUCCESS) {
+            bignum_t *s = x;
+            x = t;
+            t = s;
+        }
+    }
+    return bn_fold(x);
+}
+
+/** Аккумулятор x[k] минус поток y[] до отрицательного результата (с перезарядкой). */
+static uint64_t op_drain(bench_kernel_fn fn, const pool_t *p, unsigned k, uint64_t *calls) {
+    bignum_t buf[2];
+    bignum_t *acc = &buf[0], *t = &buf[1];
+    uint64_t h = 0;
+    *acc = p->x[k];
+    for (unsigned i = 0; i < POOL_SIZE; ++i) {
+        (*calls)++;
+        if (fn(t, acc, &p->y[(i + k) & (POOL_SIZE - 1)]) == BIGNUM_SUB_SUCCESS) {
+            bignum_t *s = acc;
+            acc = t;
+            t = s;
+        } else {
+            h += bn_fold(acc);
+            *acc = p->x[(k + i + 1) & (POOL_SIZE - 1)];
+        }
+    }
+    return h + bn_fold(acc);
+}
+
+typedef uint64_t (*op_fn)(bench_kernel_fn, const pool_t *, unsigned, uint64_t *);
+
+typedef struct {
+    const char *name;
+    op_fn       op;
+    const char *unit;   // что считается одной операцией
+} workload_t;
+
+static const workload_t workloads[] = {
+    { "gcd",    op_gcd,    "gcd" },
+    { "rem",    op_rem,    "remainder" },
+    { "modadd", op_modadd, "64 mod-adds" },
+    { "drain",  op_drain,  "64 subtrahends" },
+};
+#define WORKLOAD_COUNT (sizeof(workloads) / sizeof(workloads[0]))
+
+/** Входы конвейера `w` с длиной len. */
+static void fill_pool(pool_t *p, const workload_t *w, unsigned len, uint64_t *rng) {
+    for (unsigned i = 0; i < POOL_SIZE; ++i) {
+        if (w->op == op_gcd) {
+            bench_fill_random(&p->x[i], len, rng);
+            bench_fill_random(&p->y[i], len, rng);
+        } else if (w->op == op_rem) {
+            bench_fill_random(&p->x[i], len, rng);
+            bench_fill_random(&p->y[i], len > 1 ? len / 2 : 1, rng);
+        } else if (w->op == op_modadd) {
+            unsigned lm = len < BIGNUM_CAPACITY ? len : BIGNUM_CAPACITY - 1;
+            if (i == 0) bench_fill_random(&p->m, lm, rng);
+            // x, y < p: та же длина, старшее слово меньше
+            bench_fill_random(&p->x[i], lm, rng);
+            bench_fill_random(&p->y[i], lm, rng);
+            p->x[i].words[lm - 1] %= p->m.words[lm - 1];
+            p->y[i].words[lm - 1] %= p->m.words[lm - 1];
+            bn_normalize(&p->x[i]);
+            bn_normalize(&p->y[i]);
+        } else {
+            // Аккумулятор: старшее слово 2^64-1; вычитаемые — случайной длины
+            bench_fill_random(&p->x[i], len, rng);
+            p->x[i].words[len - 1] = UINT64_MAX;
+            bench_fill_random(&p->y[i], bench_rng_len(rng, 1, len), rng);
+        }
+    }
+}
+
+/** `ops` операций по пулу; такты TSC и нс в t_cyc / t_ns. */
+static run_t run_ops(const workload_t *w, bench_kernel_fn fn, const pool_t *p, unsigned ops,
+                     uint64_t *t_cyc, uint64_t *t_ns) {
+    run_t r = { 0, 0 };
+    uint64_t ns0 = bench_now_ns();
+    uint64_t t0 = bench_tsc_start();
+    for (unsigned i = 0; i < ops; ++i) r.checksum += w->op(fn, p, i & (POOL_SIZE - 1), &r.calls);
+    uint64_t t1 = bench_tsc_stop();
+    *t_ns = bench_now_ns() - ns0;
+    *t_cyc = t1 - t0;
+    BENCH_KEEP(r.checksum);
+    return r;
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+/** Есть ли имя в списке через запятую (--workload, --kernel); "all" — все. */
+static int name_selected(const char *list, const char *name) {
+    if (strcmp(list, "all") == 0) return 1;
+    size_t n = strlen(name);
+    for (const char *p = list; p && *p; p = strchr(p, ',') ? strchr(p, ',') + 1 : NULL) {
+        if (strncmp(p, name, n) == 0 && (p[n] == ',' || p[n] == '\0')) return 1;
+    }
+    return 0;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .len = DEFAULT_LEN, .samples = DEFAULT_SAMPLES, .ops = DEFAULT_OPS,
+                      .workloads = "all", .kernels = "all" };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--len="))) o->len = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--samples="))) o->samples = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--ops="))) o->ops = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--workload="))) o->workloads = v;
+        else if ((v = arg_value(argv[i], "--kernel="))) o->kernels = v;
+        else if ((v = arg_value(argv[i], "--csv="))) o->csv_path = v;
+        else return -1;
+    }
+    if (o->samples == 0 || o->ops == 0) return -1;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    if (parse_options(argc, argv, &opt) != 0 || opt.len < 1 || opt.len > BIGNUM_CAPACITY) {
+        fprintf(stderr, "Usage: %s [--len=N] [--samples=N] [--ops=N] [--csv=FILE]\n"
+                        "          [--workload=all|NAME[,NAME...]] [--kernel=all|NAME[,NAME...]]\n"
+                        "Workloads: gcd, rem, modadd, drain\n",
+                argv[0]);
+        return 1;
+    }
+
+    static pool_t pool;
+    double *cyc = malloc(sizeof(double) * opt.samples);
+    double *ns = malloc(sizeof(double) * opt.samples);
+    double *scratch = malloc(sizeof(double) * opt.samples);
+    if (!cyc || !ns || !scratch) {
+        perror("Failed to allocate memory for benchmark data");
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (opt.csv_path) {
+        csv = fopen(opt.csv_path, "w");
+        if (!csv) {
+            perror(opt.csv_path);
+            return 1;
+        }
+        fprintf(csv, "workload,kernel,len,ops,calls_per_op,ops_per_s,ns_per_op,cycles_per_op,"
+                     "cycles_per_call\n");
+    }
+
+    double ghz = bench_tsc_ghz(100);
+    printf("TSC: %.3f GHz; len=%u, %u ops per sample, %u samples\n", ghz, opt.len, opt.ops, opt.samples);
+    printf("%-8s %-14s %16s %10s %12s %10s %12s %9s\n", "workload", "kernel", "op", "calls/op",
+           "ops/s", "ns/op", "cyc/op", "cyc/call");
+
+    int rc = 0;
+    for (size_t w = 0; w < WORKLOAD_COUNT && rc == 0; ++w) {
+        if (!name_selected(opt.workloads, workloads[w].name)) continue;
+        uint64_t rng = 0x9E3779B97F4A7C15ull;
+        fill_pool(&pool, &workloads[w], opt.len, &rng);
+
+        uint64_t expect = 0;
+        for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+            if (k > 0 && !name_selected(opt.kernels, kernels[k].name)) continue;
+            uint64_t tc, tn;
+            // Прогрев и сверка контрольной суммы с bignum_sub (k == 0 — всегда)
+            run_t r = run_ops(&workloads[w], kernels[k].fn, &pool, opt.ops, &tc, &tn);
+            if (k == 0) expect = r.checksum;
+            else if (r.checksum != expect) {
+                fprintf(stderr, "Kernel %s: %s checksum differs from bignum_sub\n",
+                        kernels[k].name, workloads[w].name);
+                rc = 1;
+                break;
+            }
+            if (!name_selected(opt.kernels, kernels[k].name)) continue;
+
+            for (unsigned s = 0; s < opt.samples; ++s) {
+                run_ops(&workloads[w], kernels[k].fn, &pool, opt.ops, &tc, &tn);
+                cyc[s] = (double)tc / opt.ops;
+                ns[s] = (double)tn / opt.ops;
+            }
+            double cyc_op = bench_stats_compute(cyc, scratch, opt.samples).median;
+            double ns_op = bench_stats_compute(ns, scratch, opt.samples).median;
+            double calls_op = (double)r.calls / opt.ops;
+            printf("%-8s %-14s %16s %10.1f %12.0f %10.1f %12.1f %9.2f\n", workloads[w].name,
+                   kernels[k].name, workloads[w].unit, calls_op, 1e9 / ns_op, ns_op, cyc_op,
+                   cyc_op / calls_op);
+            if (csv) {
+                fprintf(csv, "%s,%s,%u,%u,%.3f,%.1f,%.3f,%.3f,%.4f\n", workloads[w].name,
+                        kernels[k].name, opt.len, opt.ops, calls_op, 1e9 / ns_op, ns_op, cyc_op,
+                        cyc_op / calls_op);
+            }
+        }
+    }
+
+    if (csv && fclose(csv) != 0) rc = 1;
+    printf("Benchmark finished.\n");
+    free(scratch);
+    free(ns);
+    free(cyc);
+    return rc;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file    bench_bignum_sub_async.c
+ * @brief   Асинхронный сервис (bignum_sub_async.h) против прямых вызовов при разном числе производителей.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Для каждого числа производителей (1, 2, 4, ... до --max-producers)
+ *   прогоняются три режима, в каждом производитель делает --calls вызовов
+ *   по своей доле заранее сгенерированного пула:
+ *
+ *   - `direct` — производитель сам вызывает bignum_sub;
+ *   - `poll`   — заявки в сервис, до --window заявок в полёте на
+ *                производителя; завершения ожидаются опросом флага;
+ *   - `futex`  — то же, ожидание через bignum_sub_async_wait() с коротким
+ *                опросом и сном на futex.
+ *
+ *   Рабочие потоки сервиса (--workers) закрепляются за последними CPU из
+ *   порядка bench_topology.h, производители — за первыми (по кругу, если
+ *   CPU не хватает). Печатаются суммарная пропускная способность,
+ *   латентность в тактах TSC (p50/p99/p99.9/max; для direct — каждый
+ *   64-й вызов, для сервиса — каждая заявка от постановки до того, как
+ *   производитель увидел завершение), средний размер пакета, число
+ *   засыпаний рабочих потоков и futex-пробуждений ожидающих.
+ *
+ *   Латентность заявки включает ожидание в окне, поэтому растёт вместе с
+ *   --window; --window=1 показывает чистую цену передачи заявки туда и
+ *   обратно.
+ *
+ *   Режим poll осмыслен, только когда у производителей и рабочих потоков
+ *   есть свои CPU: при нехватке CPU опрашивающий поток отнимает квант у
+ *   рабочего, и латентность вырастает до кванта планировщика.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *
+ * # Сборка и запуск (release)
+ *  make bench-async
+ *  bin/bench_bignum_sub_async --workers=2 --max-producers=8 --window=32 --csv=benchmarks/reports/current_async.csv
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bignum_sub_async.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
+#include "bench_topology.h"
+#include "bench_hdr.h"
+
+#define MAX_THREADS 256
+#define PREGEN_DATA_COUNT 8192
+#define MAX_WINDOW 1024
+#define DIRECT_SAMPLE 64
+// Опросов флага перед сном в режиме futex
+#define FUTEX_SPIN 256
+
+#define DEFAULT_CALLS  1000000u
+#define DEFAULT_WINDOW 32
+
+typedef enum { MODE_DIRECT, MODE_POLL, MODE_FUTEX, MODE_COUNT } bench_mode_t;
+static const char *const mode_names[MODE_COUNT] = { "direct", "poll", "futex" };
+
+typedef struct {
+    unsigned    workers;
+    unsigned    max_producers;
+    unsigned    window;
+    unsigned    batch;
+    unsigned    calls;
+    const char *gen;
+    const char *csv_path;
+} options_t;
+
+typedef struct {
+    bench_mode_t        mode;
+    unsigned            calls;
+    unsigned            window;
+    int                 cpu;
+    const bignum_t     *a;
+    const bignum_t     *b;
+    unsigned            data_count;
+    bignum_sub_async_t *svc;
+    pthread_barrier_t  *start;
+    bench_hdr_t        *hist;
+    uint64_t            t_start;
+    uint64_t            t_end;
+    uint64_t            checksum;
+    int                 failed;
+} producer_arg_t;
+
+static void run_direct(producer_arg_t *p, bignum_t *res) {
+    unsigned idx = 0, countdown = DIRECT_SAMPLE;
+    for (unsigned i = 0; i < p->calls; ++i) {
+        bignum_sub_status_t st;
+        if (--countdown == 0) {
+            countdown = DIRECT_SAMPLE;
+            uint64_t t0 = __rdtsc();
+            st = bignum_sub(&res[idx], &p->a[idx], &p->b[idx]);
+            bench_hdr_record(p->hist, __rdtsc() - t0);
+        } else {
+            st = bignum_sub(&res[idx], &p->a[idx], &p->b[idx]);
+        }
+        p->checksum += (uint64_t)(int64_t)st + res[idx].words[0];
+        if (++idx == p->data_count) idx = 0;
+    }
+}
+
+/** Окно из p->window заявок: дождаться самой старой, записать латентность, поставить следующую. */
+static void run_async(producer_arg_t *p, bignum_t *res, bignum_sub_completion_t *c, uint64_t *stamp) {
+    unsigned idx = 0;
+    for (unsigned i = 0; i < p->calls + p->window; ++i) {
+        unsigned k = i % p->window;
+        if (i >= p->window) {
+            bignum_sub_status_t st;
+            if (p->mode == MODE_POLL) {
+                while (!bignum_sub_async_poll(&c[k])) __builtin_ia32_pause();
+                st = c[k].status;
+            } else {
+                st = bignum_sub_async_wait(&c[k], FUTEX_SPIN);
+            }
+            bench_hdr_record(p->hist, __rdtsc() - stamp[k]);
+            p->checksum += (uint64_t)(int64_t)st + res[k].words[0];
+        }
+        if (i >= p->calls) continue;
+        stamp[k] = __rdtsc();
+        while (bignum_sub_async_submit(p->svc, &res[k], &p->a[idx], &p->b[idx], &c[k]) != 0) {
+            sched_yield();
+        }
+        if (++idx == p->data_count) idx = 0;
+    }
+}
+
+static void *producer_main(void *arg) {
+    producer_arg_t *p = arg;
+    size_t nres = p->mode == MODE_DIRECT ? p->data_count : p->window;
+    bignum_t *res = calloc(nres, sizeof(bignum_t));
+    bignum_sub_completion_t *c = calloc(p->window, sizeof(*c));
+    uint64_t *stamp = calloc(p->window, sizeof(*stamp));
+    p->hist = calloc(1, sizeof(bench_hdr_t));
+    if (!res || !c || !stamp || !p->hist) p->failed = 1;
+
+    pthread_barrier_wait(p->start);
+    if (!p->failed) {
+        p->t_start = bench_now_ns();
+        if (p->mode == MODE_DIRECT) run_direct(p, res);
+        else run_async(p, res, c, stamp);
+        p->t_end = bench_now_ns();
+    }
+    free(res);
+    free(c);
+    free(stamp);
+    return NULL;
+}
+
+typedef struct {
+    double   mcalls;
+    uint64_t p50, p99, p999, max;
+    double   avg_batch;
+    uint64_t sleeps, wakeups;
+} point_t;
+
+static int run_point(bench_mode_t mode, unsigned n, const options_t *o, const bench_cpu_t *cpus,
+                     int ncpu, const bignum_t *a, const bignum_t *b, point_t *out) {
+    static pthread_t threads[MAX_THREADS];
+    static producer_arg_t args[MAX_THREADS];
+    bignum_sub_async_t *svc = NULL;
+    int worker_cpus[BIGNUM_SUB_ASYNC_MAX_WORKERS];
+    // Рабочим — последние CPU, производителям — остальные (или все, если CPU мало)
+    int prod_cpus = ncpu > (int)o->workers ? ncpu - (int)o->workers : ncpu;
+    if (mode != MODE_DIRECT) {
+        for (unsigned w = 0; w < o->workers; ++w) worker_cpus[w] = cpus[ncpu - 1 - (int)(w % (unsigned)ncpu)].cpu;
+        bignum_sub_async_config_t cfg = { .workers = o->workers, .ring_size = 0, .batch = o->batch,
+                                          .spin = 0, .cpus = worker_cpus };
+        svc = bignum_sub_async_create(&cfg);
+        if (!svc) {
+            perror("bignum_sub_async_create");
+            return -1;
+        }
+    }
+
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, n);
+    for (unsigned i = 0; i < n; ++i) {
+        unsigned lo = (unsigned)((uint64_t)PREGEN_DATA_COUNT * i / n);
+        unsigned hi = (unsigned)((uint64_t)PREGEN_DATA_COUNT * (i + 1) / n);
+        memset(&args[i], 0, sizeof(args[i]));
+        args[i].mode = mode;
+        args[i].calls = o->calls;
+        args[i].window = o->window;
+        args[i].cpu = cpus[i % (unsigned)prod_cpus].cpu;
+        args[i].a = a + lo;
+        args[i].b = b + lo;
+        args[i].data_count = hi > lo ? hi - lo : 1;
+        args[i].svc = svc;
+        args[i].start = &start;
+
+        pthread_attr_t attr;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(args[i].cpu, &set);
+        pthread_attr_init(&attr);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        int rc = pthread_create(&threads[i], &attr, producer_main, &args[i]);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
+
+    int failed = 0;
+    uint64_t checksum = 0;
+    static bench_hdr_t merged;
+    bench_hdr_reset(&merged);
+    for (unsigned i = 0; i < n; ++i) {
+        pthread_join(threads[i], NULL);
+        failed |= args[i].failed;
+        if (args[i].hist) bench_hdr_merge(&merged, args[i].hist);
+        checksum += args[i].checksum;
+    }
+    pthread_barrier_destroy(&start);
+    BENCH_KEEP(checksum);
+
+    memset(out, 0, sizeof(*out));
+    if (svc) {
+        bignum_sub_async_counters_t cnt;
+        bignum_sub_async_counters(svc, &cnt);
+        bignum_sub_async_destroy(svc);
+        out->avg_batch = cnt.batches ? (double)cnt.calls / (double)cnt.batches : 0.0;
+        out->sleeps = cnt.sleeps;
+        out->wakeups = cnt.wakeups;
+    }
+    uint64_t t0 = args[0].t_start, t1 = args[0].t_end;
+    for (unsigned i = 0; i < n; ++i) {
+        if (args[i].t_start < t0) t0 = args[i].t_start;
+        if (args[i].t_end > t1) t1 = args[i].t_end;
+        free(args[i].hist);
+    }
+    if (failed) return -1;
+    out->mcalls = (double)o->calls * n / ((double)(t1 - t0) * 1e-3);
+    out->p50 = bench_hdr_quantile(&merged, 0.50);
+    out->p99 = bench_hdr_quantile(&merged, 0.99);
+    out->p999 = bench_hdr_quantile(&merged, 0.999);
+    out->max = merged.max;
+    return 0;
+}
+
+/** 1, 2, 4, ... и последней точкой --max-producers. */
+static unsigned next_producers(unsigned n, unsigned max) {
+    if (n == max) return max + 1;
+    return n * 2 < max ? n * 2 : max;
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .workers = 1, .window = DEFAULT_WINDOW, .calls = DEFAULT_CALLS, .gen = "random" };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--workers="))) o->workers = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--max-producers="))) o->max_producers = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--window="))) o->window = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--batch="))) o->batch = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--calls="))) o->calls = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--gen="))) o->gen = v;
+        else if ((v = arg_value(argv[i], "--csv="))) o->csv_path = v;
+        else return -1;
+    }
+    if (o->workers < 1 || o->workers > BIGNUM_SUB_ASYNC_MAX_WORKERS || o->window < 1 ||
+        o->window > MAX_WINDOW || o->batch > BIGNUM_SUB_ASYNC_MAX_BATCH || o->calls == 0 ||
+        !bench_gen_find(o->gen)) {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    if (parse_options(argc, argv, &opt) != 0) {
+        fprintf(stderr, "Usage: %s [--workers=N] [--max-producers=N] [--window=N] [--batch=N]\n"
+                        "          [--calls=N] [--gen=NAME] [--csv=FILE]\n"
+                        "Generators: ", argv[0]);
+        bench_gen_list(stderr);
+        return 1;
+    }
+
+    static bench_cpu_t cpus[MAX_THREADS];
+    int ncpu = bench_cpu_order(cpus, MAX_THREADS);
+    if (ncpu <= 0) {
+        fprintf(stderr, "Failed to read CPU affinity\n");
+        return 1;
+    }
+    if (opt.max_producers == 0) {
+        opt.max_producers = ncpu > (int)opt.workers ? (unsigned)ncpu - opt.workers : 1;
+    }
+    if (opt.max_producers > MAX_THREADS) opt.max_producers = MAX_THREADS;
+
+    const bench_gen_t *gen = bench_gen_find(opt.gen);
+    bench_gen_params_t gen_params = BENCH_GEN_PARAMS_DEFAULT;
+    bignum_t *a = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
+    bignum_t *b = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
+    if (!a || !b) {
+        perror("Failed to allocate memory for test data");
+        return 1;
+    }
+    uint64_t rng = (uint64_t)time(NULL) | 1;
+    for (unsigned i = 0; i < PREGEN_DATA_COUNT; ++i) bench_gen_pair(gen, &a[i], &b[i], &gen_params, &rng);
+
+    FILE *csv = NULL;
+    if (opt.csv_path) {
+        csv = fopen(opt.csv_path, "w");
+        if (!csv) {
+            perror(opt.csv_path);
+            return 1;
+        }
+        fprintf(csv, "mode,producers,workers,window,calls,mcalls_per_s,p50_cyc,p99_cyc,p999_cyc,max_cyc,"
+                     "avg_batch,worker_sleeps,waiter_wakeups\n");
+    }
+
+    printf("Generator %s, %d CPUs, %u worker(s), window %u, %u calls per producer\n",
+           gen->name, ncpu, opt.workers, opt.window, opt.calls);
+    printf("%-7s %9s %10s %8s %8s %8s %10s %9s %10s %10s\n", "mode", "producers", "Mcalls/s",
+           "p50", "p99", "p99.9", "max", "batch", "sleeps", "wakeups");
+    int rc = 0;
+    for (unsigned n = 1; n <= opt.max_producers && rc == 0; n = next_producers(n, opt.max_producers)) {
+        for (int m = 0; m < MODE_COUNT; ++m) {
+            point_t pt;
+            if (run_point((bench_mode_t)m, n, &opt, cpus, ncpu, a, b, &pt) != 0) {
+                fprintf(stderr, "Error in %s with %u producers\n", mode_names[m], n);
+                rc = 1;
+                break;
+            }
+            printf("%-7s %9u %10.2f %8llu %8llu %8llu %10llu %9.1f %10llu %10llu\n", mode_names[m], n,
+                   pt.mcalls, (unsigned long long)pt.p50, (unsigned long long)pt.p99,
+                   (unsigned long long)pt.p999, (unsigned long long)pt.max, pt.avg_batch,
+                   (unsigned long long)pt.sleeps, (unsigned long long)pt.wakeups);
+            if (csv) {
+                fprintf(csv, "%s,%u,%u,%u,%u,%.3f,%llu,%llu,%llu,%llu,%.2f,%llu,%llu\n", mode_names[m], n,
+                        opt.workers, opt.window, opt.calls, pt.mcalls, (unsigned long long)pt.p50,
+                        (unsigned long long)pt.p99, (unsigned long long)pt.p999,
+                        (unsigned long long)pt.max, pt.avg_batch, (unsigned long long)pt.sleeps,
+                        (unsigned long long)pt.wakeups);
+            }
+        }
+    }
+
+    if (csv && fclose(csv) != 0) rc = 1;
+    free(a);
+    free(b);
+    return rc;
+}
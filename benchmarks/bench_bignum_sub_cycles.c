@@ -0,0 +1,646 @@
+/**
+ * @file    bench_bignum_sub_cycles.c
+ * @brief   Потактовый бенчмарк bignum_sub с таблицами по длинам операндов.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   В отличие от bench_bignum_sub.c, не требует perf и sudo: время
+ *   измеряется сериализованным rdtsc/rdtscp (см. bench_timing.h).
+ *
+ *   Каждое ядро прогоняется по матрице "генератор входных данных × ячейка
+ *   длин" (генераторы — bench_inputs.h, по умолчанию все). Для генераторов
+ *   формы GRID ячейки — все пары (a->len, b->len), b->len <= a->len, из
+ *   диапазона [--min-len .. --max-len]; DIAG — только a->len == b->len;
+ *   ROW — только a->len (len_b в отчёте 0); MIX — одна строка со своими
+ *   длинами (len_a = len_b = 0). Для ячейки заранее генерируется пул из
+ *   POOL_SIZE пар операндов (для ROW/MIX — заново перед каждым сэмплом,
+ *   вне замера, чтобы покрыть распределение). Затем выполняются --warmup прогревочных
+ *   и --samples измеряемых сэмплов; каждый сэмпл — это --batch вызовов
+ *   ядра подряд по пулу. По сэмплам считаются медиана и MAD тактов на вызов,
+ *   а также такты на слово (limb) уменьшаемого (для ROW/MIX — на среднюю длину).
+ *
+ *   Кроме bignum_sub, в таблице ядер — эталонные C-реализации из
+ *   bench_ref_kernels.h (`ref_*`); --kernel выбирает подмножество,
+ *   неизвестное имя — ошибка. Перед замерами каждое ядро, включая
+ *   bignum_sub, сверяется на случайных парах с побайтовым эталоном
+ *   ref_bytewise, не зависящим от ассемблерного ядра.
+ *
+ *   Результаты печатаются таблицей и, по запросу, пишутся в CSV/JSON.
+ *   С ключом --samples-csv все сэмплы каждой ячейки (такты на вызов)
+ *   дописываются в отдельный CSV — вход для bench_compare (make bench-compare).
+ *   Повторные запуски с тем же файлом накапливают независимые прогоны.
+ *
+ *   Режим --mode:
+ *   - `throughput` — независимые вызовы по пулу (описано выше);
+ *   - `latency`    — зависимая цепочка: результат каждого вызова становится
+ *                    уменьшаемым следующего (x[i+1] = x[i] - b[k], два буфера
+ *                    результата попеременно). Операнды строятся специально
+ *                    (генератор в отчёте — `chain`): старшее слово x равно
+ *                    2^64-1, старшее слово b не превышает 2^32, и x сбрасывается
+ *                    перед каждым сэмплом, поэтому на всей цепочке a >= b и
+ *                    длина уменьшаемого не меняется. Ячейки — как у GRID.
+ *   - `both` (по умолчанию) — оба режима; для каждой длины в отчёте есть
+ *                    и пропускная способность, и латентность.
+ *
+ *   С ключом --counters для каждой ячейки дополнительно прогоняется
+ *   samples*batch вызовов под группой аппаратных счётчиков (bench_counters.h)
+ *   и печатаются нормированные на вызов IPC, промахи предсказания переходов,
+ *   промахи L1D и µops. Если счётчики недоступны, колонки остаются пустыми.
+ *
+ *   С ключом --energy для каждой ячейки ядро крутится по её пулу не меньше
+ *   --energy-ms миллисекунд (по умолчанию 50: счётчик RAPL обновляется
+ *   раз в ~1 мс) под счётчиком энергии пакета (bench_energy.h), и
+ *   печатается энергия на вызов и на слово a в наноджоулях. В начале
+ *   печатается фоновая мощность пакета. Без RAPL или прав на чтение
+ *   energy_uj колонки остаются пустыми. Ячеек много, поэтому с --energy
+ *   удобно сузить матрицу (--gen, --diag, --max-len).
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *   - rev 1.1 (17.10.2026): Аппаратные счётчики через perf_event_open (--counters).
+ *   - rev 1.2 (17.10.2026): Матрица генераторов входных данных (--gen, --neg-frac, --zipf-s).
+ *   - rev 1.3 (17.10.2026): Режим латентности с зависимой цепочкой вызовов (--mode).
+ *   - rev 1.4 (17.10.2026): Выгрузка сэмплов для сравнения с базовым отчётом (--samples-csv).
+ *   - rev 1.5 (17.10.2026): Эталонные C-ядра в таблице ядер (--kernel).
+ *   - rev 1.6 (17.10.2026): Энергия на вызов и на слово через RAPL (--energy, --energy-ms).
+ *   - rev 1.7 (17.10.2026): Ядра сверяются с ref_bytewise, а не с bignum_sub;
+ *                           неизвестное имя в --kernel отвергается.
+ *
+ * # Сборка (release)
+ *  make bench-cycles CONFIG=release
+ *
+ * # Запуск вручную
+ *  taskset 0x1 bin/bench_bignum_sub_cycles --max-len=32 --samples=31 \
+ *    --csv=benchmarks/reports/current_cycles.csv --json=benchmarks/reports/current_cycles.json
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bench_timing.h"
+#include "bench_counters.h"
+#include "bench_energy.h"
+#include "bench_inputs.h"
+#include "bench_ref_kernels.h"
+
+// Число пар операндов в пуле одной ячейки (степень двойки)
+#define POOL_SIZE 64
+
+#define DEFAULT_SAMPLES 31
+#define DEFAULT_WARMUP  5
+#define DEFAULT_BATCH   256
+
+/** Сигнатура измеряемого ядра (совпадает с bignum_sub). */
+typedef bignum_sub_status_t (*bench_kernel_fn)(bignum_t *, const bignum_t *, const bignum_t *);
+
+/** Описание ядра в таблице измеряемых вариантов. */
+typedef struct {
+    const char     *name;
+    bench_kernel_fn fn;
+} bench_kernel_t;
+
+static const bench_kernel_t kernels[] = {
+    { "bignum_sub", bignum_sub },
+    BENCH_REF_KERNELS
+};
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+/** Режимы измерения. */
+enum {
+    MODE_THROUGHPUT = 1,
+    MODE_LATENCY    = 2
+};
+
+static const char *const mode_names[] = { "", "throughput", "latency" };
+
+/** Параметры запуска. */
+typedef struct {
+    unsigned    min_len;
+    unsigned    max_len;
+    unsigned    samples;
+    unsigned    warmup;
+    unsigned    batch;
+    int         diag;       // только a->len == b->len
+    int         counters;   // собирать аппаратные счётчики
+    int         energy;     // измерять энергию через RAPL
+    unsigned    energy_ms;  // минимальная длительность замера энергии
+    int         modes;      // битовая маска MODE_*
+    const char *gens;       // список генераторов через запятую или "all"
+    const char *kernels;    // список ядер через запятую или "all"
+    bench_gen_params_t gen_params;
+    const char *csv_path;
+    const char *json_path;
+    const char *samples_csv_path;   // все сэмплы по ячейкам (для bench_compare)
+} options_t;
+
+/** Одна строка результата. */
+typedef struct {
+    const char   *kernel;
+    const char   *gen;
+    int           mode;      // MODE_*
+    unsigned      len_a;     // 0 — длины выбирает генератор
+    unsigned      len_b;
+    bench_stats_t st;        // такты TSC на вызов
+    double        per_limb;  // медиана тактов на слово a
+    bench_counter_values_t cnt;  // счётчики на один вызов (valid[] = 0, если нет)
+    double        nj_call;   // энергия пакета на вызов, нДж; < 0 — не измерялась
+    double        nj_limb;   // энергия на слово a, нДж
+} row_t;
+
+/** Заполняет пул генератором; возвращает суммарную длину a по пулу. */
+static unsigned fill_pool(const bench_gen_t *g, bignum_t *a, bignum_t *b, unsigned len_a,
+                          unsigned len_b, const bench_gen_params_t *p, uint64_t *rng) {
+    unsigned total = 0;
+    for (unsigned i = 0; i < POOL_SIZE; ++i) {
+        if (g->shape == BENCH_GEN_MIX) bench_gen_pair(g, &a[i], &b[i], p, rng);
+        else g->fn(&a[i], &b[i], len_a, len_b, p, rng);
+        total += (unsigned)a[i].len;
+    }
+    return total;
+}
+
+/** Измеряемая ячейка: ядро, режим и его данные. */
+typedef struct {
+    bench_kernel_fn fn;
+    int             mode;
+    bignum_t       *res;   // throughput: POOL_SIZE результатов; latency: 2 буфера цепочки
+    const bignum_t *a;     // throughput: пул уменьшаемых; latency: начальное x
+    const bignum_t *b;     // пул вычитаемых
+} cell_t;
+
+/** `batch` независимых вызовов ядра подряд по пулу. */
+static inline void run_throughput(const cell_t *c, unsigned batch) {
+    int acc = 0;
+    for (unsigned i = 0; i < batch; ++i) {
+        unsigned k = i & (POOL_SIZE - 1);
+        acc += c->fn(&c->res[k], &c->a[k], &c->b[k]);
+    }
+    BENCH_KEEP(acc);
+}
+
+/** `batch` зависимых вызовов: результат i-го вызова — уменьшаемое (i+1)-го. */
+static inline void run_latency(const cell_t *c, unsigned batch) {
+    int acc = 0;
+    for (unsigned i = 0; i < batch; ++i) {
+        acc += c->fn(&c->res[(i + 1) & 1], &c->res[i & 1], &c->b[i & (POOL_SIZE - 1)]);
+    }
+    BENCH_KEEP(acc);
+}
+
+/** Подготовка перед сэмплом (вне замера): сброс начала цепочки. */
+static inline void prepare_sample(const cell_t *c) {
+    if (c->mode == MODE_LATENCY) c->res[0] = *c->a;
+}
+
+static inline void run_cell(const cell_t *c, unsigned batch) {
+    if (c->mode == MODE_LATENCY) run_latency(c, batch);
+    else run_throughput(c, batch);
+}
+
+/** Один сэмпл: `batch` вызовов ядра, возвращает такты TSC на вызов. */
+static double measure_sample(const cell_t *c, unsigned batch, double overhead) {
+    prepare_sample(c);
+    uint64_t t0 = bench_tsc_start();
+    run_cell(c, batch);
+    uint64_t t1 = bench_tsc_stop();
+    double ticks = (double)(t1 - t0) - overhead;
+    return (ticks > 0 ? ticks : 0) / batch;
+}
+
+/** Прогон под аппаратными счётчиками; значения нормируются на один вызов. */
+static void measure_counters(const bench_counters_t *cnt, const cell_t *c, const options_t *o,
+                             bench_counter_values_t *out) {
+    double calls = (double)o->samples * o->batch;
+    memset(out, 0, sizeof(*out));
+    bench_counters_start(cnt);
+    for (unsigned s = 0; s < o->samples; ++s) {
+        prepare_sample(c);
+        run_cell(c, o->batch);
+    }
+    if (bench_counters_stop(cnt, out) != 0) return;
+    for (int i = 0; i < BENCH_CNT_COUNT; ++i) out->value[i] /= calls;
+}
+
+/**
+ * Вызовы по ячейке не меньше `ms` миллисекунд под счётчиком энергии.
+ * @return энергия пакета на вызов, нДж; < 0 — недоступно.
+ */
+static double measure_energy(bench_energy_t *e, const cell_t *c, unsigned batch, unsigned ms) {
+    uint64_t calls = 0, deadline;
+    bench_energy_start(e);
+    deadline = bench_now_ns() + (uint64_t)ms * 1000000u;
+    do {
+        prepare_sample(c);
+        run_cell(c, batch);
+        calls += batch;
+    } while (bench_now_ns() < deadline);
+    double uj = bench_energy_stop(e);
+    return uj < 0 ? -1.0 : uj * 1e3 / (double)calls;
+}
+
+/** Операнды цепочки латентности: x с len_a словами и пул b с len_b словами. */
+static void fill_chain(bignum_t *x, bignum_t *b, unsigned len_a, unsigned len_b, uint64_t *rng) {
+    bench_fill_random(x, len_a, rng);
+    x->words[len_a - 1] = UINT64_MAX;
+    for (unsigned i = 0; i < POOL_SIZE; ++i) {
+        bench_fill_random(&b[i], len_b, rng);
+        b[i].words[len_b - 1] = (b[i].words[len_b - 1] >> 32) | 1;
+    }
+}
+
+/** IPC из нормированных значений; < 0 — недоступно. */
+static double counters_ipc(const bench_counter_values_t *v) {
+    if (!v->valid[BENCH_CNT_CYCLES] || !v->valid[BENCH_CNT_INSTRUCTIONS] ||
+        v->value[BENCH_CNT_CYCLES] <= 0) {
+        return -1.0;
+    }
+    return v->value[BENCH_CNT_INSTRUCTIONS] / v->value[BENCH_CNT_CYCLES];
+}
+
+/** Печать значения счётчика в CSV/JSON: пусто/null, если недоступно. */
+static void fprint_counter(FILE *f, int valid, double v, const char *missing) {
+    if (valid) fprintf(f, "%.4f", v);
+    else fputs(missing, f);
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--min-len=N] [--max-len=N] [--samples=N] [--warmup=N]\n"
+            "          [--batch=N] [--diag] [--counters] [--csv=FILE] [--json=FILE]\n"
+            "          [--gen=all|NAME[,NAME...]] [--neg-frac=F] [--zipf-s=S]\n"
+            "          [--mode=throughput|latency|both] [--samples-csv=FILE]\n"
+            "          [--kernel=all|NAME[,NAME...]] [--energy] [--energy-ms=N]\n"
+            "Generators: ", prog);
+    bench_gen_list(stderr);
+    fprintf(stderr, "Kernels: ");
+    for (size_t k = 0; k < KERNEL_COUNT; ++k) fprintf(stderr, "%s%s", k ? ", " : "", kernels[k].name);
+    fputc('\n', stderr);
+}
+
+/** Каждое имя списка --kernel есть в таблице ядер ("all" — все). */
+static int kernel_list_valid(const char *list) {
+    if (strcmp(list, "all") == 0) return 1;
+    for (const char *p = list; p && *p; p = strchr(p, ',') ? strchr(p, ',') + 1 : NULL) {
+        size_t n = strchr(p, ',') ? (size_t)(strchr(p, ',') - p) : strlen(p);
+        size_t k = 0;
+        while (k < KERNEL_COUNT && (strlen(kernels[k].name) != n || strncmp(p, kernels[k].name, n) != 0)) k++;
+        if (k == KERNEL_COUNT) return 0;
+    }
+    return 1;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .min_len = 1, .max_len = BIGNUM_CAPACITY, .samples = DEFAULT_SAMPLES,
+                      .warmup = DEFAULT_WARMUP, .batch = DEFAULT_BATCH, .gens = "all", .kernels = "all",
+                      .modes = MODE_THROUGHPUT | MODE_LATENCY, .energy_ms = 50,
+                      .gen_params = BENCH_GEN_PARAMS_DEFAULT };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--min-len="))) o->min_len = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--max-len="))) o->max_len = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--samples="))) o->samples = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--warmup="))) o->warmup = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--batch="))) o->batch = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--csv="))) o->csv_path = v;
+        else if ((v = arg_value(argv[i], "--json="))) o->json_path = v;
+        else if ((v = arg_value(argv[i], "--samples-csv="))) o->samples_csv_path = v;
+        else if ((v = arg_value(argv[i], "--gen="))) o->gens = v;
+        else if ((v = arg_value(argv[i], "--kernel="))) o->kernels = v;
+        else if ((v = arg_value(argv[i], "--neg-frac="))) o->gen_params.neg_frac = strtod(v, NULL);
+        else if ((v = arg_value(argv[i], "--zipf-s="))) o->gen_params.zipf_s = strtod(v, NULL);
+        else if ((v = arg_value(argv[i], "--energy-ms="))) o->energy_ms = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--mode="))) {
+            if (strcmp(v, "throughput") == 0) o->modes = MODE_THROUGHPUT;
+            else if (strcmp(v, "latency") == 0) o->modes = MODE_LATENCY;
+            else if (strcmp(v, "both") == 0) o->modes = MODE_THROUGHPUT | MODE_LATENCY;
+            else return -1;
+        }
+        else if (strcmp(argv[i], "--diag") == 0) o->diag = 1;
+        else if (strcmp(argv[i], "--counters") == 0) o->counters = 1;
+        else if (strcmp(argv[i], "--energy") == 0) o->energy = 1;
+        else return -1;
+    }
+    if (o->min_len < 1 || o->max_len > BIGNUM_CAPACITY || o->min_len > o->max_len ||
+        o->samples == 0 || o->batch == 0 || o->energy_ms == 0 || !kernel_list_valid(o->kernels)) {
+        return -1;
+    }
+    return 0;
+}
+
+/** Есть ли имя в списке через запятую (--gen, --kernel); "all" — все. */
+static int name_selected(const char *list, const char *name) {
+    if (strcmp(list, "all") == 0) return 1;
+    size_t n = strlen(name);
+    for (const char *p = list; p && *p; p = strchr(p, ',') ? strchr(p, ',') + 1 : NULL) {
+        if (strncmp(p, name, n) == 0 && (p[n] == ',' || p[n] == '\0')) return 1;
+    }
+    return 0;
+}
+
+static int write_csv(const char *path, const row_t *rows, size_t n, double ghz) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "kernel,mode,generator,len_a,len_b,samples,median_cycles,mad_cycles,min_cycles,max_cycles,"
+               "cycles_per_limb,ns_per_call,ipc,nj_per_call,nj_per_limb");
+    for (int c = 0; c < BENCH_CNT_COUNT; ++c) fprintf(f, ",%s_per_call", bench_counter_names[c]);
+    fputc('\n', f);
+    for (size_t i = 0; i < n; ++i) {
+        const row_t *r = &rows[i];
+        double ipc = counters_ipc(&r->cnt);
+        fprintf(f, "%s,%s,%s,%u,%u,%u,%.3f,%.3f,%.3f,%.3f,%.4f,%.3f,",
+                r->kernel, mode_names[r->mode], r->gen, r->len_a, r->len_b, r->st.n, r->st.median, r->st.mad,
+                r->st.min, r->st.max, r->per_limb, r->st.median / ghz);
+        fprint_counter(f, ipc >= 0, ipc, "");
+        fputc(',', f);
+        fprint_counter(f, r->nj_call >= 0, r->nj_call, "");
+        fputc(',', f);
+        fprint_counter(f, r->nj_call >= 0, r->nj_limb, "");
+        for (int c = 0; c < BENCH_CNT_COUNT; ++c) {
+            fputc(',', f);
+            fprint_counter(f, r->cnt.valid[c], r->cnt.value[c], "");
+        }
+        fputc('\n', f);
+    }
+    fclose(f);
+    return 0;
+}
+
+static int write_json(const char *path, const row_t *rows, size_t n, double ghz,
+                      double overhead, const options_t *o) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"tsc_ghz\": %.4f,\n  \"tsc_overhead\": %.1f,\n"
+               "  \"samples\": %u,\n  \"warmup\": %u,\n  \"batch\": %u,\n  \"results\": [\n",
+            ghz, overhead, o->samples, o->warmup, o->batch);
+    for (size_t i = 0; i < n; ++i) {
+        const row_t *r = &rows[i];
+        fprintf(f, "    {\"kernel\": \"%s\", \"mode\": \"%s\", \"generator\": \"%s\", \"len_a\": %u, \"len_b\": %u, "
+                   "\"median_cycles\": %.3f, \"mad_cycles\": %.3f, \"min_cycles\": %.3f, "
+                   "\"max_cycles\": %.3f, \"cycles_per_limb\": %.4f, \"ns_per_call\": %.3f, "
+                   "\"ipc\": ",
+                r->kernel, mode_names[r->mode], r->gen, r->len_a, r->len_b, r->st.median,
+                r->st.mad, r->st.min, r->st.max, r->per_limb, r->st.median / ghz);
+        double ipc = counters_ipc(&r->cnt);
+        fprint_counter(f, ipc >= 0, ipc, "null");
+        fprintf(f, ", \"nj_per_call\": ");
+        fprint_counter(f, r->nj_call >= 0, r->nj_call, "null");
+        fprintf(f, ", \"nj_per_limb\": ");
+        fprint_counter(f, r->nj_call >= 0, r->nj_limb, "null");
+        for (int c = 0; c < BENCH_CNT_COUNT; ++c) {
+            fprintf(f, ", \"%s_per_call\": ", bench_counter_names[c]);
+            fprint_counter(f, r->cnt.valid[c], r->cnt.value[c], "null");
+        }
+        fprintf(f, "}%s\n", i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 0;
+}
+
+/** Состояние прогона, общее для всех ячеек. */
+typedef struct {
+    options_t         opt;
+    bignum_t         *res;
+    bignum_t         *a;
+    bignum_t         *b;
+    double           *samples;
+    double           *scratch;
+    row_t            *rows;
+    size_t            n_rows;
+    bench_counters_t  counters;
+    bench_energy_t    energy;
+    double            overhead;
+    double            ghz;
+    uint64_t          rng;
+    FILE             *samples_csv;   // NULL — сэмплы не выгружаются
+} bench_ctx_t;
+
+/**
+ * Прогрев, замер сэмплов и счётчики для одной ячейки. Если задан `refill`,
+ * пул перегенерируется им перед каждым сэмплом, кроме первого (вне замера);
+ * `limbs` — суммарная длина a по начальному пулу, для тактов на слово.
+ */
+static row_t *measure_row(bench_ctx_t *ctx, const cell_t *c, const char *kernel, const char *gen,
+                          unsigned la, unsigned lb, const bench_gen_t *refill, unsigned limbs) {
+    const options_t *o = &ctx->opt;
+    unsigned pools = 1;
+    for (unsigned w = 0; w < o->warmup; ++w) measure_sample(c, o->batch, ctx->overhead);
+    for (unsigned s = 0; s < o->samples; ++s) {
+        if (refill && s > 0) {
+            limbs += fill_pool(refill, ctx->a, ctx->b, la, lb, &o->gen_params, &ctx->rng);
+            pools++;
+        }
+        ctx->samples[s] = measure_sample(c, o->batch, ctx->overhead);
+    }
+    if (ctx->samples_csv) {
+        for (unsigned s = 0; s < o->samples; ++s) {
+            fprintf(ctx->samples_csv, "%s,%s,%s,%u,%u,%u,%.3f\n", kernel, mode_names[c->mode], gen,
+                    la, lb, s, ctx->samples[s]);
+        }
+    }
+
+    row_t *r = &ctx->rows[ctx->n_rows++];
+    r->kernel = kernel;
+    r->gen = gen;
+    r->mode = c->mode;
+    r->len_a = la;
+    r->len_b = lb;
+    r->st = bench_stats_compute(ctx->samples, ctx->scratch, o->samples);
+    double avg_len = (double)limbs / (pools * POOL_SIZE);
+    r->per_limb = r->st.median / avg_len;
+    memset(&r->cnt, 0, sizeof(r->cnt));
+    if (o->counters) measure_counters(&ctx->counters, c, o, &r->cnt);
+    r->nj_call = o->energy ? measure_energy(&ctx->energy, c, o->batch, o->energy_ms) : -1.0;
+    r->nj_limb = r->nj_call / avg_len;
+    return r;
+}
+
+static void print_row(const bench_ctx_t *ctx, const row_t *r) {
+    printf("%-14s %-10s %-13s %5u %5u %10.2f %8.2f %10.2f %10.3f %9.2f",
+           r->kernel, mode_names[r->mode], r->gen, r->len_a, r->len_b, r->st.median,
+           r->st.mad, r->st.min, r->per_limb, r->st.median / ctx->ghz);
+    if (ctx->opt.counters) {
+        printf(" %6.2f %8.4f %8.4f %8.2f", counters_ipc(&r->cnt),
+               r->cnt.value[BENCH_CNT_BRANCH_MISSES],
+               r->cnt.value[BENCH_CNT_L1D_MISSES], r->cnt.value[BENCH_CNT_UOPS]);
+    }
+    if (ctx->opt.energy && r->nj_call >= 0) printf(" %9.3f %9.4f", r->nj_call, r->nj_limb);
+    else if (ctx->opt.energy) printf(" %9s %9s", "-", "-");
+    printf("\n");
+}
+
+/** Режим throughput: матрица генераторов × ячеек длин. */
+static void run_throughput_matrix(bench_ctx_t *ctx, const bench_kernel_t *kernel) {
+    const options_t *o = &ctx->opt;
+    cell_t c = { kernel->fn, MODE_THROUGHPUT, ctx->res, ctx->a, ctx->b };
+
+    for (size_t g = 0; g < BENCH_GEN_COUNT; ++g) {
+        const bench_gen_t *gen = &bench_generators[g];
+        if (!name_selected(o->gens, gen->name)) continue;
+        unsigned la_min = o->min_len, la_max = o->max_len;
+        if (gen->shape == BENCH_GEN_MIX) la_min = la_max = 0;
+
+        for (unsigned la = la_min; la <= la_max; ++la) {
+            unsigned lb_min = 1, lb_max = la;
+            if (gen->shape == BENCH_GEN_DIAG || o->diag) lb_min = la;
+            if (gen->shape == BENCH_GEN_ROW || gen->shape == BENCH_GEN_MIX) lb_min = lb_max = 0;
+
+            for (unsigned lb = lb_min; lb <= lb_max; ++lb) {
+                unsigned limbs = fill_pool(gen, ctx->a, ctx->b, la, lb, &o->gen_params, &ctx->rng);
+                // Для ROW/MIX длины случайны: свежий пул на каждый сэмпл
+                int refill = gen->shape == BENCH_GEN_ROW || gen->shape == BENCH_GEN_MIX;
+                print_row(ctx, measure_row(ctx, &c, kernel->name, gen->name, la, lb,
+                                           refill ? gen : NULL, limbs));
+            }
+        }
+    }
+}
+
+/** Режим latency: зависимые цепочки по ячейкам длин. */
+static void run_latency_matrix(bench_ctx_t *ctx, const bench_kernel_t *kernel) {
+    const options_t *o = &ctx->opt;
+    bignum_t x0;
+    cell_t c = { kernel->fn, MODE_LATENCY, ctx->res, &x0, ctx->b };
+
+    for (unsigned la = o->min_len; la <= o->max_len; ++la) {
+        for (unsigned lb = o->diag ? la : 1; lb <= la; ++lb) {
+            fill_chain(&x0, ctx->b, la, lb, &ctx->rng);
+            print_row(ctx, measure_row(ctx, &c, kernel->name, "chain", la, lb, NULL, la * POOL_SIZE));
+        }
+    }
+}
+
+/**
+ * Сверяет ядро с эталоном ref_bytewise на случайных парах всех
+ * генераторов: код возврата, слова и длина результата. Эталон —
+ * побайтовый цикл на C, он не зависит от проверяемого ассемблерного ядра.
+ * @return 0 — совпадает.
+ */
+static int verify_kernel(const bench_kernel_t *k, uint64_t *rng) {
+    bignum_t a, b, want, got;
+    const bench_gen_params_t p = BENCH_GEN_PARAMS_DEFAULT;
+    for (size_t g = 0; g < BENCH_GEN_COUNT; ++g) {
+        for (unsigned i = 0; i < 256; ++i) {
+            bench_gen_pair(&bench_generators[g], &a, &b, &p, rng);
+            memset(&want, 0xA5, sizeof(want));
+            memset(&got, 0x5A, sizeof(got));
+            bignum_sub_status_t sw = ref_bytewise(&want, &a, &b);
+            bignum_sub_status_t sg = k->fn(&got, &a, &b);
+            if (sw != sg || (sw == BIGNUM_SUB_SUCCESS && memcmp(&want, &got, sizeof(want)) != 0)) {
+                fprintf(stderr, "Kernel %s differs from ref_bytewise (generator %s, len_a=%zu, len_b=%zu)\n",
+                        k->name, bench_generators[g].name, a.len, b.len);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    static bench_ctx_t ctx;
+    if (parse_options(argc, argv, &ctx.opt) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    const options_t *opt = &ctx.opt;
+
+    ctx.res = aligned_alloc(64, sizeof(bignum_t) * POOL_SIZE);
+    ctx.a = aligned_alloc(64, sizeof(bignum_t) * POOL_SIZE);
+    ctx.b = aligned_alloc(64, sizeof(bignum_t) * POOL_SIZE);
+    ctx.samples = malloc(sizeof(double) * opt->samples);
+    ctx.scratch = malloc(sizeof(double) * opt->samples);
+    // Верхняя оценка: все генераторы в форме GRID плюс цепочки латентности
+    size_t max_rows = (size_t)KERNEL_COUNT * (BENCH_GEN_COUNT + 1) * BIGNUM_CAPACITY * BIGNUM_CAPACITY;
+    ctx.rows = malloc(sizeof(row_t) * max_rows);
+    if (!ctx.res || !ctx.a || !ctx.b || !ctx.samples || !ctx.scratch || !ctx.rows) {
+        perror("Failed to allocate memory for benchmark data");
+        return 1;
+    }
+    memset(ctx.res, 0, sizeof(bignum_t) * POOL_SIZE);
+    ctx.rng = 0x9E3779B97F4A7C15ull;
+
+    if (opt->samples_csv_path) {
+        ctx.samples_csv = fopen(opt->samples_csv_path, "a");
+        if (!ctx.samples_csv) {
+            perror(opt->samples_csv_path);
+            return 1;
+        }
+        fseek(ctx.samples_csv, 0, SEEK_END);
+        if (ftell(ctx.samples_csv) == 0) {
+            fprintf(ctx.samples_csv, "kernel,mode,generator,len_a,len_b,sample,cycles\n");
+        }
+    }
+
+    if (opt->counters && bench_counters_open(&ctx.counters) == 0) {
+        fprintf(stderr, "Hardware counters unavailable (perf_event_open failed), continuing without them\n");
+        ctx.opt.counters = 0;
+    }
+    if (opt->energy && bench_energy_open(&ctx.energy) == 0) {
+        fprintf(stderr, "RAPL energy counters unavailable (/sys/class/powercap/intel-rapl:*/energy_uj), "
+                        "continuing without them\n");
+        ctx.opt.energy = 0;
+    }
+
+    ctx.overhead = bench_tsc_overhead();
+    ctx.ghz = bench_tsc_ghz(100);
+    printf("TSC: %.3f GHz, timing overhead %.1f cycles; samples=%u warmup=%u batch=%u\n",
+           ctx.ghz, ctx.overhead, opt->samples, opt->warmup, opt->batch);
+    if (opt->energy) {
+        printf("RAPL: %u package domain(s), idle %.2f W\n", ctx.energy.n,
+               bench_energy_idle_watts(&ctx.energy, 200));
+    }
+    printf("%-14s %-10s %-13s %5s %5s %10s %8s %10s %10s %9s",
+           "kernel", "mode", "generator", "len_a", "len_b", "cyc/call", "MAD", "min",
+           "cyc/limb", "ns/call");
+    if (opt->counters) printf(" %6s %8s %8s %8s", "IPC", "br-miss", "L1D-miss", "uops");
+    if (opt->energy) printf(" %9s %9s", "nJ/call", "nJ/limb");
+    printf("\n");
+
+    for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+        if (!name_selected(opt->kernels, kernels[k].name)) continue;
+        if (verify_kernel(&kernels[k], &ctx.rng) != 0) return 1;
+    }
+
+    for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+        if (!name_selected(opt->kernels, kernels[k].name)) continue;
+        if (opt->modes & MODE_THROUGHPUT) run_throughput_matrix(&ctx, &kernels[k]);
+        if (opt->modes & MODE_LATENCY) run_latency_matrix(&ctx, &kernels[k]);
+    }
+
+    int rc = 0;
+    if (opt->csv_path && write_csv(opt->csv_path, ctx.rows, ctx.n_rows, ctx.ghz) != 0) rc = 1;
+    if (opt->json_path &&
+        write_json(opt->json_path, ctx.rows, ctx.n_rows, ctx.ghz, ctx.overhead, opt) != 0) {
+        rc = 1;
+    }
+
+    if (ctx.samples_csv && fclose(ctx.samples_csv) != 0) rc = 1;
+    printf("Benchmark finished.\n");
+
+    if (opt->counters) bench_counters_close(&ctx.counters);
+    if (opt->energy) bench_energy_close(&ctx.energy);
+    free(ctx.rows);
+    free(ctx.scratch);
+    free(ctx.samples);
+    free(ctx.b);
+    free(ctx.a);
+    free(ctx.res);
+    return rc;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file    bench_bignum_sub_expr.cpp
+ * @brief   Слитые выражения bn::num (bignum_sub_expr.hpp) против цепочки операторов с временными bignum_t.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Для каждой длины операндов (--len, по умолчанию 4, 8, 16, 32) и
+ *   каждого выражения
+ *
+ *   - `sub2`  — r = a - b;
+ *   - `sub3`  — r = a - b - c;
+ *   - `sub4`  — r = a - b - c - d;
+ *   - `sub8`  — r = a - b - c - d - e - f - g - h;
+ *   - `mixed` — r = a - b - c + d
+ *
+ *   измеряются два способа вычисления на одном пуле операндов:
+ *
+ *   - `naive` — обычная обёртка: каждый оператор возвращает временный
+ *               bignum_t и делает полный вызов bignum_sub (с проверками и
+ *               bignum_cmp); `+` — такой же проход сложения на C;
+ *   - `fused` — шаблоны выражений: один проход по словам в приёмник.
+ *
+ *   Перед замером результаты обоих способов сверяются по всему пулу.
+ *   Печатаются медиана и MAD тактов TSC на выражение и ускорение
+ *   naive/fused; с --csv=FILE строки дублируются в CSV.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *
+ * # Сборка и запуск (release)
+ *  make bench-expr
+ *  bin/bench_bignum_sub_expr --len=16 --samples=501 --csv=benchmarks/reports/current_expr.csv
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bignum_sub_expr.hpp"
+#include "bench_timing.h"
+
+#define POOL 32
+#define OPERANDS 8
+#define DEFAULT_SAMPLES 201
+
+/** Обёртка "как обычно": оператор — временный bignum_t и полный вызов ядра. */
+struct naive_num {
+    bignum_t v;
+};
+
+static unsigned naive_errors = 0;
+
+static naive_num operator-(const naive_num &a, const naive_num &b) {
+    naive_num t;
+    if (bignum_sub(&t.v, &a.v, &b.v) != BIGNUM_SUB_SUCCESS) naive_errors++;
+    return t;
+}
+
+/** Сложение с тем же контрактом, что у ядра: все слова записаны, длина нормализована. */
+static naive_num operator+(const naive_num &a, const naive_num &b) {
+    naive_num t;
+    size_t len = a.v.len > b.v.len ? a.v.len : b.v.len;
+    unsigned carry = 0;
+    for (size_t i = 0; i < len; ++i) {
+        uint64_t x = i < a.v.len ? a.v.words[i] : 0, y = i < b.v.len ? b.v.words[i] : 0;
+        uint64_t s = x + y;
+        unsigned c1 = s < x;
+        t.v.words[i] = s + carry;
+        carry = c1 | (t.v.words[i] < s);
+    }
+    if (carry) {
+        if (len == BIGNUM_CAPACITY) naive_errors++;
+        else t.v.words[len++] = 1;
+    }
+    memset(&t.v.words[len], 0, sizeof(uint64_t) * (BIGNUM_CAPACITY - len));
+    while (len > 1 && t.v.words[len - 1] == 0) len--;
+    t.v.len = len;
+    return t;
+}
+
+typedef enum { EXPR_SUB2, EXPR_SUB3, EXPR_SUB4, EXPR_SUB8, EXPR_MIXED, EXPR_COUNT } expr_kind_t;
+static const char *const expr_names[EXPR_COUNT] = { "sub2", "sub3", "sub4", "sub8", "mixed" };
+
+/** Пул: OPERANDS операндов на выражение; x[0] — уменьшаемое, остальные заметно меньше. */
+static naive_num naive_in[POOL][OPERANDS], naive_out[POOL];
+static bn::num fused_in[POOL][OPERANDS], fused_out[POOL];
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void fill_pool(unsigned len) {
+    for (unsigned p = 0; p < POOL; ++p) {
+        for (unsigned j = 0; j < OPERANDS; ++j) {
+            bignum_t &x = naive_in[p][j].v;
+            memset(&x, 0, sizeof(x));
+            for (unsigned i = 0; i < len; ++i) x.words[i] = rng_next();
+            // Старшее слово: у уменьшаемого большое, у остальных — не больше 1/16 от него
+            x.words[len - 1] = j == 0 ? (rng_next() | (1ull << 62)) >> 1 : 1 + rng_next() % (1ull << 56);
+            x.len = len;
+            fused_in[p][j].v = x;
+        }
+    }
+}
+
+static void run_naive(expr_kind_t k) {
+    for (unsigned p = 0; p < POOL; ++p) {
+        const naive_num *x = naive_in[p];
+        switch (k) {
+        case EXPR_SUB2: naive_out[p] = x[0] - x[1]; break;
+        case EXPR_SUB3: naive_out[p] = x[0] - x[1] - x[2]; break;
+        case EXPR_SUB4: naive_out[p] = x[0] - x[1] - x[2] - x[3]; break;
+        case EXPR_SUB8: naive_out[p] = x[0] - x[1] - x[2] - x[3] - x[4] - x[5] - x[6] - x[7]; break;
+        default: naive_out[p] = x[0] - x[1] - x[2] + x[3]; break;
+        }
+    }
+}
+
+static unsigned run_fused(expr_kind_t k) {
+    unsigned errors = 0;
+    for (unsigned p = 0; p < POOL; ++p) {
+        const bn::num *x = fused_in[p];
+        bignum_sub_status_t st;
+        switch (k) {
+        case EXPR_SUB2: st = fused_out[p].assign(x[0] - x[1]); break;
+        case EXPR_SUB3: st = fused_out[p].assign(x[0] - x[1] - x[2]); break;
+        case EXPR_SUB4: st = fused_out[p].assign(x[0] - x[1] - x[2] - x[3]); break;
+        case EXPR_SUB8: st = fused_out[p].assign(x[0] - x[1] - x[2] - x[3] - x[4] - x[5] - x[6] - x[7]); break;
+        default: st = fused_out[p].assign(x[0] - x[1] - x[2] + x[3]); break;
+        }
+        errors += st != BIGNUM_SUB_SUCCESS;
+    }
+    return errors;
+}
+
+/** Медиана и MAD тактов на выражение по `samples` проходам пула. */
+template <class F>
+static bench_stats_t measure(F run, unsigned samples, double overhead) {
+    std::vector<double> v(samples), scratch(samples);
+    run();
+    for (unsigned s = 0; s < samples; ++s) {
+        uint64_t t0 = bench_tsc_start();
+        run();
+        uint64_t t1 = bench_tsc_stop();
+        v[s] = ((double)(t1 - t0) - overhead) / POOL;
+    }
+    return bench_stats_compute(v.data(), scratch.data(), samples);
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+int main(int argc, char **argv) {
+    unsigned only_len = 0, samples = DEFAULT_SAMPLES;
+    const char *csv_path = NULL, *v;
+    int bad = 0;
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--len="))) bad |= (only_len = (unsigned)strtoul(v, NULL, 10)) == 0;
+        else if ((v = arg_value(argv[i], "--samples="))) samples = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--csv="))) csv_path = v;
+        else bad = 1;
+    }
+    if (bad || only_len > BIGNUM_CAPACITY || samples == 0) {
+        fprintf(stderr, "Usage: %s [--len=1..%d] [--samples=N] [--csv=FILE]\n", argv[0], BIGNUM_CAPACITY);
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return 1;
+        }
+        fprintf(csv, "expr,len,naive_cyc,naive_mad,fused_cyc,fused_mad,speedup\n");
+    }
+
+    const unsigned lens[] = { 4, 8, 16, 32 };
+    double overhead = bench_tsc_overhead();
+    printf("TSC overhead %.1f cycles, %u samples of %u expressions\n", overhead, samples, POOL);
+    printf("%-6s %4s %12s %8s %12s %8s %8s\n", "expr", "len", "naive_cyc", "mad", "fused_cyc", "mad", "speedup");
+    int rc = 0;
+    const unsigned nlens = only_len ? 1 : sizeof(lens) / sizeof(lens[0]);
+    for (unsigned li = 0; li < nlens; ++li) {
+        unsigned len = only_len ? only_len : lens[li];
+        fill_pool(len);
+        for (int k = 0; k < EXPR_COUNT; ++k) {
+            expr_kind_t kind = (expr_kind_t)k;
+            // Сверка: оба способа дают одно и то же без ошибок
+            naive_errors = 0;
+            run_naive(kind);
+            unsigned fused_errors = run_fused(kind);
+            for (unsigned p = 0; p < POOL; ++p) {
+                if (memcmp(&naive_out[p].v, &fused_out[p].v, sizeof(bignum_t)) != 0) fused_errors++;
+            }
+            if (naive_errors || fused_errors) {
+                fprintf(stderr, "Mismatch in %s at len %u (%u naive errors, %u fused mismatches)\n",
+                        expr_names[k], len, naive_errors, fused_errors);
+                rc = 1;
+                continue;
+            }
+            bench_stats_t naive = measure([kind] { run_naive(kind); }, samples, overhead);
+            bench_stats_t fused = measure([kind] { run_fused(kind); }, samples, overhead);
+            double speedup = fused.median > 0 ? naive.median / fused.median : 0.0;
+            printf("%-6s %4u %12.1f %8.1f %12.1f %8.1f %7.2fx\n", expr_names[k], len, naive.median, naive.mad,
+                   fused.median, fused.mad, speedup);
+            if (csv) {
+                fprintf(csv, "%s,%u,%.2f,%.2f,%.2f,%.2f,%.3f\n", expr_names[k], len, naive.median, naive.mad,
+                        fused.median, fused.mad, speedup);
+            }
+        }
+    }
+
+    if (csv && fclose(csv) != 0) rc = 1;
+    return rc;
+}
@@ -0,0 +1,383 @@
+/**
+ * @file    bench_bignum_sub_fixed.c
+ * @brief   Ядра фиксированной ширины (bignum_sub_fixed.h) и простых полей (bignum_sub_field.h) против bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Для каждой ширины (--bits, по умолчанию 256, 512, 1024, 2048) на одном
+ *   пуле полноширинных пар a >= b измеряются:
+ *
+ *   - `bignum_sub` — переменная длина: проверки, bignum_cmp, цикл,
+ *                    очистка хвоста и нормализация (len = N/64);
+ *   - `sub`        — bnN_sub: проход заёма и вычитание, контракт bignum_sub;
+ *   - `sub_mod`    — bnN_sub_mod: вычитание по модулю 2^N с заёмом;
+ *   - `borrow`     — bnN_borrow: только заём, без записи.
+ *
+ *   Вторая таблица — r = (a - b) mod p для полей P-256, P-384, 2^255 - 19
+ *   и secp256k1 на пуле приведённых пар (примерно половина с a < b):
+ *
+ *   - `bignum_sub` — a - b, а при a < b ещё два вызова: p - (b - a);
+ *   - `generic`    — общий путь на C: вычитание с заёмом и добавление
+ *                    `p & маска`, модуль читается из памяти;
+ *   - `field`      — bn_<поле>_sub: модуль вшит в код.
+ *
+ *   --table=fixed|field оставляет одну таблицу. Перед замером результаты
+ *   сверяются с bignum_sub по всему пулу. Печатаются медиана и MAD тактов
+ *   TSC на вызов и ускорение относительно bignum_sub; с --csv=FILE строки
+ *   дублируются в CSV (в колонке bits у полей — имя поля). Все ядра, как и
+ *   bignum_sub, вызываются в цикле пула напрямую.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *   - rev 1.1 (17.10.2026): Таблица ядер простых полей (bignum_sub_field.h).
+ *   - rev 1.2 (17.10.2026): _GNU_SOURCE для bench_timing.h; ядра ширин вызываются напрямую.
+ *   - rev 1.3 (17.10.2026): Ядра полей вызываются напрямую.
+ *
+ * # Сборка и запуск (release)
+ *  make bench-fixed
+ *  bin/bench_bignum_sub_fixed --bits=256 --samples=501 --csv=benchmarks/reports/current_fixed.csv
+ *  bin/bench_bignum_sub_fixed --table=field
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bignum_sub_fixed.h"
+#include "bignum_sub_field.h"
+#include "bench_timing.h"
+
+#define POOL 64
+#define DEFAULT_SAMPLES 201
+#define KERNEL_COUNT 4
+
+/** Пул: одни и те же значения как bignum_t и как массивы слов. */
+static bignum_t big_a[POOL], big_b[POOL], big_r[POOL];
+static uint64_t fix_a[POOL][BN2048_WORDS], fix_b[POOL][BN2048_WORDS], fix_r[POOL][BN2048_WORDS];
+static volatile uint64_t sink;
+
+/**
+ * Один проход пула ядром k для ширины bits; возвращает число ошибок/заёмов
+ * (должно быть 0). Ядра вызываются напрямую, как и bignum_sub: косвенный
+ * вызов — один на проход, одинаковый для всех ядер.
+ */
+#define WIDTH_OPS(bits)                                                                          \
+    static unsigned run_##bits(int k) {                                                          \
+        unsigned errors = 0;                                                                     \
+        uint64_t acc = 0;                                                                        \
+        switch (k) {                                                                             \
+        case 0:                                                                                  \
+            for (unsigned p = 0; p < POOL; ++p)                                                  \
+                errors += bignum_sub(&big_r[p], &big_a[p], &big_b[p]) != BIGNUM_SUB_SUCCESS;     \
+            break;                                                                               \
+        case 1:                                                                                  \
+            for (unsigned p = 0; p < POOL; ++p)                                                  \
+                errors += bn##bits##_sub((bn##bits##_t *)fix_r[p], (const bn##bits##_t *)fix_a[p], \
+                                         (const bn##bits##_t *)fix_b[p]) != BIGNUM_SUB_SUCCESS;  \
+            break;                                                                               \
+        case 2:                                                                                  \
+            for (unsigned p = 0; p < POOL; ++p)                                                  \
+                errors += (unsigned)bn##bits##_sub_mod((bn##bits##_t *)fix_r[p], (const bn##bits##_t *)fix_a[p], \
+                                                       (const bn##bits##_t *)fix_b[p]);          \
+            break;                                                                               \
+        default:                                                                                 \
+            for (unsigned p = 0; p < POOL; ++p)                                                  \
+                acc += bn##bits##_borrow((const bn##bits##_t *)fix_a[p], (const bn##bits##_t *)fix_b[p]); \
+            errors += (unsigned)acc;                                                             \
+            break;                                                                               \
+        }                                                                                        \
+        sink = acc;                                                                              \
+        return errors;                                                                           \
+    }
+
+WIDTH_OPS(256)
+WIDTH_OPS(512)
+WIDTH_OPS(1024)
+WIDTH_OPS(2048)
+
+/** Ширина и проход пула её ядрами. */
+typedef struct {
+    unsigned bits;
+    size_t words;
+    unsigned (*run)(int k);
+} width_t;
+
+static const width_t widths[] = {
+    { 256, BN256_WORDS, run_256 },
+    { 512, BN512_WORDS, run_512 },
+    { 1024, BN1024_WORDS, run_1024 },
+    { 2048, BN2048_WORDS, run_2048 },
+};
+#define WIDTH_COUNT (sizeof(widths) / sizeof(widths[0]))
+
+static const char *const kernel_names[KERNEL_COUNT] = { "bignum_sub", "sub", "sub_mod", "borrow" };
+
+static uint64_t rng_state = 0x452821E638D01377ull;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void fill_pool(const width_t *w) {
+    for (unsigned p = 0; p < POOL; ++p) {
+        for (size_t i = 0; i < w->words; ++i) {
+            fix_a[p][i] = rng_next();
+            fix_b[p][i] = rng_next();
+        }
+        // Полная ширина, a > b: старшее слово b вдвое меньше
+        fix_a[p][w->words - 1] |= 1ull << 63;
+        fix_b[p][w->words - 1] = (fix_a[p][w->words - 1] >> 1) | 1;
+        bignum_sub_fixed_store(&big_a[p], fix_a[p], w->words);
+        bignum_sub_fixed_store(&big_b[p], fix_b[p], w->words);
+    }
+}
+
+/** Результаты bnN_sub и bnN_sub_mod совпадают с bignum_sub по всему пулу. */
+static unsigned verify(const width_t *w) {
+    unsigned bad = w->run(0) + w->run(1) + w->run(3);
+    for (unsigned p = 0; p < POOL; ++p) {
+        bad += memcmp(fix_r[p], big_r[p].words, w->words * sizeof(uint64_t)) != 0;
+    }
+    memset(fix_r, 0, sizeof(fix_r));
+    bad += w->run(2);
+    for (unsigned p = 0; p < POOL; ++p) {
+        bad += memcmp(fix_r[p], big_r[p].words, w->words * sizeof(uint64_t)) != 0;
+    }
+    return bad;
+}
+
+/** Медиана и MAD тактов на вызов по `samples` проходам пула. */
+static bench_stats_t measure(const width_t *w, int k, unsigned samples, double overhead, double *v, double *scratch) {
+    w->run(k);
+    for (unsigned s = 0; s < samples; ++s) {
+        uint64_t t0 = bench_tsc_start();
+        w->run(k);
+        uint64_t t1 = bench_tsc_stop();
+        v[s] = ((double)(t1 - t0) - overhead) / POOL;
+    }
+    return bench_stats_compute(v, scratch, samples);
+}
+
+/* --- Простые поля --- */
+
+#define FIELD_KERNEL_COUNT 3
+
+typedef struct field field_t;
+
+/** Поле: модуль и проход пула его ядрами. */
+struct field {
+    const char *name;
+    size_t words;
+    uint64_t p[BN384_WORDS];
+    unsigned (*run)(const field_t *f, int k);
+};
+
+static bignum_t big_p, big_d;
+
+/** Общий путь: r = a - b, затем r += p & маска; модуль — из памяти. */
+static void generic_field_sub(uint64_t *r, const uint64_t *a, const uint64_t *b, const uint64_t *p, size_t n) {
+    uint64_t borrow = 0, carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t d = a[i] - b[i];
+        uint64_t b1 = a[i] < b[i];
+        r[i] = d - borrow;
+        borrow = b1 | (d < borrow);
+    }
+    uint64_t mask = 0 - borrow;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t s = r[i] + (p[i] & mask);
+        uint64_t c1 = s < r[i];
+        r[i] = s + carry;
+        carry = c1 | (r[i] < s);
+    }
+}
+
+/**
+ * Один проход пула способом k для поля; возвращает число ошибок (должно
+ * быть 0). Как и у ширин, ядро поля вызывается напрямую.
+ */
+#define FIELD_OPS(field, type)                                                                   \
+    static unsigned run_##field(const field_t *f, int k) {                                       \
+        unsigned errors = 0;                                                                     \
+        switch (k) {                                                                             \
+        case 0:                                                                                  \
+            for (unsigned p = 0; p < POOL; ++p) {                                                \
+                if (bignum_sub(&big_r[p], &big_a[p], &big_b[p]) == BIGNUM_SUB_SUCCESS) continue; \
+                errors += bignum_sub(&big_d, &big_b[p], &big_a[p]) != BIGNUM_SUB_SUCCESS;        \
+                errors += bignum_sub(&big_r[p], &big_p, &big_d) != BIGNUM_SUB_SUCCESS;           \
+            }                                                                                    \
+            break;                                                                               \
+        case 1:                                                                                  \
+            for (unsigned p = 0; p < POOL; ++p) generic_field_sub(fix_r[p], fix_a[p], fix_b[p], f->p, f->words); \
+            break;                                                                               \
+        default:                                                                                 \
+            for (unsigned p = 0; p < POOL; ++p)                                                  \
+                bn_##field##_sub((type *)fix_r[p], (const type *)fix_a[p], (const type *)fix_b[p]); \
+            break;                                                                               \
+        }                                                                                        \
+        return errors;                                                                           \
+    }
+
+FIELD_OPS(p256, bn256_t)
+FIELD_OPS(p384, bn384_t)
+FIELD_OPS(p25519, bn256_t)
+FIELD_OPS(secp256k1, bn256_t)
+
+static const field_t fields[] = {
+    { "p256", 4, { 0xFFFFFFFFFFFFFFFFull, 0x00000000FFFFFFFFull, 0, 0xFFFFFFFF00000001ull }, run_p256 },
+    { "p384", 6, { 0x00000000FFFFFFFFull, 0xFFFFFFFF00000000ull, 0xFFFFFFFFFFFFFFFEull,
+                   0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull }, run_p384 },
+    { "p25519", 4, { 0xFFFFFFFFFFFFFFEDull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0x7FFFFFFFFFFFFFFFull },
+      run_p25519 },
+    { "secp256k1", 4, { 0xFFFFFFFEFFFFFC2Full, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull },
+      run_secp256k1 },
+};
+#define FIELD_COUNT (sizeof(fields) / sizeof(fields[0]))
+
+static const char *const field_kernel_names[FIELD_KERNEL_COUNT] = { "bignum_sub", "generic", "field" };
+
+static int field_less(const uint64_t *x, const uint64_t *p, size_t n) {
+    for (size_t i = n; i-- > 0;) {
+        if (x[i] != p[i]) return x[i] < p[i];
+    }
+    return 0;
+}
+
+static void fill_field_pool(const field_t *f) {
+    for (unsigned p = 0; p < POOL; ++p) {
+        uint64_t *x[2] = { fix_a[p], fix_b[p] };
+        for (int j = 0; j < 2; ++j) {
+            do {
+                for (size_t i = 0; i < f->words; ++i) x[j][i] = rng_next();
+                x[j][f->words - 1] >>= 1;
+            } while (!field_less(x[j], f->p, f->words));
+        }
+        bignum_sub_fixed_store(&big_a[p], fix_a[p], f->words);
+        bignum_sub_fixed_store(&big_b[p], fix_b[p], f->words);
+    }
+    bignum_sub_fixed_store(&big_p, f->p, f->words);
+}
+
+/** generic и field совпадают с bignum_sub по всему пулу. */
+static unsigned verify_field(const field_t *f) {
+    unsigned bad = f->run(f, 0);
+    for (int k = 1; k < FIELD_KERNEL_COUNT; ++k) {
+        memset(fix_r, 0, sizeof(fix_r));
+        f->run(f, k);
+        for (unsigned p = 0; p < POOL; ++p) {
+            bad += memcmp(fix_r[p], big_r[p].words, f->words * sizeof(uint64_t)) != 0;
+        }
+    }
+    return bad;
+}
+
+static bench_stats_t measure_field(const field_t *f, int k, unsigned samples, double overhead, double *v,
+                                   double *scratch) {
+    f->run(f, k);
+    for (unsigned s = 0; s < samples; ++s) {
+        uint64_t t0 = bench_tsc_start();
+        f->run(f, k);
+        uint64_t t1 = bench_tsc_stop();
+        v[s] = ((double)(t1 - t0) - overhead) / POOL;
+    }
+    return bench_stats_compute(v, scratch, samples);
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+int main(int argc, char **argv) {
+    unsigned only_bits = 0, samples = DEFAULT_SAMPLES;
+    const char *csv_path = NULL, *table = "all", *v;
+    int bad = 0;
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--bits="))) only_bits = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--samples="))) samples = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--csv="))) csv_path = v;
+        else if ((v = arg_value(argv[i], "--table="))) table = v;
+        else bad = 1;
+    }
+    int run_fixed = strcmp(table, "field") != 0, run_fields = strcmp(table, "fixed") != 0;
+    bad |= !run_fixed && !run_fields;
+    bad |= strcmp(table, "all") != 0 && strcmp(table, "fixed") != 0 && strcmp(table, "field") != 0;
+    int known = only_bits == 0;
+    for (unsigned i = 0; i < WIDTH_COUNT; ++i) known |= widths[i].bits == only_bits;
+    if (bad || !known || samples == 0) {
+        fprintf(stderr, "Usage: %s [--bits=256|512|1024|2048] [--table=all|fixed|field] [--samples=N] [--csv=FILE]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return 1;
+        }
+        fprintf(csv, "bits,kernel,cycles,mad,speedup\n");
+    }
+
+    double *samples_v = malloc(sizeof(double) * samples), *scratch = malloc(sizeof(double) * samples);
+    if (!samples_v || !scratch) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    double overhead = bench_tsc_overhead();
+    printf("TSC overhead %.1f cycles, %u samples of %u calls\n", overhead, samples, POOL);
+    printf("%5s %-10s %10s %8s %8s\n", "bits", "kernel", "cycles", "mad", "speedup");
+    int rc = 0;
+    for (unsigned wi = 0; run_fixed && wi < WIDTH_COUNT; ++wi) {
+        const width_t *w = &widths[wi];
+        if (only_bits && w->bits != only_bits) continue;
+        fill_pool(w);
+        unsigned mismatches = verify(w);
+        if (mismatches) {
+            fprintf(stderr, "Mismatch at %u bits (%u errors)\n", w->bits, mismatches);
+            rc = 1;
+            continue;
+        }
+        double base = 0.0;
+        for (int k = 0; k < KERNEL_COUNT; ++k) {
+            bench_stats_t st = measure(w, k, samples, overhead, samples_v, scratch);
+            if (k == 0) base = st.median;
+            double speedup = st.median > 0 ? base / st.median : 0.0;
+            printf("%5u %-10s %10.1f %8.1f %7.2fx\n", w->bits, kernel_names[k], st.median, st.mad, speedup);
+            if (csv) fprintf(csv, "%u,%s,%.2f,%.2f,%.3f\n", w->bits, kernel_names[k], st.median, st.mad, speedup);
+        }
+    }
+
+    if (run_fields) printf("\n%-9s %-10s %10s %8s %8s\n", "field", "kernel", "cycles", "mad", "speedup");
+    for (unsigned fi = 0; run_fields && fi < FIELD_COUNT; ++fi) {
+        const field_t *f = &fields[fi];
+        fill_field_pool(f);
+        unsigned mismatches = verify_field(f);
+        if (mismatches) {
+            fprintf(stderr, "Mismatch in field %s (%u errors)\n", f->name, mismatches);
+            rc = 1;
+            continue;
+        }
+        double base = 0.0;
+        for (int k = 0; k < FIELD_KERNEL_COUNT; ++k) {
+            bench_stats_t st = measure_field(f, k, samples, overhead, samples_v, scratch);
+            if (k == 0) base = st.median;
+            double speedup = st.median > 0 ? base / st.median : 0.0;
+            printf("%-9s %-10s %10.1f %8.1f %7.2fx\n", f->name, field_kernel_names[k], st.median, st.mad, speedup);
+            if (csv) fprintf(csv, "%s,%s,%.2f,%.2f,%.3f\n", f->name, field_kernel_names[k], st.median, st.mad, speedup);
+        }
+    }
+
+    free(samples_v);
+    free(scratch);
+    if (csv && fclose(csv) != 0) rc = 1;
+    return rc;
+}
@@ -7,14 +7,45 @@
  *
  * @details
  *   Для чистоты измерений все случайные данные генерируются заранее
- *   в основном потоке и передаются в рабочие потоки. Каждый поток
- *   выполняет свой набор вызовов bignum_sub, используя
- *   общий пул предварительно сгенерированных данных.
+ *   в основном потоке и передаются в рабочие потоки.
+ *
+ *   Бенчмарк строит кривую масштабирования: число потоков перебирается
+ *   от 1 до числа доступных CPU (маска affinity процесса) или до
+ *   `--max-threads=N`; `--threads=N` задаёт одну точку. Потоки явно
+ *   закрепляются за CPU: сначала по одному на физическое ядро, затем
+ *   SMT-соседи (bench_topology.h). Каждый поток получает свою долю пула
+ *   входных данных (непрерывный срез) и собственный массив результатов,
+ *   выделенный уже после закрепления (first touch), и вызывает ядро
+ *   напрямую, без копирования структур.
+ *
+ *   Для каждой точки печатаются пропускная способность каждого потока,
+ *   суммарная пропускная способность (все вызовы / время от общего старта
+ *   до завершения последнего потока) и эффективность масштабирования
+ *   aggregate(N) / (N * aggregate(1)).
+ *
+ *   Распределение операндов выбирается ключом `--gen=NAME` (bench_inputs.h);
+ *   по умолчанию `random` — исходный init_random_bignum.
+ *
+ *   Хвостовая латентность под конкуренцией: каждый `--sample=N`-й вызов
+ *   (по умолчанию 64; 0 — без замеров) измеряется отдельно через TSC и
+ *   пишется в HDR-гистограмму потока (bench_hdr.h) по корзине длины a
+ *   (1-4, 5-8, 9-16, 17-32). После join гистограммы сливаются, и для
+ *   каждой точки печатаются p50/p90/p99/p99.9/max по корзинам длины и по
+ *   всем вызовам; в строке потока — его собственный p99. Сериализующие
+ *   замеры немного снижают пропускную способность — при малых N это
+ *   видно в Mcalls/s.
  *
  * @history
  *   - rev 1.0 (12.08.2025): Первоначальная версия.
  *   - rev 1.1 (13.08.2025): Реализована предварительная генерация данных
  *                           в main для исключения rand() из потоков.
+ *   - rev 1.2 (17.10.2026): Выбор генератора входных данных (--gen).
+ *   - rev 1.3 (17.10.2026): Перебор числа потоков 1..nproc вместо THREAD_COUNT,
+ *                           SMT-aware закрепление, приватные результаты,
+ *                           доля пула на поток, отчёт по масштабированию.
+ *                           ITER_PER_THREAD уменьшен до 20M на точку перебора.
+ *   - rev 1.4 (17.10.2026): Сэмплирование латентности вызовов (--sample) в
+ *                           HDR-гистограммы потоков, перцентили по корзинам длины.
  *
  * # Сборка
  * gcc -g -O2 -I include -no-pie -fno-omit-frame-pointer -pthread \
@@ -24,76 +55,249 @@
  * # Запуск perf
  * /usr/local/bin/perf record -F 9999 -o benchmarks/reports/report_bench_bignum_sub_mt -g -- \
  *   bin/bench_bignum_sub_mt
+ *
+ * # Только 1..8 потоков на ядрах 0-7
+ *  taskset --cpu-list 0-7 bin/bench_bignum_sub_mt --max-threads=8
  */
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <time.h>
 #include <pthread.h>
+#include <sched.h>
 #include <bignum.h>
 #include "bignum_sub.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
+#include "bench_topology.h"
+#include "bench_hdr.h"
 
 // --- Локальные определения для компиляции ---
 #define BIGNUM_CAPACITY 32
 #define BIGNUM_BITS (BIGNUM_CAPACITY * 64)
 
+// Вызовов на поток в каждой точке перебора
 #ifndef ITER_PER_THREAD
-#  define ITER_PER_THREAD (20000000u * 20)
+#  define ITER_PER_THREAD 20000000u
 #endif
 
-#ifndef THREAD_COUNT
-#  define THREAD_COUNT 4
-#endif
+// Верхняя граница числа потоков
+#define MAX_THREADS 1024
 
 #define PREGEN_DATA_COUNT 8192
 #define MAX_SHIFT (BIGNUM_BITS - 1)
 
+// Корзины длины a для гистограмм латентности
+#define LEN_BUCKETS 4
+static const char *const len_bucket_names[LEN_BUCKETS] = { "1-4", "5-8", "9-16", "17-32" };
+
+static unsigned len_bucket(size_t len) {
+    return len <= 4 ? 0 : len <= 8 ? 1 : len <= 16 ? 2 : 3;
+}
+
 // Структура для передачи данных в поток
 typedef struct {
     unsigned thread_id;
     unsigned iters;
-    const bignum_t* a; // Указатель на общий пул исходных чисел
-    const bignum_t* b; // Указатель на общий пул исходных чисел
-    unsigned data_count;     // Размер пула
+    int      cpu;             // CPU, за которым закреплён поток
+    const bignum_t* a;        // Начало доли потока в общем пуле
+    const bignum_t* b;        // Начало доли потока в общем пуле
+    unsigned data_count;      // Размер доли
+    unsigned sample;          // Замерять каждый sample-й вызов (0 — не замерять)
+    uint64_t tsc_overhead;    // Накладные расходы пустого замера, такты
+    bench_hdr_t *hist;        // LEN_BUCKETS гистограмм потока (освобождает main)
+    pthread_barrier_t *start; // Общий старт всех потоков точки
+    uint64_t t_start;         // Время начала (нс)
+    uint64_t t_end;           // Время окончания (нс)
+    uint64_t checksum;        // Держит результаты живыми
+    int      failed;
 } thread_arg_t;
 
-/** Инициализация случайного bignum_t */
-static void init_random_bignum(bignum_t *num) {
-    int used = (rand() % BIGNUM_CAPACITY) + 1;
-    num->len = used;
-    for (int i = 0; i < used; ++i) {
-        num->words[i] = ((uint64_t)rand() << 32) | rand();
+/** Функция, исполняемая каждым потоком */
+static void* thread_func(void *arg) {
+    thread_arg_t *t = arg;
+
+    // Приватный массив результатов и гистограммы: выделяются и заполняются уже на своём CPU
+    bignum_t *res = calloc(t->data_count, sizeof(bignum_t));
+    t->hist = calloc(LEN_BUCKETS, sizeof(bench_hdr_t));
+    if (!res || !t->hist) {
+        free(res);
+        t->failed = 1;
+        pthread_barrier_wait(t->start);
+        return (void*)1;
     }
-    for (int i = used; i < BIGNUM_CAPACITY; ++i) {
-        num->words[i] = 0;
+
+    pthread_barrier_wait(t->start);
+    uint64_t checksum = 0;
+    unsigned data_idx = 0;
+    unsigned countdown = t->sample;
+    t->t_start = bench_now_ns();
+    for (unsigned i = 0; i < t->iters; ++i) {
+        bignum_sub_status_t st;
+        if (countdown && --countdown == 0) {
+            countdown = t->sample;
+            uint64_t t0 = bench_tsc_start();
+            st = bignum_sub(&res[data_idx], &t->a[data_idx], &t->b[data_idx]);
+            uint64_t ticks = bench_tsc_stop() - t0;
+            ticks = ticks > t->tsc_overhead ? ticks - t->tsc_overhead : 0;
+            bench_hdr_record(&t->hist[len_bucket(t->a[data_idx].len)], ticks);
+        } else {
+            st = bignum_sub(&res[data_idx], &t->a[data_idx], &t->b[data_idx]);
+        }
+        checksum += (uint64_t)(int64_t)st + res[data_idx].words[0];
+        if (++data_idx == t->data_count) data_idx = 0;
     }
+    t->t_end = bench_now_ns();
+    t->checksum = checksum;
+
+    free(res);
+    return NULL;
 }
 
-/** Функция, исполняемая каждым потоком */
-static void* thread_func(void *arg) {
-    const thread_arg_t *t = arg;
+/**
+ * Одна точка кривой: n потоков на первых n CPU из порядка закрепления.
+ * @return суммарная пропускная способность (вызовов/с); < 0 — ошибка.
+ */
+static double run_point(unsigned n, const bench_cpu_t *cpus, const bignum_t *a,
+                        const bignum_t *b, unsigned iters, unsigned sample,
+                        uint64_t tsc_overhead, double base) {
+    static pthread_t threads[MAX_THREADS];
+    static thread_arg_t args[MAX_THREADS];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, n);
 
-    for (unsigned i = 0; i < t->iters; ++i) {
-        // Используем общий пул данных, циклически
-        // Смещаем индекс на thread_id, чтобы потоки реже работали с одними и теми же данными
-        unsigned data_idx = (i + t->thread_id) % t->data_count;
-        bignum_t res_dst = {0};
-        bignum_t a_dst = t->a[data_idx];
-        bignum_t b_dst = t->b[data_idx];
+    for (unsigned i = 0; i < n; ++i) {
+        // Доля пула: непрерывный срез [i*count/n, (i+1)*count/n)
+        unsigned lo = (unsigned)((uint64_t)PREGEN_DATA_COUNT * i / n);
+        unsigned hi = (unsigned)((uint64_t)PREGEN_DATA_COUNT * (i + 1) / n);
+        memset(&args[i], 0, sizeof(args[i]));
+        args[i].thread_id  = i;
+        args[i].iters      = iters;
+        args[i].cpu        = cpus[i].cpu;
+        args[i].a          = a + lo;
+        args[i].b          = b + lo;
+        args[i].data_count = hi > lo ? hi - lo : 1;
+        args[i].sample     = sample;
+        args[i].tsc_overhead = tsc_overhead;
+        args[i].start      = &start;
 
-        bignum_sub(&res_dst, &a_dst, &b_dst);
+        pthread_attr_t attr;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[i].cpu, &set);
+        pthread_attr_init(&attr);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        int rc = pthread_create(&threads[i], &attr, thread_func, &args[i]);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
 
-        if (a_dst.len == 0xDEADBEEF) {
-            return (void*)1;
+    int failed = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        void *res;
+        pthread_join(threads[i], &res);
+        if (res != NULL || args[i].failed) {
+            fprintf(stderr, "Error in thread %u\n", i);
+            failed = 1;
         }
     }
-    return NULL;
+    pthread_barrier_destroy(&start);
+    if (failed) {
+        for (unsigned i = 0; i < n; ++i) free(args[i].hist);
+        return -1.0;
+    }
+
+    uint64_t t0 = args[0].t_start, t1 = args[0].t_end, checksum = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        if (args[i].t_start < t0) t0 = args[i].t_start;
+        if (args[i].t_end > t1) t1 = args[i].t_end;
+        checksum += args[i].checksum;
+    }
+    BENCH_KEEP(checksum);
+
+    double aggregate = (double)iters * n / ((double)(t1 - t0) * 1e-9);
+    double eff = base > 0 ? aggregate / (n * base) : 1.0;
+    printf("threads=%-4u aggregate %9.2f Mcalls/s  efficiency %6.1f%%\n",
+           n, aggregate * 1e-6, eff * 100.0);
+    // Слияние гистограмм: по корзинам длины (все потоки) и по потоку (все длины)
+    static bench_hdr_t merged[LEN_BUCKETS + 1], per_thread_hist;
+    for (unsigned k = 0; k <= LEN_BUCKETS; ++k) bench_hdr_reset(&merged[k]);
+    for (unsigned i = 0; i < n; ++i) {
+        double per_thread = (double)iters / ((double)(args[i].t_end - args[i].t_start) * 1e-9);
+        bench_hdr_reset(&per_thread_hist);
+        for (unsigned k = 0; k < LEN_BUCKETS; ++k) {
+            bench_hdr_merge(&merged[k], &args[i].hist[k]);
+            bench_hdr_merge(&per_thread_hist, &args[i].hist[k]);
+        }
+        bench_hdr_merge(&merged[LEN_BUCKETS], &per_thread_hist);
+        printf("    thread %-4u cpu %-4d (pkg %d core %d smt %d) share %5u  %9.2f Mcalls/s",
+               i, cpus[i].cpu, cpus[i].package, cpus[i].core, cpus[i].smt,
+               args[i].data_count, per_thread * 1e-6);
+        if (sample) printf("  p99 %6llu cyc", (unsigned long long)bench_hdr_quantile(&per_thread_hist, 0.99));
+        printf("\n");
+        free(args[i].hist);
+    }
+
+    if (sample) {
+        static const double q[] = { 0.50, 0.90, 0.99, 0.999 };
+        printf("    latency, TSC cycles (1 of every %u calls):\n", sample);
+        printf("    %-6s %10s %8s %8s %8s %8s %8s\n", "len_a", "samples", "p50", "p90", "p99", "p99.9", "max");
+        for (unsigned k = 0; k <= LEN_BUCKETS; ++k) {
+            const bench_hdr_t *h = &merged[k];
+            if (h->count == 0) continue;
+            printf("    %-6s %10llu", k < LEN_BUCKETS ? len_bucket_names[k] : "all",
+                   (unsigned long long)h->count);
+            for (unsigned j = 0; j < sizeof(q) / sizeof(q[0]); ++j) {
+                printf(" %8llu", (unsigned long long)bench_hdr_quantile(h, q[j]));
+            }
+            printf(" %8llu\n", (unsigned long long)h->max);
+        }
+    }
+    return aggregate;
 }
 
-int main(void) {
+int main(int argc, char **argv) {
+    const bench_gen_t *gen = bench_gen_find("random");
+    bench_gen_params_t gen_params = BENCH_GEN_PARAMS_DEFAULT;
+    unsigned min_threads = 1, max_threads = 0, iters = ITER_PER_THREAD, sample = 64;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--gen=", 6) == 0 && bench_gen_find(argv[i] + 6)) {
+            gen = bench_gen_find(argv[i] + 6);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            min_threads = max_threads = (unsigned)strtoul(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "--max-threads=", 14) == 0) {
+            max_threads = (unsigned)strtoul(argv[i] + 14, NULL, 10);
+        } else if (strncmp(argv[i], "--iters=", 8) == 0) {
+            iters = (unsigned)strtoul(argv[i] + 8, NULL, 10);
+        } else if (strncmp(argv[i], "--sample=", 9) == 0) {
+            sample = (unsigned)strtoul(argv[i] + 9, NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--gen=NAME] [--threads=N | --max-threads=N] [--iters=N]"
+                            " [--sample=N]\n"
+                            "Generators: ", argv[0]);
+            bench_gen_list(stderr);
+            return 1;
+        }
+    }
+
+    static bench_cpu_t cpus[MAX_THREADS];
+    int ncpu = bench_cpu_order(cpus, MAX_THREADS);
+    if (ncpu <= 0) {
+        fprintf(stderr, "Failed to read CPU affinity\n");
+        return 1;
+    }
+    if (max_threads == 0 || max_threads > (unsigned)ncpu) max_threads = (unsigned)ncpu;
+    if (min_threads == 0 || min_threads > max_threads) min_threads = max_threads;
+
     // --- Фаза 1: Предварительная генерация данных в основном потоке ---
-    printf("Pregenerating %u data sets for %u threads...\n", PREGEN_DATA_COUNT, THREAD_COUNT);
+    printf("Pregenerating %u data sets (generator: %s); %d CPUs, %d physical cores...\n",
+           PREGEN_DATA_COUNT, gen->name, ncpu, bench_cpu_physical_cores(cpus, ncpu));
 
     bignum_t* a = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
     bignum_t* b = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
@@ -104,37 +308,26 @@ int main(void) {
         return 1;
     }
 
-    srand((unsigned)time(NULL));
+    uint64_t rng = (uint64_t)time(NULL) | 1;
     for (unsigned i = 0; i < PREGEN_DATA_COUNT; ++i) {
-        init_random_bignum(&a[i]);
-        init_random_bignum(&b[i]);
+        bench_gen_pair(gen, &a[i], &b[i], &gen_params, &rng);
     }
 
-    // --- Фаза 2: Запуск потоков и профилирование ---
-    printf("Starting benchmark with %u threads, %u iterations each...\n", THREAD_COUNT, ITER_PER_THREAD);
-    pthread_t threads[THREAD_COUNT];
-    thread_arg_t args[THREAD_COUNT];
+    uint64_t tsc_overhead = (uint64_t)bench_tsc_overhead();
 
-    for (unsigned i = 0; i < THREAD_COUNT; ++i) {
-        args[i].thread_id  = i;
-        args[i].iters      = ITER_PER_THREAD;
-        args[i].a          = a;
-        args[i].b          = b;
-        args[i].data_count = PREGEN_DATA_COUNT;
-        if (pthread_create(&threads[i], NULL, thread_func, &args[i]) != 0) {
-            perror("pthread_create");
-            free(a);
-            free(b);
-            return 1;
-        }
-    }
-
-    for (unsigned i = 0; i < THREAD_COUNT; ++i) {
-        void *res;
-        pthread_join(threads[i], &res);
-        if (res != NULL) {
-            fprintf(stderr, "Error in thread %u\n", i);
+    // --- Фаза 2: Перебор числа потоков ---
+    printf("Starting benchmark with %u..%u threads, %u iterations each...\n",
+           min_threads, max_threads, iters);
+    double base = 0.0;
+    int rc = 0;
+    for (unsigned n = min_threads; n <= max_threads; ++n) {
+        double aggregate = run_point(n, cpus, a, b, iters, sample, tsc_overhead, base);
+        if (aggregate < 0) {
+            rc = 1;
+            break;
         }
+        // База эффективности — один поток (или первая точка при --threads)
+        if (n == min_threads) base = aggregate / n;
     }
     
     printf("Benchmark finished.\n");
@@ -143,5 +336,5 @@ int main(void) {
     free(a);
     free(b);
 
-    return 0;
+    return rc;
 }
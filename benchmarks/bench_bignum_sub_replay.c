@@ -0,0 +1,294 @@
+/**
+ * @file    bench_bignum_sub_replay.c
+ * @brief   Replay-бенчмарк: прогон записанной трассы вызовов через ядра bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Читает трассу, записанную хуком захвата (bignum_sub_trace.h), и
+ *   прогоняет её через каждое ядро таблицы kernels (bignum_sub и эталонные
+ *   C-ядра из bench_ref_kernels.h) в исходном порядке вызовов.
+ *
+ *   Если трасса записана только с формами (BIGNUM_SUB_TRACE_SHAPES_ONLY),
+ *   операнды синтезируются по длинам и коду возврата: для успешных вызовов
+ *   a >= b, для BIGNUM_SUB_ERROR_NEGATIVE_RESULT — a < b. NULL-указатели и
+ *   совпадение результата с операндом воспроизводятся по флагам записи.
+ *
+ *   Для каждого ядра сначала выполняется проверочный проход:
+ *   - `status-diff` — вызовы, где код возврата отличается от записанного;
+ *   - `result-diff` — успешные вызовы, где результат отличается от bignum_sub.
+ *   Затем --samples проходов по всей трассе, медиана тактов на вызов.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *   - rev 1.1 (17.10.2026): Автозапуск трассировки отключён (bignum_sub_trace_no_autostart).
+ *
+ * # Запись трассы в приложении и прогон
+ *  gcc app.c -Wl,--wrap=bignum_sub -Lbuild -lbignum_sub_instr ... -pthread
+ *  BIGNUM_SUB_TRACE=/tmp/app.trace ./app
+ *  taskset 0x1 bin/bench_bignum_sub_replay --trace=/tmp/app.trace --csv=benchmarks/reports/current_replay.csv
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bignum_sub_trace.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
+#include "bench_ref_kernels.h"
+
+/** Трассу читает сам: BIGNUM_SUB_TRACE в окружении не должен перезаписать её. */
+const int bignum_sub_trace_no_autostart = 1;
+
+#define DEFAULT_SAMPLES   11
+#define DEFAULT_MAX_CALLS (1u << 20)
+// Кольцо буферов результата (степень двойки)
+#define RES_RING 64
+
+typedef bignum_sub_status_t (*bench_kernel_fn)(bignum_t *, const bignum_t *, const bignum_t *);
+
+typedef struct {
+    const char     *name;
+    bench_kernel_fn fn;
+} bench_kernel_t;
+
+static const bench_kernel_t kernels[] = {
+    { "bignum_sub", bignum_sub },
+    BENCH_REF_KERNELS
+};
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+typedef struct {
+    const char *trace_path;
+    const char *kernels;
+    const char *csv_path;
+    unsigned    samples;
+    size_t      max_calls;
+} options_t;
+
+/** Трасса в памяти: операнды и указатели аргументов каждого вызова. */
+typedef struct {
+    size_t    n;
+    int       shapes;       // операнды синтезированы по формам
+    bignum_t *a;
+    bignum_t *b;
+    bignum_t *res;          // кольцо RES_RING результатов
+    bignum_t **pr;
+    const bignum_t **pa;
+    const bignum_t **pb;
+    int8_t   *status;       // записанный код возврата
+} trace_t;
+
+/** Синтез операндов по формам записи. */
+static void synth_operands(const bignum_sub_trace_rec_t *rec, bignum_t *a, bignum_t *b,
+                           uint64_t *rng) {
+    unsigned la = rec->len_a > BIGNUM_CAPACITY ? BIGNUM_CAPACITY : rec->len_a;
+    unsigned lb = rec->len_b > BIGNUM_CAPACITY ? BIGNUM_CAPACITY : rec->len_b;
+    if (rec->status == BIGNUM_SUB_ERROR_NEGATIVE_RESULT && la >= 1 && la == lb) {
+        bench_fill_ordered(b, a, lb, la, rng);
+    } else if (rec->status == BIGNUM_SUB_SUCCESS && la >= 1 && lb <= la) {
+        bench_fill_ordered(a, b, la, lb, rng);
+    } else {
+        bench_fill_random(a, la, rng);
+        bench_fill_random(b, lb, rng);
+    }
+    // Длины вне ёмкости сохраняются как записаны (ошибка ёмкости воспроизводится)
+    a->len = rec->len_a;
+    b->len = rec->len_b;
+}
+
+static int load_trace(const options_t *o, trace_t *t) {
+    bignum_sub_trace_reader_t rd;
+    bignum_sub_trace_rec_t rec;
+    if (bignum_sub_trace_open(&rd, o->trace_path) != 0) {
+        fprintf(stderr, "Cannot read trace %s (missing file or incompatible format)\n", o->trace_path);
+        return -1;
+    }
+    size_t cap = o->max_calls;
+    memset(t, 0, sizeof(*t));
+    t->shapes = (rd.hdr.flags & BIGNUM_SUB_TRACE_SHAPES_ONLY) != 0;
+    t->a = malloc(sizeof(bignum_t) * cap);
+    t->b = malloc(sizeof(bignum_t) * cap);
+    t->res = aligned_alloc(64, sizeof(bignum_t) * RES_RING);
+    t->pr = malloc(sizeof(*t->pr) * cap);
+    t->pa = malloc(sizeof(*t->pa) * cap);
+    t->pb = malloc(sizeof(*t->pb) * cap);
+    t->status = malloc(cap);
+    if (!t->a || !t->b || !t->res || !t->pr || !t->pa || !t->pb || !t->status) {
+        perror("Failed to allocate memory for trace");
+        bignum_sub_trace_close(&rd);
+        return -1;
+    }
+    memset(t->res, 0, sizeof(bignum_t) * RES_RING);
+
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    int rc = 0;
+    while (t->n < cap && (rc = bignum_sub_trace_next(&rd, &rec, &t->a[t->n], &t->b[t->n])) == 1) {
+        size_t i = t->n++;
+        if (!(rec.flags & BIGNUM_SUB_TRACE_REC_OPERANDS)) synth_operands(&rec, &t->a[i], &t->b[i], &rng);
+        t->pa[i] = (rec.flags & BIGNUM_SUB_TRACE_REC_NULL_A) ? NULL : &t->a[i];
+        t->pb[i] = (rec.flags & BIGNUM_SUB_TRACE_REC_NULL_B) ? NULL : &t->b[i];
+        t->pr[i] = &t->res[i & (RES_RING - 1)];
+        // Перекрытие воспроизводится записью результата поверх операнда
+        if (rec.flags & BIGNUM_SUB_TRACE_REC_ALIAS_A) t->pr[i] = &t->a[i];
+        else if (rec.flags & BIGNUM_SUB_TRACE_REC_ALIAS_B) t->pr[i] = &t->b[i];
+        if (rec.flags & BIGNUM_SUB_TRACE_REC_NULL_R) t->pr[i] = NULL;
+        t->status[i] = rec.status;
+    }
+    bignum_sub_trace_close(&rd);
+    if (rc < 0) fprintf(stderr, "Trace %s is truncated after %zu calls\n", o->trace_path, t->n);
+    if (t->n == 0) {
+        fprintf(stderr, "Trace %s is empty or corrupt\n", o->trace_path);
+        return -1;
+    }
+    return 0;
+}
+
+static void free_trace(trace_t *t) {
+    free(t->status);
+    free(t->pb);
+    free(t->pa);
+    free(t->pr);
+    free(t->res);
+    free(t->b);
+    free(t->a);
+}
+
+/** Сводка трассы: коды возврата и средние длины. */
+static void print_summary(const trace_t *t) {
+    size_t by_status[5] = { 0 };
+    double sum_a = 0, sum_b = 0;
+    for (size_t i = 0; i < t->n; ++i) {
+        int s = -t->status[i];
+        if (s >= 0 && s < 5) by_status[s]++;
+        sum_a += t->pa[i] ? (double)t->pa[i]->len : 0;
+        sum_b += t->pb[i] ? (double)t->pb[i]->len : 0;
+    }
+    printf("Trace: %zu calls (%s), mean len_a=%.2f len_b=%.2f\n", t->n,
+           t->shapes ? "shapes, synthesized operands" : "operands", sum_a / t->n, sum_b / t->n);
+    printf("Status: ok=%zu null=%zu negative=%zu capacity=%zu overlap=%zu\n", by_status[0],
+           by_status[1], by_status[2], by_status[3], by_status[4]);
+}
+
+/** Проверочный проход: расхождения кода возврата с трассой и результата с bignum_sub. */
+static void verify_kernel(const bench_kernel_t *k, const trace_t *t, size_t *status_diff,
+                          size_t *result_diff) {
+    bignum_t want, got;
+    *status_diff = *result_diff = 0;
+    for (size_t i = 0; i < t->n; ++i) {
+        // Результат пишется в локальные буферы, а не в операнды трассы
+        bignum_t *rw = t->pr[i] ? &want : NULL, *rg = t->pr[i] ? &got : NULL;
+        const bignum_t *pa = t->pa[i], *pb = t->pb[i];
+        if (t->pr[i] && t->pr[i] == pa) rw = rg = (bignum_t *)pa;
+        else if (t->pr[i] && t->pr[i] == pb) rw = rg = (bignum_t *)pb;
+        bignum_sub_status_t sw = bignum_sub(rw, pa, pb);
+        bignum_sub_status_t sg = k->fn(rg, pa, pb);
+        if (sg != t->status[i]) (*status_diff)++;
+        if (sw == BIGNUM_SUB_SUCCESS && sg == sw && rw == &want &&
+            memcmp(&want, &got, sizeof(want)) != 0) {
+            (*result_diff)++;
+        }
+    }
+}
+
+/** Один проход по трассе; такты TSC на вызов. */
+static double measure_pass(bench_kernel_fn fn, const trace_t *t, double overhead) {
+    int acc = 0;
+    uint64_t t0 = bench_tsc_start();
+    for (size_t i = 0; i < t->n; ++i) acc += fn(t->pr[i], t->pa[i], t->pb[i]);
+    uint64_t t1 = bench_tsc_stop();
+    BENCH_KEEP(acc);
+    double ticks = (double)(t1 - t0) - overhead;
+    return (ticks > 0 ? ticks : 0) / (double)t->n;
+}
+
+/** Есть ли имя в списке через запятую; "all" — все. */
+static int name_selected(const char *list, const char *name) {
+    if (strcmp(list, "all") == 0) return 1;
+    size_t n = strlen(name);
+    for (const char *p = list; p && *p; p = strchr(p, ',') ? strchr(p, ',') + 1 : NULL) {
+        if (strncmp(p, name, n) == 0 && (p[n] == ',' || p[n] == '\0')) return 1;
+    }
+    return 0;
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .kernels = "all", .samples = DEFAULT_SAMPLES, .max_calls = DEFAULT_MAX_CALLS };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--trace="))) o->trace_path = v;
+        else if ((v = arg_value(argv[i], "--kernel="))) o->kernels = v;
+        else if ((v = arg_value(argv[i], "--csv="))) o->csv_path = v;
+        else if ((v = arg_value(argv[i], "--samples="))) o->samples = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--max-calls="))) o->max_calls = strtoull(v, NULL, 10);
+        else return -1;
+    }
+    return (!o->trace_path || o->samples == 0 || o->max_calls == 0) ? -1 : 0;
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    trace_t t;
+    if (parse_options(argc, argv, &opt) != 0) {
+        fprintf(stderr, "Usage: %s --trace=FILE [--kernel=all|NAME[,NAME...]] [--samples=N]\n"
+                        "          [--max-calls=N] [--csv=FILE]\n", argv[0]);
+        return 1;
+    }
+    if (load_trace(&opt, &t) != 0) return 1;
+    print_summary(&t);
+
+    double *samples = malloc(sizeof(double) * opt.samples);
+    double *scratch = malloc(sizeof(double) * opt.samples);
+    if (!samples || !scratch) {
+        perror("Failed to allocate memory for benchmark data");
+        return 1;
+    }
+    FILE *csv = NULL;
+    if (opt.csv_path) {
+        csv = fopen(opt.csv_path, "w");
+        if (!csv) {
+            perror(opt.csv_path);
+            return 1;
+        }
+        fprintf(csv, "kernel,calls,median_cycles,mad_cycles,min_cycles,ns_per_call,status_diff,result_diff\n");
+    }
+
+    double overhead = bench_tsc_overhead();
+    double ghz = bench_tsc_ghz(100);
+    printf("TSC: %.3f GHz, timing overhead %.1f cycles; samples=%u\n", ghz, overhead, opt.samples);
+    printf("%-14s %10s %8s %10s %9s %12s %12s\n", "kernel", "cyc/call", "MAD", "min", "ns/call",
+           "status-diff", "result-diff");
+
+    for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+        if (!name_selected(opt.kernels, kernels[k].name)) continue;
+        size_t status_diff, result_diff;
+        verify_kernel(&kernels[k], &t, &status_diff, &result_diff);
+        measure_pass(kernels[k].fn, &t, overhead);   // прогрев
+        for (unsigned s = 0; s < opt.samples; ++s) samples[s] = measure_pass(kernels[k].fn, &t, overhead);
+        bench_stats_t st = bench_stats_compute(samples, scratch, opt.samples);
+        printf("%-14s %10.2f %8.2f %10.2f %9.2f %12zu %12zu\n", kernels[k].name, st.median, st.mad,
+               st.min, st.median / ghz, status_diff, result_diff);
+        if (csv) {
+            fprintf(csv, "%s,%zu,%.3f,%.3f,%.3f,%.3f,%zu,%zu\n", kernels[k].name, t.n, st.median,
+                    st.mad, st.min, st.median / ghz, status_diff, result_diff);
+        }
+    }
+
+    printf("Benchmark finished.\n");
+
+    if (csv) fclose(csv);
+    free(scratch);
+    free(samples);
+    free_trace(&t);
+    return 0;
+}
@@ -0,0 +1,398 @@
+/**
+ * @file    bench_bignum_sub_shm.c
+ * @brief   Межпроцессный сервис (bignum_sub_shm.h): латентность туда-обратно и суммарная пропускная способность.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Для каждого числа клиентских процессов (1, 2, 4, ... до --max-clients)
+ *   запускаются (fork) клиенты, каждый делает --calls вычитаний по своей
+ *   доле заранее сгенерированного пула, скопированной в арену соединения
+ *   до замера. Режимы:
+ *
+ *   - `direct` — процесс сам вызывает bignum_sub (то, что заменяет демон);
+ *   - `rtt`    — одна заявка в полёте: чистая латентность туда-обратно
+ *                через общую память (bignum_sub_shm_call());
+ *   - `stream` — до --window заявок в полёте на клиента: пропускная
+ *                способность при пакетной обработке.
+ *
+ *   По умолчанию демон встроен: bignum_sub_shm_server_start() в этом
+ *   процессе, рабочие потоки (--workers) закреплены за последними CPU из
+ *   порядка bench_topology.h, клиенты — за первыми (по кругу, если CPU не
+ *   хватает). С --socket=PATH клиенты подключаются к уже запущенному
+ *   bin/bignum-sub-shmd, а его счётчики (пакет, засыпания) не печатаются.
+ *
+ *   Печатаются суммарная пропускная способность всех клиентов и
+ *   латентность в тактах TSC (p50/p99/p99.9/max; для direct — каждый
+ *   64-й вызов, для сервиса — каждая заявка от постановки до того, как
+ *   клиент увидел завершение). Результаты клиентов возвращаются через
+ *   общее анонимное отображение.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *
+ * # Сборка и запуск (release)
+ *  make bench-shm
+ *  bin/bench_bignum_sub_shm --workers=2 --max-clients=8 --window=32 --csv=benchmarks/reports/current_shm.csv
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bignum_sub_shm.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
+#include "bench_topology.h"
+#include "bench_hdr.h"
+
+#define MAX_CLIENTS 256
+#define PREGEN_DATA_COUNT 8192
+#define MAX_WINDOW BIGNUM_SUB_SHM_RING
+#define DIRECT_SAMPLE 64
+// Опросов перед сном на futex при ожидании заявки
+#define WAIT_SPIN 256
+
+#define DEFAULT_CALLS  200000u
+#define DEFAULT_WINDOW 32
+
+typedef enum { MODE_DIRECT, MODE_RTT, MODE_STREAM, MODE_COUNT } bench_mode_t;
+static const char *const mode_names[MODE_COUNT] = { "direct", "rtt", "stream" };
+
+typedef struct {
+    const char *socket;
+    unsigned    workers;
+    unsigned    max_clients;
+    unsigned    window;
+    unsigned    batch;
+    unsigned    calls;
+    const char *gen;
+    const char *csv_path;
+} options_t;
+
+/** Результат клиента в общем отображении. */
+typedef struct {
+    bench_hdr_t hist;
+    uint64_t    t_start;
+    uint64_t    t_end;
+    uint64_t    checksum;
+    int         failed;
+} client_result_t;
+
+typedef struct {
+    bench_mode_t       mode;
+    const char        *path;
+    unsigned           calls;
+    unsigned           window;
+    int                cpu;
+    const bignum_t    *a;
+    const bignum_t    *b;
+    unsigned           data_count;
+    pthread_barrier_t *start;
+    client_result_t   *out;
+} client_arg_t;
+
+static void run_direct(const client_arg_t *p, bignum_t *res) {
+    client_result_t *out = p->out;
+    unsigned idx = 0, countdown = DIRECT_SAMPLE;
+    for (unsigned i = 0; i < p->calls; ++i) {
+        bignum_sub_status_t st;
+        if (--countdown == 0) {
+            countdown = DIRECT_SAMPLE;
+            uint64_t t0 = __rdtsc();
+            st = bignum_sub(&res[idx], &p->a[idx], &p->b[idx]);
+            bench_hdr_record(&out->hist, __rdtsc() - t0);
+        } else {
+            st = bignum_sub(&res[idx], &p->a[idx], &p->b[idx]);
+        }
+        out->checksum += (uint64_t)(int64_t)st + res[idx].words[0];
+        if (++idx == p->data_count) idx = 0;
+    }
+}
+
+/** Окно из window заявок (rtt — одна): дождаться самой старой, записать латентность, поставить следующую. */
+static void run_shm(const client_arg_t *p, bignum_sub_shm_client_t *c, bignum_t *a, bignum_t *b, bignum_t *res) {
+    client_result_t *out = p->out;
+    unsigned window = p->mode == MODE_RTT ? 1 : p->window;
+    int64_t ticket[MAX_WINDOW];
+    uint64_t stamp[MAX_WINDOW];
+    unsigned idx = 0;
+    for (unsigned i = 0; i < p->calls + window; ++i) {
+        unsigned k = i % window;
+        if (i >= window) {
+            int st = bignum_sub_shm_wait(c, ticket[k], WAIT_SPIN);
+            bench_hdr_record(&out->hist, __rdtsc() - stamp[k]);
+            if (st == BIGNUM_SUB_SHM_DISCONNECTED) {
+                out->failed = 1;
+                return;
+            }
+            out->checksum += (uint64_t)(int64_t)st + res[k].words[0];
+        }
+        if (i >= p->calls) continue;
+        stamp[k] = __rdtsc();
+        ticket[k] = bignum_sub_shm_submit(c, &res[k], &a[idx], &b[idx]);
+        if (ticket[k] < 0) {
+            out->failed = 1;
+            return;
+        }
+        if (++idx == p->data_count) idx = 0;
+    }
+}
+
+/** Тело клиентского процесса: подключение и подготовка арены до барьера, замер после. */
+static void client_main(const client_arg_t *p) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(p->cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+
+    bignum_sub_shm_client_t *c = NULL;
+    bignum_t *a = NULL, *b = NULL, *res = NULL;
+    if (p->mode == MODE_DIRECT) {
+        res = calloc(p->data_count, sizeof(bignum_t));
+        if (!res) p->out->failed = 1;
+    } else {
+        // Арена: операнды доли пула, затем результаты окна
+        c = bignum_sub_shm_connect(p->path, 2 * (size_t)p->data_count + p->window);
+        if (c) {
+            a = bignum_sub_shm_arena(c, NULL);
+            b = a + p->data_count;
+            res = b + p->data_count;
+            memcpy(a, p->a, sizeof(bignum_t) * p->data_count);
+            memcpy(b, p->b, sizeof(bignum_t) * p->data_count);
+        } else {
+            perror(p->path);
+            p->out->failed = 1;
+        }
+    }
+
+    pthread_barrier_wait(p->start);
+    if (!p->out->failed) {
+        p->out->t_start = bench_now_ns();
+        if (p->mode == MODE_DIRECT) run_direct(p, res);
+        else run_shm(p, c, a, b, res);
+        p->out->t_end = bench_now_ns();
+    }
+    if (c) bignum_sub_shm_disconnect(c);
+    else free(res);
+}
+
+typedef struct {
+    double   mcalls;
+    uint64_t p50, p99, p999, max;
+    double   avg_batch;
+    uint64_t sleeps;
+} point_t;
+
+static int run_point(bench_mode_t mode, unsigned n, const options_t *o, const bench_cpu_t *cpus,
+                     int ncpu, const bignum_t *a, const bignum_t *b, point_t *out) {
+    bignum_sub_shm_server_t *srv = NULL;
+    char path[64];
+    const char *socket = o->socket;
+    int worker_cpus[BIGNUM_SUB_SHM_MAX_WORKERS];
+    // Встроенному демону — последние CPU, клиентам — остальные (или все, если CPU мало)
+    int client_cpus = !o->socket && ncpu > (int)o->workers ? ncpu - (int)o->workers : ncpu;
+    if (mode != MODE_DIRECT && !o->socket) {
+        snprintf(path, sizeof(path), "/tmp/bench_bignum_sub_shm_%d.sock", (int)getpid());
+        socket = path;
+        for (unsigned w = 0; w < o->workers; ++w) worker_cpus[w] = cpus[ncpu - 1 - (int)(w % (unsigned)ncpu)].cpu;
+        bignum_sub_shm_server_config_t cfg = { .path = path, .workers = o->workers, .cpus = worker_cpus,
+                                               .batch = o->batch, .spin = 0 };
+        srv = bignum_sub_shm_server_start(&cfg);
+        if (!srv) {
+            perror("bignum_sub_shm_server_start");
+            return -1;
+        }
+    }
+
+    // Барьер и результаты клиентов — в общей памяти, видимой после fork
+    size_t shared_size = sizeof(pthread_barrier_t) + sizeof(client_result_t) * n;
+    void *shared = mmap(NULL, shared_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        if (srv) bignum_sub_shm_server_stop(srv);
+        return -1;
+    }
+    pthread_barrier_t *start = shared;
+    client_result_t *results = (client_result_t *)((char *)shared + sizeof(pthread_barrier_t));
+    pthread_barrierattr_t battr;
+    pthread_barrierattr_init(&battr);
+    pthread_barrierattr_setpshared(&battr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(start, &battr, n);
+    pthread_barrierattr_destroy(&battr);
+
+    static pid_t pids[MAX_CLIENTS];
+    fflush(stdout);
+    for (unsigned i = 0; i < n; ++i) {
+        unsigned lo = (unsigned)((uint64_t)PREGEN_DATA_COUNT * i / n);
+        unsigned hi = (unsigned)((uint64_t)PREGEN_DATA_COUNT * (i + 1) / n);
+        client_arg_t arg = { .mode = mode, .path = socket, .calls = o->calls, .window = o->window,
+                             .cpu = cpus[i % (unsigned)client_cpus].cpu, .a = a + lo, .b = b + lo,
+                             .data_count = hi > lo ? hi - lo : 1, .start = start, .out = &results[i] };
+        bench_hdr_reset(&results[i].hist);
+        pids[i] = fork();
+        if (pids[i] < 0) {
+            perror("fork");
+            exit(1);
+        }
+        if (pids[i] == 0) {
+            client_main(&arg);
+            _exit(0);
+        }
+    }
+
+    int failed = 0;
+    uint64_t checksum = 0;
+    static bench_hdr_t merged;
+    bench_hdr_reset(&merged);
+    for (unsigned i = 0; i < n; ++i) {
+        int wst = 0;
+        if (waitpid(pids[i], &wst, 0) != pids[i] || !WIFEXITED(wst) || WEXITSTATUS(wst) != 0) failed = 1;
+        failed |= results[i].failed;
+        bench_hdr_merge(&merged, &results[i].hist);
+        checksum += results[i].checksum;
+    }
+    BENCH_KEEP(checksum);
+
+    memset(out, 0, sizeof(*out));
+    if (srv) {
+        bignum_sub_shm_server_counters_t cnt;
+        bignum_sub_shm_server_counters(srv, &cnt);
+        bignum_sub_shm_server_stop(srv);
+        out->avg_batch = cnt.batches ? (double)cnt.calls / (double)cnt.batches : 0.0;
+        out->sleeps = cnt.sleeps;
+    }
+    uint64_t t0 = results[0].t_start, t1 = results[0].t_end;
+    for (unsigned i = 0; i < n; ++i) {
+        if (results[i].t_start < t0) t0 = results[i].t_start;
+        if (results[i].t_end > t1) t1 = results[i].t_end;
+    }
+    if (!failed) {
+        out->mcalls = (double)o->calls * n / ((double)(t1 - t0) * 1e-3);
+        out->p50 = bench_hdr_quantile(&merged, 0.50);
+        out->p99 = bench_hdr_quantile(&merged, 0.99);
+        out->p999 = bench_hdr_quantile(&merged, 0.999);
+        out->max = merged.max;
+    }
+    pthread_barrier_destroy(start);
+    munmap(shared, shared_size);
+    return failed ? -1 : 0;
+}
+
+/** 1, 2, 4, ... и последней точкой --max-clients. */
+static unsigned next_clients(unsigned n, unsigned max) {
+    if (n == max) return max + 1;
+    return n * 2 < max ? n * 2 : max;
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .workers = 1, .window = DEFAULT_WINDOW, .calls = DEFAULT_CALLS, .gen = "random" };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--socket="))) o->socket = v;
+        else if ((v = arg_value(argv[i], "--workers="))) o->workers = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--max-clients="))) o->max_clients = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--window="))) o->window = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--batch="))) o->batch = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--calls="))) o->calls = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--gen="))) o->gen = v;
+        else if ((v = arg_value(argv[i], "--csv="))) o->csv_path = v;
+        else return -1;
+    }
+    if (o->workers < 1 || o->workers > BIGNUM_SUB_SHM_MAX_WORKERS || o->window < 1 ||
+        o->window > MAX_WINDOW || o->batch > BIGNUM_SUB_SHM_MAX_BATCH || o->calls == 0 ||
+        !bench_gen_find(o->gen)) {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    if (parse_options(argc, argv, &opt) != 0) {
+        fprintf(stderr, "Usage: %s [--socket=PATH] [--workers=N] [--max-clients=N] [--window=N] [--batch=N]\n"
+                        "          [--calls=N] [--gen=NAME] [--csv=FILE]\n"
+                        "Generators: ", argv[0]);
+        bench_gen_list(stderr);
+        return 1;
+    }
+
+    static bench_cpu_t cpus[MAX_CLIENTS];
+    int ncpu = bench_cpu_order(cpus, MAX_CLIENTS);
+    if (ncpu <= 0) {
+        fprintf(stderr, "Failed to read CPU affinity\n");
+        return 1;
+    }
+    if (opt.max_clients == 0) {
+        opt.max_clients = !opt.socket && ncpu > (int)opt.workers ? (unsigned)ncpu - opt.workers : (unsigned)ncpu;
+    }
+    if (opt.max_clients > MAX_CLIENTS) opt.max_clients = MAX_CLIENTS;
+
+    const bench_gen_t *gen = bench_gen_find(opt.gen);
+    bench_gen_params_t gen_params = BENCH_GEN_PARAMS_DEFAULT;
+    bignum_t *a = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
+    bignum_t *b = malloc(sizeof(bignum_t) * PREGEN_DATA_COUNT);
+    if (!a || !b) {
+        perror("Failed to allocate memory for test data");
+        return 1;
+    }
+    uint64_t rng = (uint64_t)time(NULL) | 1;
+    for (unsigned i = 0; i < PREGEN_DATA_COUNT; ++i) bench_gen_pair(gen, &a[i], &b[i], &gen_params, &rng);
+
+    FILE *csv = NULL;
+    if (opt.csv_path) {
+        csv = fopen(opt.csv_path, "w");
+        if (!csv) {
+            perror(opt.csv_path);
+            return 1;
+        }
+        fprintf(csv, "mode,clients,workers,window,calls,mcalls_per_s,p50_cyc,p99_cyc,p999_cyc,max_cyc,"
+                     "avg_batch,worker_sleeps\n");
+    }
+
+    printf("Generator %s, %d CPUs, daemon %s, window %u, %u calls per client\n", gen->name, ncpu,
+           opt.socket ? opt.socket : "embedded", opt.window, opt.calls);
+    printf("%-7s %8s %10s %8s %8s %8s %10s %9s %10s\n", "mode", "clients", "Mcalls/s",
+           "p50", "p99", "p99.9", "max", "batch", "sleeps");
+    int rc = 0;
+    for (unsigned n = 1; n <= opt.max_clients && rc == 0; n = next_clients(n, opt.max_clients)) {
+        for (int m = 0; m < MODE_COUNT; ++m) {
+            point_t pt;
+            if (run_point((bench_mode_t)m, n, &opt, cpus, ncpu, a, b, &pt) != 0) {
+                fprintf(stderr, "Error in %s with %u clients\n", mode_names[m], n);
+                rc = 1;
+                break;
+            }
+            printf("%-7s %8u %10.2f %8llu %8llu %8llu %10llu %9.1f %10llu\n", mode_names[m], n,
+                   pt.mcalls, (unsigned long long)pt.p50, (unsigned long long)pt.p99,
+                   (unsigned long long)pt.p999, (unsigned long long)pt.max, pt.avg_batch,
+                   (unsigned long long)pt.sleeps);
+            if (csv) {
+                fprintf(csv, "%s,%u,%u,%u,%u,%.3f,%llu,%llu,%llu,%llu,%.2f,%llu\n", mode_names[m], n,
+                        opt.workers, m == MODE_RTT ? 1u : opt.window, opt.calls, pt.mcalls,
+                        (unsigned long long)pt.p50, (unsigned long long)pt.p99, (unsigned long long)pt.p999,
+                        (unsigned long long)pt.max, pt.avg_batch, (unsigned long long)pt.sleeps);
+            }
+        }
+    }
+
+    if (csv && fclose(csv) != 0) rc = 1;
+    free(a);
+    free(b);
+    return rc;
+}
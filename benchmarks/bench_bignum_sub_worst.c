@@ -0,0 +1,304 @@
+/**
+ * @file    bench_bignum_sub_worst.c
+ * @brief   Поиск входов с наихудшей латентностью bignum_sub мутациями с отбором по тактам.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Случайные равномерные входы почти не попадают на медленные пути ядра:
+ *   длинные цепочки заимствования, полный просмотр при нормализации,
+ *   позднее расхождение в bignum_cmp. Здесь пространство входов
+ *   обыскивается эволюционно (схема (μ+λ)):
+ *
+ *   1. Популяция из --population пар засевается всеми генераторами
+ *      bench_inputs.h на случайных длинах.
+ *   2. В каждом из --generations поколений из случайных родителей
+ *      мутациями строится столько же потомков: инверсия бита, слово
+ *      0 / 2^64-1, смена длины, копирование старших слов a в b (общий
+ *      префикс), "шторм" заимствования (нули в младших словах a), скрещивание
+ *      a и b разных родителей.
+ *   3. Приспособленность — медиана тактов TSC по --reps одиночным вызовам
+ *      (за вычетом накладных расходов замера); родители перемеряются в
+ *      каждом поколении. В популяции остаются --population самых медленных
+ *      пар.
+ *
+ *   По умолчанию (--status=ok) рассматриваются только успешные вызовы;
+ *   --status=any допускает и ошибочные. В конце лучшие кандидаты
+ *   перемеряются с 4*--reps повторами, печатаются --top самых медленных
+ *   с диагностикой (длина цепочки заимствования, общий старший префикс,
+ *   длина результата) и сохраняются как корпус в формате трассы
+ *   bignum_sub_trace.h (--corpus) — его прогоняет bench_bignum_sub_replay.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *   - rev 1.1 (17.10.2026): Автозапуск трассировки отключён (bignum_sub_trace_no_autostart).
+ *
+ * # Запуск
+ *  make bench-worst
+ *  taskset 0x1 bin/bench_bignum_sub_worst --generations=300 --corpus=benchmarks/corpus/worst.trace
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bignum_sub_trace.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
+
+/** Корпус пишется через bignum_sub_trace_start(): автозапуск занял бы запись. */
+const int bignum_sub_trace_no_autostart = 1;
+
+#define MAX_REPS 1024
+
+typedef struct {
+    unsigned    population;
+    unsigned    generations;
+    unsigned    reps;
+    unsigned    top;
+    int         any_status;
+    uint64_t    seed;
+    const char *corpus_path;
+    const char *csv_path;
+} options_t;
+
+/** Кандидат: пара операндов и измеренная латентность. */
+typedef struct {
+    bignum_t a;
+    bignum_t b;
+    double   cycles;
+    int      status;
+} cand_t;
+
+static double g_overhead;
+static double g_samples[4 * MAX_REPS];
+static double g_scratch[4 * MAX_REPS];
+
+/** Медиана тактов одиночного вызова по `reps` замерам (после прогревочного вызова). */
+static double measure(cand_t *c, unsigned reps) {
+    bignum_t r;
+    int acc = bignum_sub(&r, &c->a, &c->b);
+    for (unsigned i = 0; i < reps; ++i) {
+        uint64_t t0 = bench_tsc_start();
+        acc += bignum_sub(&r, &c->a, &c->b);
+        uint64_t t1 = bench_tsc_stop();
+        double ticks = (double)(t1 - t0) - g_overhead;
+        g_samples[i] = ticks > 0 ? ticks : 0;
+    }
+    BENCH_KEEP(acc);
+    return bench_stats_compute(g_samples, g_scratch, reps).median;
+}
+
+/** Старшее слово ненулевое (операнды нормализованы). */
+static void normalize(bignum_t *x) {
+    if (x->len == 0) x->len = 1;
+    if (x->words[x->len - 1] == 0) x->words[x->len - 1] = 1;
+}
+
+static void mutate(cand_t *c, const cand_t *other, uint64_t *rng) {
+    bignum_t *x = (bench_rng_next(rng) & 1) ? &c->a : &c->b;
+    unsigned w = (unsigned)(bench_rng_next(rng) % x->len);
+    switch (bench_rng_next(rng) % 6) {
+    case 0:   // инверсия бита
+        x->words[w] ^= 1ull << (bench_rng_next(rng) & 63);
+        break;
+    case 1:   // крайние значения слова
+        x->words[w] = (bench_rng_next(rng) & 1) ? UINT64_MAX : 0;
+        break;
+    case 2: { // смена длины, новые слова случайны
+        unsigned len = bench_rng_len(rng, 1, BIGNUM_CAPACITY);
+        for (unsigned i = (unsigned)x->len; i < len; ++i) x->words[i] = bench_rng_next(rng);
+        for (unsigned i = len; i < BIGNUM_CAPACITY; ++i) x->words[i] = 0;
+        x->len = len;
+        break;
+    }
+    case 3: { // общий старший префикс: b получает длину и старшие слова a
+        unsigned k = bench_rng_len(rng, 1, (unsigned)c->a.len);
+        memset(c->b.words, 0, sizeof(c->b.words));
+        for (unsigned i = 0; i < (unsigned)c->a.len; ++i) {
+            c->b.words[i] = i >= c->a.len - k ? c->a.words[i] : bench_rng_next(rng);
+        }
+        c->b.len = c->a.len;
+        break;
+    }
+    case 4: { // шторм заимствования: нули в младших словах a, единица в b
+        unsigned k = bench_rng_len(rng, 1, (unsigned)c->a.len);
+        for (unsigned i = 0; i + 1 < k; ++i) c->a.words[i] = 0;
+        c->b.words[0] |= 1;
+        break;
+    }
+    default:  // скрещивание
+        if (bench_rng_next(rng) & 1) c->a = other->a;
+        else c->b = other->b;
+        break;
+    }
+    normalize(&c->a);
+    normalize(&c->b);
+}
+
+/** Наибольшая длина цепочки слов, через которые прошло заимствование. */
+static unsigned borrow_chain(const bignum_t *a, const bignum_t *b) {
+    unsigned best = 0, run = 0, borrow = 0;
+    for (size_t i = 0; i < a->len; ++i) {
+        uint64_t bw = i < b->len ? b->words[i] : 0;
+        unsigned next = a->words[i] < bw || (a->words[i] == bw && borrow);
+        run = next ? run + 1 : 0;
+        if (run > best) best = run;
+        borrow = next;
+    }
+    return best;
+}
+
+/** Число совпадающих старших слов при равных длинах. */
+static unsigned common_prefix(const bignum_t *a, const bignum_t *b) {
+    unsigned n = 0;
+    if (a->len != b->len) return 0;
+    for (size_t i = a->len; i-- > 0 && a->words[i] == b->words[i];) n++;
+    return n;
+}
+
+static int cand_cmp_desc(const void *x, const void *y) {
+    const cand_t *p = x, *q = y;
+    return (p->cycles < q->cycles) - (p->cycles > q->cycles);
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .population = 32, .generations = 300, .reps = 15, .top = 16,
+                      .seed = 0x9E3779B97F4A7C15ull };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--population="))) o->population = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--generations="))) o->generations = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--reps="))) o->reps = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--top="))) o->top = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--seed="))) o->seed = strtoull(v, NULL, 0) | 1;
+        else if ((v = arg_value(argv[i], "--corpus="))) o->corpus_path = v;
+        else if ((v = arg_value(argv[i], "--csv="))) o->csv_path = v;
+        else if ((v = arg_value(argv[i], "--status="))) {
+            if (strcmp(v, "ok") == 0) o->any_status = 0;
+            else if (strcmp(v, "any") == 0) o->any_status = 1;
+            else return -1;
+        }
+        else return -1;
+    }
+    if (o->population < 2 || o->reps == 0 || o->reps > MAX_REPS) return -1;
+    if (o->top > o->population) o->top = o->population;
+    return 0;
+}
+
+/** Сохраняет лучших кандидатов как трассу (формат bignum_sub_trace.h). */
+static int save_corpus(const char *path, const cand_t *c, unsigned n) {
+    bignum_t r;
+    if (bignum_sub_trace_start(path, 0) != 0) {
+        perror(path);
+        return -1;
+    }
+    for (unsigned i = 0; i < n; ++i) {
+        bignum_sub_trace_hook(&r, &c[i].a, &c[i].b, bignum_sub(&r, &c[i].a, &c[i].b));
+    }
+    return bignum_sub_trace_stop();
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    if (parse_options(argc, argv, &opt) != 0) {
+        fprintf(stderr, "Usage: %s [--population=N] [--generations=N] [--reps=N] [--top=N]\n"
+                        "          [--status=ok|any] [--seed=N] [--corpus=FILE] [--csv=FILE]\n", argv[0]);
+        return 1;
+    }
+
+    // Популяция и потомки в одном массиве: [0, P) — родители, [P, 2P) — потомки
+    const unsigned P = opt.population;
+    cand_t *pool = malloc(sizeof(cand_t) * 2 * P);
+    if (!pool) {
+        perror("Failed to allocate memory for population");
+        return 1;
+    }
+    uint64_t rng = opt.seed;
+    const bench_gen_params_t params = BENCH_GEN_PARAMS_DEFAULT;
+    g_overhead = bench_tsc_overhead();
+
+    for (unsigned i = 0; i < P; ++i) {
+        const bench_gen_t *g = &bench_generators[i % BENCH_GEN_COUNT];
+        cand_t *c = &pool[i];
+        do {
+            bench_gen_pair(g, &c->a, &c->b, &params, &rng);
+            c->status = bignum_sub(&(bignum_t){ 0 }, &c->a, &c->b);
+        } while (!opt.any_status && c->status != BIGNUM_SUB_SUCCESS);
+        c->cycles = measure(c, opt.reps);
+    }
+    qsort(pool, P, sizeof(cand_t), cand_cmp_desc);
+    printf("Initial worst: %.1f cycles (len_a=%zu len_b=%zu)\n", pool[0].cycles, pool[0].a.len,
+           pool[0].b.len);
+
+    unsigned long rejected = 0;
+    for (unsigned gen = 0; gen < opt.generations; ++gen) {
+        // Родители перемеряются, иначе случайно завышенный замер живёт вечно
+        for (unsigned i = 0; i < P; ++i) pool[i].cycles = measure(&pool[i], opt.reps);
+        for (unsigned i = 0; i < P; ++i) {
+            cand_t *child = &pool[P + i];
+            *child = pool[bench_rng_next(&rng) % P];
+            mutate(child, &pool[bench_rng_next(&rng) % P], &rng);
+            child->status = bignum_sub(&(bignum_t){ 0 }, &child->a, &child->b);
+            if (!opt.any_status && child->status != BIGNUM_SUB_SUCCESS) {
+                child->cycles = -1;   // отбраковывается отбором
+                rejected++;
+                continue;
+            }
+            child->cycles = measure(child, opt.reps);
+        }
+        qsort(pool, 2 * P, sizeof(cand_t), cand_cmp_desc);
+        if ((gen + 1) % 50 == 0 || gen + 1 == opt.generations) {
+            printf("Generation %u: worst %.1f cycles, median of population %.1f\n", gen + 1,
+                   pool[0].cycles, pool[P / 2].cycles);
+        }
+    }
+    printf("Rejected mutants (status filter): %lu\n", rejected);
+
+    // Повторный замер: отсекает кандидатов, попавших наверх из-за шума
+    for (unsigned i = 0; i < P; ++i) pool[i].cycles = measure(&pool[i], 4 * opt.reps);
+    qsort(pool, P, sizeof(cand_t), cand_cmp_desc);
+
+    FILE *csv = NULL;
+    if (opt.csv_path) {
+        csv = fopen(opt.csv_path, "w");
+        if (!csv) {
+            perror(opt.csv_path);
+            return 1;
+        }
+        fprintf(csv, "rank,len_a,len_b,status,median_cycles,borrow_chain,common_prefix,result_len\n");
+    }
+    printf("%4s %5s %5s %6s %10s %8s %8s %8s\n", "rank", "len_a", "len_b", "status", "cyc/call",
+           "borrow", "prefix", "res_len");
+    for (unsigned i = 0; i < opt.top; ++i) {
+        const cand_t *c = &pool[i];
+        bignum_t r = { 0 };
+        bignum_sub(&r, &c->a, &c->b);
+        size_t res_len = c->status == BIGNUM_SUB_SUCCESS ? r.len : 0;
+        unsigned chain = borrow_chain(&c->a, &c->b), prefix = common_prefix(&c->a, &c->b);
+        printf("%4u %5zu %5zu %6d %10.2f %8u %8u %8zu\n", i + 1, c->a.len, c->b.len, c->status,
+               c->cycles, chain, prefix, res_len);
+        if (csv) {
+            fprintf(csv, "%u,%zu,%zu,%d,%.3f,%u,%u,%zu\n", i + 1, c->a.len, c->b.len, c->status,
+                    c->cycles, chain, prefix, res_len);
+        }
+    }
+
+    int rc = 0;
+    if (csv) fclose(csv);
+    if (opt.corpus_path) {
+        if (save_corpus(opt.corpus_path, pool, opt.top) != 0) rc = 1;
+        else printf("Corpus of %u cases saved to %s\n", opt.top, opt.corpus_path);
+    }
+    free(pool);
+    return rc;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file    bench_bignum_sub_ws.c
+ * @brief   Перебор рабочего набора (L1 → L2 → L3 → DRAM) и roofline-отчёт для bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   PREGEN_DATA_COUNT в bench_bignum_sub.c фиксирует рабочий набор (~6 МБ),
+ *   поэтому по нему нельзя отличить работу из кэша от работы из памяти.
+ *   Здесь размер пула операндов перебирается удвоением от --min-kb до
+ *   --max-mb (по умолчанию 4 КБ .. 4 ГБ, но не больше половины свободной
+ *   памяти). Для каждого размера:
+ *
+ *   - ядро bignum_sub проходит пул последовательно (a[i], b[i] → res[i]),
+ *     время берётся по TSC (bench_timing.h), медиана по --samples сэмплам;
+ *   - тот же объём памяти прогоняется эталонным потоковым циклом
+ *     c[i] = a[i] - b[i] по uint64_t (два потока чтения, один записи —
+ *     тот же профиль трафика), это "крыша" пропускной способности памяти
+ *     на данном размере.
+ *
+ *   Трафик одного вызова считается как 3 * sizeof(bignum_t): результат
+ *   очищается целиком (256 байт), а при --len=32 (по умолчанию) операнды
+ *   читаются полностью. Печатаются байты/такт и ГБ/с для ядра и для
+ *   эталона, их отношение и ASCII-график; --csv пишет те же данные.
+ *
+ *   Пакетных (batch) ядер в этом дереве нет; кроме bignum_sub, перебираются
+ *   эталонные C-ядра из bench_ref_kernels.h (--kernel выбирает одно).
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *   - rev 1.1 (17.10.2026): Эталонные C-ядра в таблице ядер (--kernel).
+ *   - rev 1.2 (17.10.2026): Неизвестное имя в --kernel отвергается.
+ *
+ * # Сборка и запуск (release)
+ *  make bench-ws
+ *  taskset 0x1 bin/bench_bignum_sub_ws --min-kb=4 --max-mb=1024 --csv=benchmarks/reports/current_ws.csv
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <bignum.h>
+#include "bignum_sub.h"
+#include "bench_timing.h"
+#include "bench_inputs.h"
+#include "bench_ref_kernels.h"
+
+#define DEFAULT_SAMPLES 5
+// Минимум вызовов в одном сэмпле: малые пулы проходятся многократно
+#define MIN_CALLS_PER_SAMPLE (1u << 20)
+#define BAR_WIDTH 40
+
+typedef bignum_sub_status_t (*bench_kernel_fn)(bignum_t *, const bignum_t *, const bignum_t *);
+
+typedef struct {
+    const char     *name;
+    bench_kernel_fn fn;
+} bench_kernel_t;
+
+static const bench_kernel_t kernels[] = {
+    { "bignum_sub", bignum_sub },
+    BENCH_REF_KERNELS
+};
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+typedef struct {
+    size_t      min_bytes;
+    size_t      max_bytes;
+    unsigned    len;
+    unsigned    samples;
+    const char *csv_path;
+    const char *kernel;    // NULL — все ядра
+} options_t;
+
+/** Проход ядра по пулу `reps` раз; такты TSC на вызов. */
+static double measure_kernel(bench_kernel_fn fn, bignum_t *res, const bignum_t *a,
+                             const bignum_t *b, size_t n, size_t reps) {
+    int acc = 0;
+    uint64_t t0 = bench_tsc_start();
+    for (size_t r = 0; r < reps; ++r) {
+        for (size_t i = 0; i < n; ++i) acc += fn(&res[i], &a[i], &b[i]);
+    }
+    uint64_t t1 = bench_tsc_stop();
+    BENCH_KEEP(acc);
+    return (double)(t1 - t0) / ((double)n * reps);
+}
+
+/** Эталонный потоковый цикл с тем же объёмом: такты TSC на "вызов" (bignum_t). */
+static double measure_stream(uint64_t *c, const uint64_t *a, const uint64_t *b, size_t n,
+                             size_t reps) {
+    size_t words = n * (sizeof(bignum_t) / sizeof(uint64_t));
+    uint64_t t0 = bench_tsc_start();
+    for (size_t r = 0; r < reps; ++r) {
+        for (size_t i = 0; i < words; ++i) c[i] = a[i] - b[i];
+        BENCH_COMPILER_BARRIER();
+    }
+    uint64_t t1 = bench_tsc_stop();
+    return (double)(t1 - t0) / ((double)n * reps);
+}
+
+static void print_bar(double value, double max) {
+    int w = max > 0 ? (int)(value / max * BAR_WIDTH + 0.5) : 0;
+    putchar('|');
+    for (int i = 0; i < BAR_WIDTH; ++i) putchar(i < w ? '#' : ' ');
+    putchar('|');
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .min_bytes = 4u << 10, .max_bytes = (size_t)4 << 30,
+                      .len = BIGNUM_CAPACITY, .samples = DEFAULT_SAMPLES };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--min-kb="))) o->min_bytes = (size_t)strtoull(v, NULL, 10) << 10;
+        else if ((v = arg_value(argv[i], "--max-mb="))) o->max_bytes = (size_t)strtoull(v, NULL, 10) << 20;
+        else if ((v = arg_value(argv[i], "--len="))) o->len = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--samples="))) o->samples = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--csv="))) o->csv_path = v;
+        else if ((v = arg_value(argv[i], "--kernel="))) o->kernel = v;
+        else return -1;
+    }
+    if (o->samples == 0 || o->min_bytes == 0 || o->min_bytes > o->max_bytes) {
+        return -1;
+    }
+    // Неизвестное имя ядра — ошибка, а не пустой отчёт
+    for (size_t k = 0; o->kernel && k < KERNEL_COUNT; ++k) {
+        if (strcmp(o->kernel, kernels[k].name) == 0) return 0;
+    }
+    return o->kernel ? -1 : 0;
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    if (parse_options(argc, argv, &opt) != 0 || opt.len < 1 || opt.len > BIGNUM_CAPACITY) {
+        fprintf(stderr, "Usage: %s [--min-kb=N] [--max-mb=N] [--len=N] [--samples=N] [--csv=FILE]\n"
+                        "          [--kernel=NAME]\n",
+                argv[0]);
+        return 1;
+    }
+
+    // Не больше половины свободной памяти: a, b, res и буферы эталона
+    long pages = sysconf(_SC_AVPHYS_PAGES), page = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page > 0 && opt.max_bytes > (size_t)pages * (size_t)page / 2) {
+        opt.max_bytes = (size_t)pages * (size_t)page / 2;
+        printf("Limiting working set to %zu MB (half of available memory)\n", opt.max_bytes >> 20);
+    }
+
+    const size_t triple = 3 * sizeof(bignum_t);
+    size_t max_n = opt.max_bytes / triple;
+    bignum_t *a = malloc(sizeof(bignum_t) * max_n);
+    bignum_t *b = malloc(sizeof(bignum_t) * max_n);
+    bignum_t *res = calloc(max_n, sizeof(bignum_t));
+    double *samples = malloc(sizeof(double) * opt.samples);
+    double *scratch = malloc(sizeof(double) * opt.samples);
+    if (!a || !b || !res || !samples || !scratch) {
+        perror("Failed to allocate memory for benchmark data");
+        return 1;
+    }
+
+    printf("Pregenerating %zu data sets (len=%u, %zu MB)...\n", max_n, opt.len,
+           (max_n * triple) >> 20);
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < max_n; ++i) {
+        bench_fill_ordered(&a[i], &b[i], opt.len, opt.len, &rng);
+    }
+
+    FILE *csv = NULL;
+    if (opt.csv_path) {
+        csv = fopen(opt.csv_path, "w");
+        if (!csv) {
+            perror(opt.csv_path);
+            return 1;
+        }
+        fprintf(csv, "kernel,working_set_bytes,calls,cycles_per_call,bytes_per_cycle,gb_per_s,"
+                     "stream_bytes_per_cycle,stream_gb_per_s,fraction_of_stream\n");
+    }
+
+    double ghz = bench_tsc_ghz(100);
+    printf("TSC: %.3f GHz; bytes per call: %zu\n", ghz, triple);
+    printf("%-14s %12s %10s %9s %8s %9s %8s %6s\n", "kernel", "working set", "cyc/call",
+           "B/cycle", "GB/s", "stream", "GB/s", "frac");
+
+    for (size_t k = 0; k < KERNEL_COUNT; ++k) {
+        if (opt.kernel && strcmp(opt.kernel, kernels[k].name) != 0) continue;
+        for (size_t bytes = opt.min_bytes; bytes <= opt.max_bytes; bytes *= 2) {
+            size_t n = bytes / triple;
+            if (n == 0) continue;
+            size_t reps = n >= MIN_CALLS_PER_SAMPLE ? 1 : (MIN_CALLS_PER_SAMPLE + n - 1) / n;
+
+            // Прогрев — один проход, затем сэмплы ядра
+            measure_kernel(kernels[k].fn, res, a, b, n, 1);
+            for (unsigned s = 0; s < opt.samples; ++s) {
+                samples[s] = measure_kernel(kernels[k].fn, res, a, b, n, reps);
+            }
+            double cyc = bench_stats_compute(samples, scratch, opt.samples).median;
+
+            // Эталон на тех же буферах: a, b читаются как uint64_t, res перезаписывается
+            measure_stream((uint64_t *)res, (const uint64_t *)a, (const uint64_t *)b, n, 1);
+            for (unsigned s = 0; s < opt.samples; ++s) {
+                samples[s] = measure_stream((uint64_t *)res, (const uint64_t *)a,
+                                            (const uint64_t *)b, n, reps);
+            }
+            double stream_cyc = bench_stats_compute(samples, scratch, opt.samples).median;
+
+            double bpc = triple / cyc, gbs = bpc * ghz;
+            double stream_bpc = triple / stream_cyc, stream_gbs = stream_bpc * ghz;
+            printf("%-14s %9zu KB %10.2f %9.2f %8.2f %9.2f %8.2f %5.1f%% ",
+                   kernels[k].name, bytes >> 10, cyc, bpc, gbs, stream_bpc, stream_gbs,
+                   100.0 * gbs / stream_gbs);
+            print_bar(gbs, stream_gbs);
+            putchar('\n');
+            if (csv) {
+                fprintf(csv, "%s,%zu,%zu,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f\n", kernels[k].name,
+                        n * triple, n * reps, cyc, bpc, gbs, stream_bpc, stream_gbs, gbs / stream_gbs);
+            }
+        }
+    }
+
+    printf("Benchmark finished.\n");
+
+    if (csv) fclose(csv);
+    free(scratch);
+    free(samples);
+    free(res);
+    free(b);
+    free(a);
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file    bench_compare.c
+ * @brief   Статистическое сравнение двух прогонов bench_bignum_sub_cycles (регрессионный гейт).
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Читает два CSV, записанных bench_bignum_sub_cycles --samples-csv
+ *   (базовый BASE и новый NEW), и для каждой группы
+ *   "ядро × режим × генератор × корзина длин" оценивает ускорение NEW
+ *   относительно BASE с доверительным интервалом.
+ *
+ *   Корзины по len_a: 1..4, 5..8, 9..16, 17..32 (и `mix` для строк, где
+ *   длины выбирает генератор). Внутри корзины сравниваются только ячейки
+ *   (len_a, len_b), присутствующие в обоих прогонах. Для каждой ячейки
+ *   берётся разность средних логарифмов тактов (NEW - BASE) и её дисперсия
+ *   по Уэлчу; по корзине разности усредняются (стратифицированная оценка),
+ *   число степеней свободы — по Уэлчу–Саттертуэйту. Ускорение — exp(-d),
+ *   интервал — exp(-(d ± t·se)).
+ *
+ *   Вердикт группы:
+ *   - `faster` / `slower` — интервал не содержит 1;
+ *   - `~`                 — различие статистически незначимо;
+ *   - `REGRESSION`        — значимое замедление больше --threshold процентов.
+ *
+ *   Код возврата: 0 — регрессий нет, 1 — есть регрессии, 2 — ошибка ввода.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *
+ * # Запуск
+ *  make bench-compare BASE=baseline NEW=opt_v1
+ *  bin/bench_compare --threshold=3 --confidence=0.95 \
+ *    benchmarks/reports/baseline_samples.csv benchmarks/reports/opt_v1_samples.csv
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAME_MAX_LEN 32
+#define LINE_MAX_LEN 256
+#define BUCKET_COUNT 5
+
+static const char *const bucket_names[BUCKET_COUNT] = { "mix", "1-4", "5-8", "9-16", "17-32" };
+
+/** Накопленные логарифмы тактов одной ячейки для двух прогонов. */
+typedef struct {
+    char     kernel[NAME_MAX_LEN];
+    char     mode[NAME_MAX_LEN];
+    char     gen[NAME_MAX_LEN];
+    unsigned len_a;
+    unsigned len_b;
+    double   sum[2];
+    double   sumsq[2];
+    unsigned n[2];
+} cell_t;
+
+/** Стратифицированная оценка по корзине. */
+typedef struct {
+    const cell_t *first;   // ячейка-представитель (имена ядра, режима, генератора)
+    int      bucket;
+    unsigned cells;
+    double   sum_d;        // сумма разностей средних логарифмов
+    double   sum_var;      // сумма дисперсий разностей
+    double   df_den;       // знаменатель формулы Уэлча–Саттертуэйта
+} group_t;
+
+typedef struct {
+    cell_t *cells;
+    size_t  n;
+    size_t  cap;
+} cell_table_t;
+
+static int bucket_of(unsigned len_a) {
+    if (len_a == 0) return 0;
+    if (len_a <= 4) return 1;
+    if (len_a <= 8) return 2;
+    if (len_a <= 16) return 3;
+    return 4;
+}
+
+static int same_cell(const cell_t *c, const char *kernel, const char *mode, const char *gen,
+                     unsigned la, unsigned lb) {
+    return c->len_a == la && c->len_b == lb && strcmp(c->kernel, kernel) == 0 &&
+           strcmp(c->mode, mode) == 0 && strcmp(c->gen, gen) == 0;
+}
+
+/** Ячейка по ключу; новая добавляется в конец. Сэмплы ячейки идут подряд, поэтому сначала проверяется `*hint`. */
+static cell_t *find_cell(cell_table_t *t, size_t *hint, const char *kernel, const char *mode,
+                         const char *gen, unsigned la, unsigned lb) {
+    if (*hint < t->n && same_cell(&t->cells[*hint], kernel, mode, gen, la, lb)) {
+        return &t->cells[*hint];
+    }
+    for (size_t i = 0; i < t->n; ++i) {
+        if (same_cell(&t->cells[i], kernel, mode, gen, la, lb)) {
+            *hint = i;
+            return &t->cells[i];
+        }
+    }
+    if (t->n == t->cap) {
+        size_t cap = t->cap ? t->cap * 2 : 1024;
+        cell_t *p = realloc(t->cells, sizeof(cell_t) * cap);
+        if (!p) return NULL;
+        t->cells = p;
+        t->cap = cap;
+    }
+    cell_t *c = &t->cells[t->n];
+    memset(c, 0, sizeof(*c));
+    snprintf(c->kernel, sizeof(c->kernel), "%s", kernel);
+    snprintf(c->mode, sizeof(c->mode), "%s", mode);
+    snprintf(c->gen, sizeof(c->gen), "%s", gen);
+    c->len_a = la;
+    c->len_b = lb;
+    *hint = t->n++;
+    return c;
+}
+
+/** Загружает сэмплы прогона `run` (0 — BASE, 1 — NEW). @return число сэмплов, < 0 — ошибка. */
+static long load_samples(const char *path, cell_table_t *t, int run) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    char line[LINE_MAX_LEN];
+    char kernel[NAME_MAX_LEN], mode[NAME_MAX_LEN], gen[NAME_MAX_LEN];
+    unsigned la, lb, idx;
+    double cycles;
+    size_t hint = 0;
+    long n = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%31[^,],%31[^,],%31[^,],%u,%u,%u,%lf", kernel, mode, gen, &la, &lb,
+                   &idx, &cycles) != 7) {
+            continue;   // заголовок или повреждённая строка
+        }
+        if (cycles <= 0) continue;   // такты после вычета накладных расходов, log не определён
+        cell_t *c = find_cell(t, &hint, kernel, mode, gen, la, lb);
+        if (!c) {
+            fclose(f);
+            return -1;
+        }
+        double x = log(cycles);
+        c->sum[run] += x;
+        c->sumsq[run] += x * x;
+        c->n[run]++;
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+/** Квантиль стандартного нормального распределения (Abramowitz–Stegun 26.2.23), 0.5 < p < 1. */
+static double normal_quantile(double p) {
+    double t = sqrt(-2.0 * log(1.0 - p));
+    return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) /
+               (1.0 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+}
+
+/** Квантиль распределения Стьюдента через разложение Корниша–Фишера по z. */
+static double student_quantile(double p, double df) {
+    double z = normal_quantile(p), z2 = z * z;
+    if (df < 1) df = 1;
+    return z + z * (z2 + 1) / (4 * df) + z * ((5 * z2 + 16) * z2 + 3) / (96 * df * df) +
+           z * (((3 * z2 + 19) * z2 + 17) * z2 - 15) / (384 * df * df * df);
+}
+
+static int same_group(const group_t *g, const cell_t *c) {
+    return g->bucket == bucket_of(c->len_a) && strcmp(g->first->kernel, c->kernel) == 0 &&
+           strcmp(g->first->mode, c->mode) == 0 && strcmp(g->first->gen, c->gen) == 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--threshold=PCT] [--confidence=P] BASE_samples.csv NEW_samples.csv\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    double threshold = 3.0, confidence = 0.95;
+    const char *paths[2] = { NULL, NULL };
+    int np = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--threshold=", 12) == 0) threshold = strtod(argv[i] + 12, NULL);
+        else if (strncmp(argv[i], "--confidence=", 13) == 0) confidence = strtod(argv[i] + 13, NULL);
+        else if (argv[i][0] != '-' && np < 2) paths[np++] = argv[i];
+        else np = -1;
+        if (np < 0) break;
+    }
+    if (np != 2 || threshold < 0 || confidence <= 0.5 || confidence >= 1.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    cell_table_t t = { NULL, 0, 0 };
+    long nb = load_samples(paths[0], &t, 0);
+    long nn = nb < 0 ? -1 : load_samples(paths[1], &t, 1);
+    if (nb <= 0 || nn <= 0) {
+        fprintf(stderr, "No samples loaded (run bench_bignum_sub_cycles --samples-csv=FILE)\n");
+        free(t.cells);
+        return 2;
+    }
+
+    group_t *groups = calloc(t.n, sizeof(group_t));
+    if (!groups) {
+        perror("calloc");
+        free(t.cells);
+        return 2;
+    }
+    size_t ng = 0;
+    for (size_t i = 0; i < t.n; ++i) {
+        const cell_t *c = &t.cells[i];
+        if (c->n[0] < 2 || c->n[1] < 2) continue;   // ячейка только в одном из прогонов
+        group_t *g = NULL;
+        for (size_t j = ng; j-- > 0;) {
+            if (same_group(&groups[j], c)) {
+                g = &groups[j];
+                break;
+            }
+        }
+        if (!g) {
+            g = &groups[ng++];
+            g->first = c;
+            g->bucket = bucket_of(c->len_a);
+        }
+        double v[2];
+        for (int r = 0; r < 2; ++r) {
+            double mean = c->sum[r] / c->n[r];
+            double var = (c->sumsq[r] - c->n[r] * mean * mean) / (c->n[r] - 1);
+            v[r] = (var > 0 ? var : 0) / c->n[r];
+        }
+        g->cells++;
+        g->sum_d += c->sum[1] / c->n[1] - c->sum[0] / c->n[0];
+        g->sum_var += v[0] + v[1];
+        g->df_den += v[0] * v[0] / (c->n[0] - 1) + v[1] * v[1] / (c->n[1] - 1);
+    }
+
+    printf("BASE: %s (%ld samples)\nNEW:  %s (%ld samples)\n", paths[0], nb, paths[1], nn);
+    printf("Speedup = BASE/NEW cycles, %.0f%% CI; regression threshold %.1f%%\n",
+           confidence * 100, threshold);
+    printf("%-14s %-10s %-13s %-6s %5s %8s %19s  %s\n", "kernel", "mode", "generator", "len_a",
+           "cells", "speedup", "CI", "verdict");
+
+    unsigned regressions = 0;
+    double p = 1.0 - (1.0 - confidence) / 2;
+    for (size_t j = 0; j < ng; ++j) {
+        const group_t *g = &groups[j];
+        double d = g->sum_d / g->cells;
+        double se = sqrt(g->sum_var) / g->cells;
+        double df = g->df_den > 0 ? g->sum_var * g->sum_var / g->df_den : 1e9;
+        double tq = student_quantile(p, df);
+        double lo = exp(-(d + tq * se)), hi = exp(-(d - tq * se));
+        const char *verdict = "~";
+        if (lo > 1.0) verdict = "faster";
+        else if (hi < 1.0) {
+            verdict = "slower";
+            if ((exp(d) - 1.0) * 100 > threshold) {
+                verdict = "REGRESSION";
+                regressions++;
+            }
+        }
+        printf("%-14s %-10s %-13s %-6s %5u %8.4f [%8.4f, %8.4f]  %s\n", g->first->kernel,
+               g->first->mode, g->first->gen, bucket_names[g->bucket], g->cells, exp(-d), lo, hi,
+               verdict);
+    }
+
+    if (ng == 0) fprintf(stderr, "No cells common to both runs\n");
+    printf("%u significant regression(s) above %.1f%%\n", regressions, threshold);
+
+    free(groups);
+    free(t.cells);
+    if (ng == 0) return 2;
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file    bench_counters.h
+ * @brief   Аппаратные счётчики через perf_event_open для бенчмарков bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Открывает группу счётчиков (такты, инструкции, промахи предсказания
+ *   переходов, промахи чтения L1D, µops) для текущего потока. Лидер группы —
+ *   такты; остальные события добавляются в группу по одному, и событие,
+ *   которое ядро или процессор не поддерживает, просто помечается недоступным.
+ *   Если не открывается даже лидер (нет прав, perf_event_paranoid, контейнер),
+ *   группа целиком недоступна и бенчмарк продолжает работу без счётчиков.
+ *
+ *   Считается только пользовательский режим (exclude_kernel/exclude_hv),
+ *   поэтому при perf_event_paranoid <= 2 sudo не нужен.
+ *
+ *   µops — не обобщённое событие perf: используется raw-событие
+ *   UOPS_ISSUED.ANY (0x010E) на Intel и Retired Ops (0xC1) на AMD.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ */
+
+#ifndef BENCH_COUNTERS_H
+#define BENCH_COUNTERS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <cpuid.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/** Индексы счётчиков в группе. */
+typedef enum {
+    BENCH_CNT_CYCLES = 0,
+    BENCH_CNT_INSTRUCTIONS,
+    BENCH_CNT_BRANCH_MISSES,
+    BENCH_CNT_L1D_MISSES,
+    BENCH_CNT_UOPS,
+    BENCH_CNT_COUNT
+} bench_counter_id_t;
+
+static const char *const bench_counter_names[BENCH_CNT_COUNT] = {
+    "cycles", "instructions", "branch_misses", "l1d_misses", "uops"
+};
+
+/** Группа счётчиков. fd < 0 — событие недоступно. */
+typedef struct {
+    int      fd[BENCH_CNT_COUNT];
+    int      slot[BENCH_CNT_COUNT];  // позиция значения в ответе PERF_FORMAT_GROUP
+    unsigned nr;                     // число открытых событий
+} bench_counters_t;
+
+/** Значения счётчиков за измеряемый участок (масштабированные при мультиплексировании). */
+typedef struct {
+    double value[BENCH_CNT_COUNT];
+    int    valid[BENCH_CNT_COUNT];
+} bench_counter_values_t;
+
+static inline int bench_perf_open(struct perf_event_attr *attr, int group_fd) {
+    return (int)syscall(SYS_perf_event_open, attr, 0, -1, group_fd, 0);
+}
+
+/** Конфигурация raw-события µops для текущего вендора; 0 — неизвестно. */
+static inline uint64_t bench_uops_raw_config(void) {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return 0;
+    // "GenuineIntel" / "AuthenticAMD": сравниваем EBX
+    if (ebx == 0x756e6547u) return 0x010E;   // UOPS_ISSUED.ANY
+    if (ebx == 0x68747541u) return 0x00C1;   // Retired Ops
+    return 0;
+}
+
+static inline void bench_counter_attr(struct perf_event_attr *attr, bench_counter_id_t id) {
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->exclude_kernel = 1;
+    attr->exclude_hv = 1;
+    attr->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                        PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch (id) {
+    case BENCH_CNT_CYCLES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case BENCH_CNT_INSTRUCTIONS:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case BENCH_CNT_BRANCH_MISSES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case BENCH_CNT_L1D_MISSES:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = PERF_COUNT_HW_CACHE_L1D |
+                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    default:
+        attr->type = PERF_TYPE_RAW;
+        attr->config = bench_uops_raw_config();
+        break;
+    }
+}
+
+/**
+ * Открывает группу счётчиков для текущего потока.
+ * @return число открытых событий; 0 — счётчики недоступны.
+ */
+static inline unsigned bench_counters_open(bench_counters_t *c) {
+    struct perf_event_attr attr;
+    c->nr = 0;
+    for (int i = 0; i < BENCH_CNT_COUNT; ++i) {
+        c->fd[i] = -1;
+        c->slot[i] = -1;
+    }
+    for (int i = 0; i < BENCH_CNT_COUNT; ++i) {
+        bench_counter_attr(&attr, (bench_counter_id_t)i);
+        if (attr.type == PERF_TYPE_RAW && attr.config == 0) continue;
+        if (i == BENCH_CNT_CYCLES) attr.disabled = 1;
+        int fd = bench_perf_open(&attr, i == BENCH_CNT_CYCLES ? -1 : c->fd[BENCH_CNT_CYCLES]);
+        if (fd < 0) {
+            if (i == BENCH_CNT_CYCLES) return 0;   // без лидера группы нет
+            continue;
+        }
+        c->fd[i] = fd;
+        c->slot[i] = (int)c->nr++;
+    }
+    return c->nr;
+}
+
+static inline void bench_counters_close(bench_counters_t *c) {
+    for (int i = 0; i < BENCH_CNT_COUNT; ++i) {
+        if (c->fd[i] >= 0) close(c->fd[i]);
+        c->fd[i] = -1;
+    }
+    c->nr = 0;
+}
+
+/** Обнуляет и запускает группу. */
+static inline void bench_counters_start(const bench_counters_t *c) {
+    if (c->nr == 0) return;
+    ioctl(c->fd[BENCH_CNT_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(c->fd[BENCH_CNT_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+/** Останавливает группу и читает значения. @return 0 при успехе. */
+static inline int bench_counters_stop(const bench_counters_t *c, bench_counter_values_t *out) {
+    uint64_t buf[3 + BENCH_CNT_COUNT];
+    memset(out, 0, sizeof(*out));
+    if (c->nr == 0) return -1;
+    ioctl(c->fd[BENCH_CNT_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    ssize_t n = read(c->fd[BENCH_CNT_CYCLES], buf, sizeof(buf));
+    if (n < (ssize_t)(sizeof(uint64_t) * (3 + c->nr)) || buf[0] != c->nr || buf[2] == 0) return -1;
+    // Масштабирование, если группа делила PMU с другими (мультиплексирование)
+    double scale = (double)buf[1] / (double)buf[2];
+    for (int i = 0; i < BENCH_CNT_COUNT; ++i) {
+        if (c->slot[i] < 0) continue;
+        out->value[i] = (double)buf[3 + c->slot[i]] * scale;
+        out->valid[i] = 1;
+    }
+    return 0;
+}
+
+#endif /* BENCH_COUNTERS_H */
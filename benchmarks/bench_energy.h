@@ -0,0 +1,122 @@
+/**
+ * @file    bench_energy.h
+ * @brief   Энергия пакета CPU через счётчики RAPL (powercap sysfs) для бенчмарков bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Читает /sys/class/powercap/intel-rapl:N/energy_uj — накопленную энергию
+ *   домена package каждого сокета в микроджоулях (интерфейс общий для Intel
+ *   и AMD). Энергия за участок — сумма приращений по всем пакетам с учётом
+ *   переполнения счётчика (max_energy_range_uj).
+ *
+ *   Счётчик обновляется примерно раз в миллисекунду, поэтому измеряемый
+ *   участок должен длиться десятки миллисекунд. Значение включает всё,
+ *   что пакет потребляет за это время (другие ядра, uncore, простой), —
+ *   для сравнения ядер нужен одинаковый фон; для оценки фона есть
+ *   bench_energy_idle_watts().
+ *
+ *   Начиная с Linux 5.10 energy_uj по умолчанию читается только root.
+ *   Если ни один домен не открылся (нет RAPL, нет прав, виртуальная машина),
+ *   bench_energy_open() возвращает 0 и бенчмарк продолжает без энергии.
+ *   События perf power/energy-pkg/ не используются: они требуют
+ *   общесистемного режима и тех же прав.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ */
+
+#ifndef BENCH_ENERGY_H
+#define BENCH_ENERGY_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_ENERGY_MAX_DOMAINS 16
+
+#ifndef BENCH_ENERGY_SYSFS
+#  define BENCH_ENERGY_SYSFS "/sys/class/powercap"
+#endif
+
+/** Открытые домены package и значения в начале участка. */
+typedef struct {
+    int      fd[BENCH_ENERGY_MAX_DOMAINS];
+    uint64_t range[BENCH_ENERGY_MAX_DOMAINS];  // max_energy_range_uj
+    uint64_t start[BENCH_ENERGY_MAX_DOMAINS];
+    unsigned n;
+} bench_energy_t;
+
+/** Читает десятичное значение из открытого файла sysfs; 0 при успехе. */
+static inline int bench_energy_read_fd(int fd, uint64_t *v) {
+    char buf[32];
+    ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    *v = strtoull(buf, NULL, 10);
+    return 0;
+}
+
+static inline void bench_energy_close(bench_energy_t *e) {
+    for (unsigned i = 0; i < e->n; ++i) close(e->fd[i]);
+    e->n = 0;
+}
+
+/**
+ * Открывает домены package всех сокетов.
+ * @return число доменов; 0 — RAPL недоступен.
+ */
+static inline unsigned bench_energy_open(bench_energy_t *e) {
+    char path[96];
+    e->n = 0;
+    for (int pkg = 0; pkg < BENCH_ENERGY_MAX_DOMAINS; ++pkg) {
+        uint64_t v;
+        snprintf(path, sizeof(path), BENCH_ENERGY_SYSFS "/intel-rapl:%d/max_energy_range_uj", pkg);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) break;
+        int ok = bench_energy_read_fd(fd, &e->range[e->n]) == 0 && e->range[e->n] > 0;
+        close(fd);
+        if (!ok) continue;
+        snprintf(path, sizeof(path), BENCH_ENERGY_SYSFS "/intel-rapl:%d/energy_uj", pkg);
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        if (bench_energy_read_fd(fd, &v) != 0) {   // EACCES проявляется при чтении
+            close(fd);
+            continue;
+        }
+        e->fd[e->n++] = fd;
+    }
+    return e->n;
+}
+
+static inline void bench_energy_start(bench_energy_t *e) {
+    for (unsigned i = 0; i < e->n; ++i) {
+        if (bench_energy_read_fd(e->fd[i], &e->start[i]) != 0) e->start[i] = 0;
+    }
+}
+
+/** Энергия с bench_energy_start(), мкДж; < 0 — ошибка чтения. */
+static inline double bench_energy_stop(const bench_energy_t *e) {
+    double uj = 0;
+    for (unsigned i = 0; i < e->n; ++i) {
+        uint64_t v;
+        if (bench_energy_read_fd(e->fd[i], &v) != 0) return -1.0;
+        uj += (double)(v >= e->start[i] ? v - e->start[i] : e->range[i] - e->start[i] + v);
+    }
+    return uj;
+}
+
+/** Фоновая мощность пакета (Вт) за `ms` миллисекунд сна; < 0 — ошибка. */
+static inline double bench_energy_idle_watts(bench_energy_t *e, unsigned ms) {
+    struct timespec ts = { ms / 1000, (long)(ms % 1000) * 1000000L };
+    bench_energy_start(e);
+    nanosleep(&ts, NULL);
+    double uj = bench_energy_stop(e);
+    return uj < 0 ? -1.0 : uj * 1e-6 / (ms * 1e-3);
+}
+
+#endif /* BENCH_ENERGY_H */
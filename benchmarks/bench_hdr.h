@@ -0,0 +1,88 @@
+/**
+ * @file    bench_hdr.h
+ * @brief   Гистограмма латентности с фиксированной относительной точностью (HDR) для бенчмарков.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Лог-линейная раскладка в духе HdrHistogram: значения 0..127 хранятся
+ *   точно, далее каждая степень двойки делится на 64 равных подкорзины,
+ *   поэтому относительная погрешность не превышает 1/64 (~1.6%) на всём
+ *   диапазоне uint64_t. Запись — сдвиг и инкремент без ветвлений по данным,
+ *   гистограммы одного размера сливаются сложением счётчиков.
+ *
+ *   Гистограмма не потокобезопасна: каждый поток пишет в свою, слияние
+ *   выполняется после join. Квантиль возвращает верхнюю границу корзины
+ *   (консервативная оценка хвоста), максимум хранится точно.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ */
+
+#ifndef BENCH_HDR_H
+#define BENCH_HDR_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define BENCH_HDR_SUB_BITS 6
+#define BENCH_HDR_SUB      (1u << BENCH_HDR_SUB_BITS)
+/** Корзины: 2*SUB точных значений, затем по SUB на каждый старший бит 7..63. */
+#define BENCH_HDR_BUCKETS  ((64 - BENCH_HDR_SUB_BITS + 1) * BENCH_HDR_SUB)
+
+typedef struct {
+    uint64_t count;
+    uint64_t max;
+    uint64_t counts[BENCH_HDR_BUCKETS];
+} bench_hdr_t;
+
+static inline void bench_hdr_reset(bench_hdr_t *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+static inline unsigned bench_hdr_index(uint64_t v) {
+    if (v < 2 * BENCH_HDR_SUB) return (unsigned)v;
+    unsigned shift = (unsigned)(63 - __builtin_clzll(v)) - BENCH_HDR_SUB_BITS;
+    return shift * BENCH_HDR_SUB + (unsigned)(v >> shift);
+}
+
+/** Наибольшее значение, попадающее в корзину `idx`. */
+static inline uint64_t bench_hdr_upper(unsigned idx) {
+    if (idx < 2 * BENCH_HDR_SUB) return idx;
+    unsigned shift = idx / BENCH_HDR_SUB - 1;
+    uint64_t top = idx % BENCH_HDR_SUB + BENCH_HDR_SUB;
+    return ((top + 1) << shift) - 1;
+}
+
+static inline void bench_hdr_record(bench_hdr_t *h, uint64_t v) {
+    h->counts[bench_hdr_index(v)]++;
+    h->count++;
+    if (v > h->max) h->max = v;
+}
+
+/** dst += src. */
+static inline void bench_hdr_merge(bench_hdr_t *dst, const bench_hdr_t *src) {
+    for (unsigned i = 0; i < BENCH_HDR_BUCKETS; ++i) dst->counts[i] += src->counts[i];
+    dst->count += src->count;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+/** Квантиль q в [0, 1]; 0 для пустой гистограммы. */
+static inline uint64_t bench_hdr_quantile(const bench_hdr_t *h, double q) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (double)h->count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank >= h->count) return h->max;
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < BENCH_HDR_BUCKETS; ++i) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t up = bench_hdr_upper(i);
+            return up < h->max ? up : h->max;
+        }
+    }
+    return h->max;
+}
+
+#endif /* BENCH_HDR_H */
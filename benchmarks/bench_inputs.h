@@ -0,0 +1,246 @@
+/**
+ * @file    bench_inputs.h
+ * @brief   Генераторы входных данных (распределений операндов) для бенчмарков bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Равномерно случайные длины и слова почти никогда не дают длинных цепочек
+ *   заимствования, равных префиксов или `a < b`. Здесь собраны генераторы,
+ *   покрывающие реалистичные и худшие случаи:
+ *
+ *   | имя            | форма | описание                                                   |
+ *   |----------------|-------|------------------------------------------------------------|
+ *   | `random`       | MIX   | исходный init_random_bignum: длины и слова независимы      |
+ *   | `uniform`      | GRID  | случайные слова заданных длин, a >= b                      |
+ *   | `borrow-storm` | GRID  | a = 2^(64*(len_a-1)) (или 2·…), b = 1 (+ старшее слово):   |
+ *   |                |       | заимствование проходит через все слова                     |
+ *   | `near-equal`   | DIAG  | a = b + 1: общий префикс, bignum_cmp и нормализация        |
+ *   |                |       | просматривают все слова                                    |
+ *   | `long-short`   | ROW   | длинное a минус короткое b (1..4 слова)                    |
+ *   | `equal-len`    | DIAG  | случайные слова, len_a == len_b, a >= b                    |
+ *   | `negative`     | GRID  | как `uniform`, но доля `neg_frac` пар переставлена (a < b) |
+ *   | `zipf`         | MIX   | длины по закону Ципфа (показатель `zipf_s`), a >= b        |
+ *
+ *   Форма определяет, какие длины генератор берёт у вызывающего:
+ *   GRID — обе, DIAG — только len_a (len_b = len_a), ROW — только len_a,
+ *   MIX — ни одной (длины выбирает сам). Неиспользуемые длины передаются 0.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ */
+
+#ifndef BENCH_INPUTS_H
+#define BENCH_INPUTS_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <bignum.h>
+
+/** Какие длины генератор принимает от вызывающего. */
+typedef enum {
+    BENCH_GEN_GRID = 0,   // len_a и len_b (len_b <= len_a)
+    BENCH_GEN_DIAG,       // len_a, len_b = len_a
+    BENCH_GEN_ROW,        // len_a, len_b выбирает генератор
+    BENCH_GEN_MIX         // обе длины выбирает генератор
+} bench_gen_shape_t;
+
+/** Настраиваемые параметры генераторов. */
+typedef struct {
+    double neg_frac;   // доля пар с a < b для `negative`
+    double zipf_s;     // показатель распределения Ципфа для `zipf`
+} bench_gen_params_t;
+
+#define BENCH_GEN_PARAMS_DEFAULT { 0.5, 1.1 }
+
+typedef void (*bench_gen_fn)(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                             const bench_gen_params_t *p, uint64_t *rng);
+
+/** Описание генератора. */
+typedef struct {
+    const char       *name;
+    bench_gen_shape_t shape;
+    bench_gen_fn      fn;
+} bench_gen_t;
+
+/** xorshift64*: быстрый ГПСЧ с полными 64-битными словами (rand() даёт 31 бит). */
+static inline uint64_t bench_rng_next(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *s = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+/** Равномерное число в [0, 1). */
+static inline double bench_rng_unit(uint64_t *s) {
+    return (double)(bench_rng_next(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/** Равномерная длина в [lo, hi]. */
+static inline unsigned bench_rng_len(uint64_t *s, unsigned lo, unsigned hi) {
+    return lo + (unsigned)(bench_rng_next(s) % (hi - lo + 1));
+}
+
+/** Случайные слова заданной длины, старшее слово ненулевое, хвост обнулён. */
+static inline void bench_fill_random(bignum_t *x, unsigned len, uint64_t *rng) {
+    memset(x, 0, sizeof(*x));
+    for (unsigned i = 0; i < len; ++i) x->words[i] = bench_rng_next(rng);
+    if (len > 0 && x->words[len - 1] == 0) x->words[len - 1] = 1;
+    x->len = len;
+}
+
+/** Случайная пара заданных длин с гарантией a >= b (len_b <= len_a). */
+static inline void bench_fill_ordered(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                                      uint64_t *rng) {
+    bench_fill_random(a, len_a, rng);
+    bench_fill_random(b, len_b, rng);
+    // При равных длинах старшее слово a больше старшего слова b
+    a->words[len_a - 1] |= 1ull << 63;
+    if (len_b > 0) {
+        b->words[len_b - 1] &= ~(1ull << 63);
+        b->words[len_b - 1] |= 1;
+    }
+}
+
+static inline void bench_swap(bignum_t *a, bignum_t *b) {
+    bignum_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void bench_gen_random(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                             const bench_gen_params_t *p, uint64_t *rng) {
+    (void)len_a; (void)len_b; (void)p;
+    bench_fill_random(a, bench_rng_len(rng, 1, BIGNUM_CAPACITY), rng);
+    bench_fill_random(b, bench_rng_len(rng, 1, BIGNUM_CAPACITY), rng);
+}
+
+static void bench_gen_uniform(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                              const bench_gen_params_t *p, uint64_t *rng) {
+    (void)p;
+    bench_fill_ordered(a, b, len_a, len_b, rng);
+}
+
+static void bench_gen_borrow_storm(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                                   const bench_gen_params_t *p, uint64_t *rng) {
+    (void)p; (void)rng;
+    memset(a, 0, sizeof(*a));
+    memset(b, 0, sizeof(*b));
+    // a = 2^(64*(len_a-1)), при равных длинах — вдвое больше, чтобы a > b
+    a->words[len_a - 1] = (len_a == len_b && len_a > 1) ? 2 : 1;
+    a->len = len_a;
+    // b = 1 (+ единица в старшем слове, чтобы сохранить длину len_b)
+    b->words[0] = 1;
+    if (len_b > 1) b->words[len_b - 1] = 1;
+    b->len = len_b;
+    if (len_a == 1) a->words[0] = 2;
+}
+
+static void bench_gen_near_equal(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                                 const bench_gen_params_t *p, uint64_t *rng) {
+    (void)len_b; (void)p;
+    bench_fill_random(b, len_a, rng);
+    *a = *b;
+    // a = b + 1 без переноса за пределы len_a
+    if (b->words[0] == UINT64_MAX) b->words[0]--;
+    a->words[0] = b->words[0] + 1;
+}
+
+static void bench_gen_long_short(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                                 const bench_gen_params_t *p, uint64_t *rng) {
+    (void)len_b; (void)p;
+    unsigned short_len = bench_rng_len(rng, 1, len_a < 4 ? len_a : 4);
+    bench_fill_ordered(a, b, len_a, short_len, rng);
+}
+
+static void bench_gen_equal_len(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                                const bench_gen_params_t *p, uint64_t *rng) {
+    (void)len_b; (void)p;
+    bench_fill_random(a, len_a, rng);
+    bench_fill_random(b, len_a, rng);
+    // Упорядочиваем по старшему различающемуся слову
+    for (unsigned i = len_a; i-- > 0;) {
+        if (a->words[i] != b->words[i]) {
+            if (a->words[i] < b->words[i]) bench_swap(a, b);
+            break;
+        }
+    }
+}
+
+static void bench_gen_negative(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                               const bench_gen_params_t *p, uint64_t *rng) {
+    bench_fill_ordered(a, b, len_a, len_b, rng);
+    // Переставленная пара даёт a < b (строго, так как a > b до перестановки)
+    if (bench_rng_unit(rng) < p->neg_frac) bench_swap(a, b);
+}
+
+/** Длина по закону Ципфа: P(len = k) ~ 1 / k^s, k = 1..BIGNUM_CAPACITY. */
+static inline unsigned bench_zipf_len(double s, uint64_t *rng) {
+    double norm = 0.0;
+    for (unsigned k = 1; k <= BIGNUM_CAPACITY; ++k) norm += 1.0 / pow((double)k, s);
+    double u = bench_rng_unit(rng) * norm;
+    for (unsigned k = 1; k <= BIGNUM_CAPACITY; ++k) {
+        u -= 1.0 / pow((double)k, s);
+        if (u < 0) return k;
+    }
+    return BIGNUM_CAPACITY;
+}
+
+static void bench_gen_zipf(bignum_t *a, bignum_t *b, unsigned len_a, unsigned len_b,
+                           const bench_gen_params_t *p, uint64_t *rng) {
+    (void)len_a; (void)len_b;
+    unsigned la = bench_zipf_len(p->zipf_s, rng);
+    unsigned lb = bench_zipf_len(p->zipf_s, rng);
+    if (lb > la) {
+        unsigned t = la;
+        la = lb;
+        lb = t;
+    }
+    bench_fill_ordered(a, b, la, lb, rng);
+}
+
+static const bench_gen_t bench_generators[] = {
+    { "random",       BENCH_GEN_MIX,  bench_gen_random },
+    { "uniform",      BENCH_GEN_GRID, bench_gen_uniform },
+    { "borrow-storm", BENCH_GEN_GRID, bench_gen_borrow_storm },
+    { "near-equal",   BENCH_GEN_DIAG, bench_gen_near_equal },
+    { "long-short",   BENCH_GEN_ROW,  bench_gen_long_short },
+    { "equal-len",    BENCH_GEN_DIAG, bench_gen_equal_len },
+    { "negative",     BENCH_GEN_GRID, bench_gen_negative },
+    { "zipf",         BENCH_GEN_MIX,  bench_gen_zipf },
+};
+#define BENCH_GEN_COUNT (sizeof(bench_generators) / sizeof(bench_generators[0]))
+
+/** Поиск генератора по имени; NULL, если не найден. */
+static inline const bench_gen_t *bench_gen_find(const char *name) {
+    for (size_t i = 0; i < BENCH_GEN_COUNT; ++i) {
+        if (strcmp(bench_generators[i].name, name) == 0) return &bench_generators[i];
+    }
+    return NULL;
+}
+
+/**
+ * Генерирует пару для любой формы генератора: недостающие длины
+ * выбираются равномерно (len_b <= len_a), лишние игнорируются.
+ */
+static inline void bench_gen_pair(const bench_gen_t *g, bignum_t *a, bignum_t *b,
+                                  const bench_gen_params_t *p, uint64_t *rng) {
+    unsigned la = bench_rng_len(rng, 1, BIGNUM_CAPACITY);
+    unsigned lb = bench_rng_len(rng, 1, la);
+    g->fn(a, b, la, g->shape == BENCH_GEN_DIAG ? la : lb, p, rng);
+}
+
+/** Печатает список генераторов (для usage). */
+static inline void bench_gen_list(FILE *f) {
+    for (size_t i = 0; i < BENCH_GEN_COUNT; ++i) {
+        fprintf(f, "%s%s", i ? ", " : "", bench_generators[i].name);
+    }
+    fputc('\n', f);
+}
+
+#endif /* BENCH_INPUTS_H */
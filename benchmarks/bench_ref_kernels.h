@@ -0,0 +1,151 @@
+/**
+ * @file    bench_ref_kernels.h
+ * @brief   Эталонные C-реализации bignum_sub для сравнения с ассемблерным ядром.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Все варианты выполняют полный контракт bignum_sub: те же проверки и коды
+ *   ошибок (NULL, ёмкость, перекрытие буферов результата с a и b, a < b через
+ *   bignum_cmp), очистку всех BIGNUM_CAPACITY слов результата и нормализацию
+ *   длины (нулевой результат имеет len = 1). Различается только цикл
+ *   вычитания с заимствованием:
+ *
+ *   | имя            | цикл                                                      |
+ *   |----------------|-----------------------------------------------------------|
+ *   | `ref_int128`   | разность в `unsigned __int128`, заимствование — бит 64    |
+ *   | `ref_subborrow`| интринсик `_subborrow_u64` (sbb)                          |
+ *   | `ref_subcll`   | `__builtin_subcll` (только если компилятор его знает)     |
+ *   | `ref_bytewise` | наивный побайтовый цикл, заимствование в `int`            |
+ *
+ *   Таблица BENCH_REF_KERNELS подставляется в таблицы ядер бенчмарков,
+ *   поэтому эталоны проходят тот же харнесс и те же генераторы, что и
+ *   bignum_sub.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ */
+
+#ifndef BENCH_REF_KERNELS_H
+#define BENCH_REF_KERNELS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <x86intrin.h>
+#include <bignum.h>
+#include <bignum_cmp.h>
+#include "bignum_sub.h"
+
+#if defined(__has_builtin)
+#  if __has_builtin(__builtin_subcll)
+#    define BENCH_HAVE_SUBCLL 1
+#  endif
+#endif
+#ifndef BENCH_HAVE_SUBCLL
+#  define BENCH_HAVE_SUBCLL 0
+#endif
+
+__extension__ typedef unsigned __int128 bench_u128;
+
+/** Пересекаются ли буферы слов [p, p + 256) и [q, q + 256). */
+static inline int bench_ref_overlap(const void *p, const void *q) {
+    const char *x = p, *y = q;
+    const size_t n = sizeof(((bignum_t *)0)->words);
+    return x < y + n && y < x + n;
+}
+
+/** Общие проверки контракта; BIGNUM_SUB_SUCCESS — можно вычитать. */
+static inline bignum_sub_status_t bench_ref_check(const bignum_t *r, const bignum_t *a,
+                                                  const bignum_t *b) {
+    if (!r || !a || !b) return BIGNUM_SUB_ERROR_NULL_PTR;
+    if (a->len < 1 || a->len > BIGNUM_CAPACITY || b->len > BIGNUM_CAPACITY) {
+        return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    }
+    if (bench_ref_overlap(r, a) || bench_ref_overlap(r, b)) return BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
+    if (bignum_cmp(a, b) < 0) return BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    return BIGNUM_SUB_SUCCESS;
+}
+
+/** Очистка хвоста результата и нормализация длины (len >= 1). */
+static inline bignum_sub_status_t bench_ref_finish(bignum_t *r, size_t len) {
+    memset(&r->words[len], 0, sizeof(uint64_t) * (BIGNUM_CAPACITY - len));
+    while (len > 1 && r->words[len - 1] == 0) len--;
+    r->len = len;
+    return BIGNUM_SUB_SUCCESS;
+}
+
+static bignum_sub_status_t ref_int128(bignum_t *r, const bignum_t *a, const bignum_t *b) {
+    bignum_sub_status_t st = bench_ref_check(r, a, b);
+    if (st != BIGNUM_SUB_SUCCESS) return st;
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < a->len; ++i) {
+        uint64_t bw = i < b->len ? b->words[i] : 0;
+        bench_u128 d = (bench_u128)a->words[i] - bw - borrow;
+        r->words[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    return bench_ref_finish(r, a->len);
+}
+
+static bignum_sub_status_t ref_subborrow(bignum_t *r, const bignum_t *a, const bignum_t *b) {
+    bignum_sub_status_t st = bench_ref_check(r, a, b);
+    if (st != BIGNUM_SUB_SUCCESS) return st;
+    unsigned char borrow = 0;
+    size_t i = 0;
+    for (; i < b->len; ++i) {
+        unsigned long long w;
+        borrow = _subborrow_u64(borrow, a->words[i], b->words[i], &w);
+        r->words[i] = w;
+    }
+    for (; i < a->len; ++i) {
+        unsigned long long w;
+        borrow = _subborrow_u64(borrow, a->words[i], 0, &w);
+        r->words[i] = w;
+    }
+    return bench_ref_finish(r, a->len);
+}
+
+#if BENCH_HAVE_SUBCLL
+static bignum_sub_status_t ref_subcll(bignum_t *r, const bignum_t *a, const bignum_t *b) {
+    bignum_sub_status_t st = bench_ref_check(r, a, b);
+    if (st != BIGNUM_SUB_SUCCESS) return st;
+    unsigned long long borrow = 0;
+    size_t i = 0;
+    for (; i < b->len; ++i) r->words[i] = __builtin_subcll(a->words[i], b->words[i], borrow, &borrow);
+    for (; i < a->len; ++i) r->words[i] = __builtin_subcll(a->words[i], 0, borrow, &borrow);
+    return bench_ref_finish(r, a->len);
+}
+#endif
+
+static bignum_sub_status_t ref_bytewise(bignum_t *r, const bignum_t *a, const bignum_t *b) {
+    bignum_sub_status_t st = bench_ref_check(r, a, b);
+    if (st != BIGNUM_SUB_SUCCESS) return st;
+    // Слова little-endian: байт i числа — байт i массива words
+    const unsigned char *pa = (const unsigned char *)a->words;
+    const unsigned char *pb = (const unsigned char *)b->words;
+    unsigned char *pr = (unsigned char *)r->words;
+    size_t na = a->len * sizeof(uint64_t), nb = b->len * sizeof(uint64_t);
+    int borrow = 0;
+    for (size_t i = 0; i < na; ++i) {
+        int d = pa[i] - (i < nb ? pb[i] : 0) - borrow;
+        borrow = d < 0;
+        pr[i] = (unsigned char)(d + (borrow << 8));
+    }
+    return bench_ref_finish(r, a->len);
+}
+
+/** Элементы таблицы ядер: { "имя", функция }. */
+#if BENCH_HAVE_SUBCLL
+#  define BENCH_REF_SUBCLL_ENTRY { "ref_subcll", ref_subcll },
+#else
+#  define BENCH_REF_SUBCLL_ENTRY
+#endif
+
+#define BENCH_REF_KERNELS                  \
+    { "ref_int128",    ref_int128 },       \
+    { "ref_subborrow", ref_subborrow },    \
+    BENCH_REF_SUBCLL_ENTRY                 \
+    { "ref_bytewise",  ref_bytewise },
+
+#endif /* BENCH_REF_KERNELS_H */
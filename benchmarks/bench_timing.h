@@ -0,0 +1,130 @@
+/**
+ * @file    bench_timing.h
+ * @brief   Сериализованный замер TSC и робастная статистика для бенчмарков bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Заголовочный модуль без единицы трансляции: все функции `static inline`,
+ *   поэтому каждый бенчмарк собирается одним файлом, как и раньше.
+ *
+ *   Замер выполняется по схеме `lfence; rdtsc; lfence` ... `rdtscp; lfence`:
+ *   первый `lfence` не даёт `rdtsc` обогнать предыдущие инструкции, второй —
+ *   не даёт измеряемому коду начаться раньше чтения счётчика; `rdtscp` ждёт
+ *   завершения измеряемого кода, а последний `lfence` отсекает последующий код.
+ *   Накладные расходы пустого замера калибруются и вычитаются.
+ *
+ *   Значения выражены в тактах TSC (reference cycles), а не в тактах ядра.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *   - rev 1.1 (17.10.2026): Полная инициализация bench_stats_t — заголовок собирается и C++-бенчмарками.
+ */
+
+#ifndef BENCH_TIMING_H
+#define BENCH_TIMING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <x86intrin.h>
+
+/** Барьер компилятора: запрещает переносить обращения к памяти через точку. */
+#define BENCH_COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/** Делает значение "наблюдаемым", не позволяя компилятору выбросить вычисление. */
+#define BENCH_KEEP(v) __asm__ __volatile__("" : : "r"(v) : "memory")
+
+/** Статистика по набору сэмплов. */
+typedef struct {
+    double   median;  /**< Медиана. */
+    double   mad;     /**< Медианное абсолютное отклонение (не масштабированное). */
+    double   min;     /**< Минимум. */
+    double   max;     /**< Максимум. */
+    unsigned n;       /**< Число сэмплов. */
+} bench_stats_t;
+
+/** Чтение TSC в начале измеряемого участка. */
+static inline uint64_t bench_tsc_start(void) {
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+/** Чтение TSC в конце измеряемого участка. */
+static inline uint64_t bench_tsc_stop(void) {
+    unsigned aux;
+    uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+}
+
+/** Монотонное время в наносекундах. */
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_cmp_double(const void *x, const void *y) {
+    double a = *(const double *)x;
+    double b = *(const double *)y;
+    return (a > b) - (a < b);
+}
+
+/** Медиана отсортированного массива. */
+static inline double bench_sorted_median(const double *v, unsigned n) {
+    if (n == 0) return 0.0;
+    return (n & 1) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+/**
+ * Считает median/MAD/min/max. Массив `v` сортируется на месте,
+ * `scratch` — рабочий буфер того же размера.
+ */
+static inline bench_stats_t bench_stats_compute(double *v, double *scratch, unsigned n) {
+    bench_stats_t s = {0, 0, 0, 0, 0};
+    if (n == 0) return s;
+    qsort(v, n, sizeof(double), bench_cmp_double);
+    s.n = n;
+    s.min = v[0];
+    s.max = v[n - 1];
+    s.median = bench_sorted_median(v, n);
+    for (unsigned i = 0; i < n; ++i) {
+        double d = v[i] - s.median;
+        scratch[i] = d < 0 ? -d : d;
+    }
+    qsort(scratch, n, sizeof(double), bench_cmp_double);
+    s.mad = bench_sorted_median(scratch, n);
+    return s;
+}
+
+/** Медиана накладных расходов пустого замера в тактах TSC. */
+static inline double bench_tsc_overhead(void) {
+    enum { N = 255 };
+    double v[N], scratch[N];
+    for (unsigned i = 0; i < N; ++i) {
+        uint64_t t0 = bench_tsc_start();
+        BENCH_COMPILER_BARRIER();
+        uint64_t t1 = bench_tsc_stop();
+        v[i] = (double)(t1 - t0);
+    }
+    return bench_stats_compute(v, scratch, N).median;
+}
+
+/** Оценка частоты TSC (ГГц) по монотонным часам за ~`ms` миллисекунд. */
+static inline double bench_tsc_ghz(unsigned ms) {
+    uint64_t ns0 = bench_now_ns();
+    uint64_t t0 = bench_tsc_start();
+    uint64_t ns1;
+    do {
+        ns1 = bench_now_ns();
+    } while (ns1 - ns0 < (uint64_t)ms * 1000000ull);
+    uint64_t t1 = bench_tsc_stop();
+    return (double)(t1 - t0) / (double)(ns1 - ns0);
+}
+
+#endif /* BENCH_TIMING_H */
@@ -0,0 +1,90 @@
+/**
+ * @file    bench_topology.h
+ * @brief   Топология CPU и порядок закрепления потоков для многопоточных бенчмарков.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Строит порядок логических CPU для закрепления потоков: сначала по одному
+ *   CPU на каждое физическое ядро (пакет, core_id), затем SMT-соседи — вторые
+ *   логические CPU ядер, и т.д. Так первые N потоков при N <= числа ядер не
+ *   делят ядро, а кривая масштабирования показывает отдельно вклад ядер и SMT.
+ *
+ *   Учитывается маска affinity процесса (например, заданная taskset), топология
+ *   читается из /sys/devices/system/cpu/cpuN/topology. Если sysfs недоступен,
+ *   каждый CPU считается отдельным ядром.
+ *
+ *   Требует _GNU_SOURCE (sched_getaffinity, cpu_set_t).
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ */
+
+#ifndef BENCH_TOPOLOGY_H
+#define BENCH_TOPOLOGY_H
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Логический CPU и его место в топологии. */
+typedef struct {
+    int cpu;       // номер логического CPU
+    int package;   // physical_package_id
+    int core;      // core_id внутри пакета
+    int smt;       // порядковый номер среди SMT-соседей ядра (0 — первый)
+} bench_cpu_t;
+
+static inline int bench_read_topology_int(int cpu, const char *name, int fallback) {
+    char path[128];
+    int v = fallback;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+    FILE *f = fopen(path, "r");
+    if (f) {
+        if (fscanf(f, "%d", &v) != 1) v = fallback;
+        fclose(f);
+    }
+    return v;
+}
+
+static int bench_cpu_cmp(const void *x, const void *y) {
+    const bench_cpu_t *a = x, *b = y;
+    if (a->smt != b->smt) return a->smt - b->smt;
+    if (a->package != b->package) return a->package - b->package;
+    if (a->core != b->core) return a->core - b->core;
+    return a->cpu - b->cpu;
+}
+
+/**
+ * Заполняет `out` логическими CPU из маски affinity процесса в порядке
+ * закрепления (ядра, затем SMT-соседи). @return число CPU (0 — ошибка).
+ */
+static inline int bench_cpu_order(bench_cpu_t *out, int max) {
+    cpu_set_t set;
+    int n = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && n < max; ++cpu) {
+        if (!CPU_ISSET(cpu, &set)) continue;
+        out[n].cpu = cpu;
+        out[n].package = bench_read_topology_int(cpu, "physical_package_id", 0);
+        out[n].core = bench_read_topology_int(cpu, "core_id", cpu);
+        out[n].smt = 0;
+        // Номер среди уже найденных CPU того же ядра (CPU перебираются по возрастанию)
+        for (int j = 0; j < n; ++j) {
+            if (out[j].package == out[n].package && out[j].core == out[n].core) out[n].smt++;
+        }
+        n++;
+    }
+    qsort(out, (size_t)n, sizeof(*out), bench_cpu_cmp);
+    return n;
+}
+
+/** Число различных физических ядер в списке. */
+static inline int bench_cpu_physical_cores(const bench_cpu_t *cpus, int n) {
+    int cores = 0;
+    for (int i = 0; i < n; ++i) cores += cpus[i].smt == 0;
+    return cores;
+}
+
+#endif /* BENCH_TOPOLOGY_H */
@@ -0,0 +1,130 @@
+/**
+ * @file    bignum_sub_async.h
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Асинхронный сервис bignum_sub: кольца заявок и рабочие потоки, выполняющие их пакетами.
+ *
+ * @details
+ *   Производители (любые потоки) кладут заявку (result, a, b, completion)
+ *   в кольцо и сразу возвращаются; рабочие потоки, по одному на кольцо и
+ *   по возможности закреплённые за отдельными ядрами, забирают заявки
+ *   пакетами до `batch` штук, выполняют их подряд через bignum_sub и
+ *   сообщают о завершении. Модуль входит в библиотеку инструментирования
+ *   (build/libbignum_sub_instr.a), обёртка `-Wl,--wrap` для него не нужна.
+ *
+ *   ### Кольца
+ *   Каждое кольцо — ограниченная MPSC-очередь без блокировок: производитель
+ *   занимает позицию CAS-ом хвоста и публикует запись release-записью её
+ *   номера последовательности, единственный потребитель (рабочий поток)
+ *   читает номера без атомарных read-modify-write. Поток-производитель
+ *   закрепляется за одним кольцом при первой заявке (по кругу) и переходит
+ *   на соседние, только если его кольцо заполнено. Заявки одного
+ *   производителя в одно кольцо выполняются по порядку.
+ *
+ *   ### Ожидание
+ *   Без заявок рабочий поток опрашивает кольцо `spin` раз и засыпает на
+ *   futex; производитель будит его, только если он действительно спит.
+ *   Завершение заявки — запись статуса и флага в bignum_sub_completion_t.
+ *   Ожидающий может опрашивать флаг (bignum_sub_async_poll()) или
+ *   вызвать bignum_sub_async_wait(): опрос `spin` раз, затем сон на futex
+ *   флага; рабочий поток делает системный вызов пробуждения только для
+ *   уснувшего ожидающего. Если задан `notify`, вместо флага рабочий поток
+ *   вызывает его (в своём потоке) — так завершение передаётся в
+ *   собственный планировщик приложения.
+ *
+ *   Сервис не копирует операнды: a, b и result должны оставаться живыми и
+ *   неизменными до завершения заявки.
+ *
+ * @note    Для сборки требуется флаг `-pthread`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+#ifndef BIGNUM_SUB_ASYNC_H
+#define BIGNUM_SUB_ASYNC_H
+
+#include <bignum.h>
+#include <stdint.h>
+#include "bignum_sub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Значения по умолчанию для нулевых полей конфигурации. */
+#define BIGNUM_SUB_ASYNC_RING_SIZE 1024
+#define BIGNUM_SUB_ASYNC_BATCH     64
+#define BIGNUM_SUB_ASYNC_SPIN      4096
+/** Наибольшее число рабочих потоков и наибольший пакет. */
+#define BIGNUM_SUB_ASYNC_MAX_WORKERS 64
+#define BIGNUM_SUB_ASYNC_MAX_BATCH   256
+
+typedef struct bignum_sub_async bignum_sub_async_t;
+
+/** Параметры сервиса; нулевое поле — значение по умолчанию. */
+typedef struct {
+    unsigned   workers;     /** Рабочих потоков и колец (0 — 1). **/
+    unsigned   ring_size;   /** Записей в кольце, степень двойки. **/
+    unsigned   batch;       /** Наибольший пакет рабочего потока. **/
+    unsigned   spin;        /** Холостых опросов кольца перед сном. **/
+    const int *cpus;        /** CPU рабочих потоков (workers штук) или NULL — без закрепления. **/
+} bignum_sub_async_config_t;
+
+/** Завершение заявки. Поля `state` и `status` заполняет сервис. */
+typedef struct bignum_sub_completion {
+    uint32_t            state;    /** 0 — в работе, 1 — готово (внутреннее: 2 — ожидающий спит). **/
+    bignum_sub_status_t status;   /** Код возврата bignum_sub после готовности. **/
+    /** Если не NULL — вызывается рабочим потоком вместо установки флага. **/
+    void              (*notify)(struct bignum_sub_completion *c);
+    void               *user;     /** Данные приложения для notify. **/
+} bignum_sub_completion_t;
+
+/**
+ * @brief Создаёт кольца и запускает рабочие потоки.
+ * @param cfg Параметры или NULL — все по умолчанию.
+ * @return Сервис или NULL при ошибке (errno; EINVAL — неверные параметры).
+ */
+bignum_sub_async_t *bignum_sub_async_create(const bignum_sub_async_config_t *cfg);
+
+/**
+ * @brief Выполняет все уже поставленные заявки, останавливает рабочие потоки и освобождает сервис.
+ * @details Новые заявки во время и после вызова не допускаются.
+ */
+void bignum_sub_async_destroy(bignum_sub_async_t *svc);
+
+/**
+ * @brief Ставит заявку `bignum_sub(result, a, b)` в очередь, не блокируясь.
+ * @details Заполняет c->state; c->notify и c->user задаёт вызывающий.
+ *          Проверки аргументов выполняет ядро: их результат — код в c->status.
+ * @return 0 при успехе, -1 если все кольца заполнены (повторите позже).
+ */
+int bignum_sub_async_submit(bignum_sub_async_t *svc, bignum_t *result, const bignum_t *a,
+                            const bignum_t *b, bignum_sub_completion_t *c);
+
+/** @brief 1, если заявка завершена (c->status готов), иначе 0. Для заявок без notify. */
+int bignum_sub_async_poll(const bignum_sub_completion_t *c);
+
+/**
+ * @brief Ждёт завершения заявки без notify: `spin` опросов, затем сон на futex.
+ * @return Код возврата bignum_sub.
+ */
+bignum_sub_status_t bignum_sub_async_wait(bignum_sub_completion_t *c, unsigned spin);
+
+/** Счётчики сервиса (сумма по рабочим потокам). */
+typedef struct {
+    uint64_t calls;     /** Выполненные заявки. **/
+    uint64_t batches;   /** Непустые пакеты. **/
+    uint64_t sleeps;    /** Засыпания рабочих потоков. **/
+    uint64_t wakeups;   /** Пробуждения ожидающих через futex. **/
+} bignum_sub_async_counters_t;
+
+/** @brief Снимок счётчиков (во время работы — приблизительный). */
+void bignum_sub_async_counters(const bignum_sub_async_t *svc, bignum_sub_async_counters_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIGNUM_SUB_ASYNC_H */
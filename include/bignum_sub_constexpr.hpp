@@ -0,0 +1,145 @@
+/**
+ * @file    bignum_sub_constexpr.hpp
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   C++20: constexpr-реализация контракта bignum_sub для констант времени компиляции.
+ *
+ * @details
+ *   bn::constexpr_sub() реализует контракт bignum_sub: тот же порядок
+ *   проверок и коды возврата (NULL, ёмкость, перекрытие, a < b по правилам
+ *   bignum_cmp — сначала len, затем слова от старшего), запись всех
+ *   BIGNUM_CAPACITY слов и нормализация длины (ноль — len = 1); при
+ *   ошибке результат не меняется. Результат — обычный bignum_t. Совпадение
+ *   с ядром по коду возврата и всем байтам результата проверяет
+ *   tests/test_bignum_sub_constexpr.cpp.
+ *
+ *   - bn::sub(r, a, b) — в константном вычислении идёт constexpr-путь, во
+ *     время выполнения вызывается ассемблерное ядро;
+ *   - bn::const_sub(a, b) — consteval: значение или ошибка компиляции,
+ *     если код возврата не BIGNUM_SUB_SUCCESS;
+ *   - bn::make_bignum({w0, w1, ...}) — константа из слов (младшее первым).
+ *
+ *   Вычитание констант сворачивается полностью, если результат вычисляется
+ *   в константном контексте: `constexpr`/`constinit` переменная или
+ *   bn::const_sub(). Обычный вызов во время выполнения — это вызов ядра,
+ *   даже если операнды константны.
+ *
+ *   В константном вычислении перекрытием считается только совпадение
+ *   адресов: слова различных объектов bignum_t там пересекаться не могут.
+ *   Во время выполнения проверяются диапазоны слов, как в ядре.
+ *
+ * @note    Требуется C++20 (`-std=c++20`).
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Уточнено описание: контракт bignum_sub, а не копия ядра.
+ */
+#ifndef BIGNUM_SUB_CONSTEXPR_HPP
+#define BIGNUM_SUB_CONSTEXPR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include "bignum_sub.h"
+
+namespace bn {
+
+namespace ce_detail {
+
+/** Сравнение по правилам bignum_cmp: длина, затем слова от старшего. */
+constexpr int cmp(const bignum_t &a, const bignum_t &b) noexcept {
+    if (a.len != b.len) return a.len > b.len ? 1 : -1;
+    for (std::size_t i = a.len; i-- > 0;) {
+        if (a.words[i] != b.words[i]) return a.words[i] > b.words[i] ? 1 : -1;
+    }
+    return 0;
+}
+
+/** Пересекаются ли слова [p, p + 256) и [q, q + 256). */
+constexpr bool overlap(const bignum_t *p, const bignum_t *q) noexcept {
+    if (std::is_constant_evaluated()) return p == q;
+    const std::uintptr_t x = reinterpret_cast<std::uintptr_t>(p);
+    const std::uintptr_t y = reinterpret_cast<std::uintptr_t>(q);
+    const std::uintptr_t n = sizeof(p->words);
+    return x < y + n && y < x + n;
+}
+
+/** Длины в пределах контракта ядра. */
+constexpr bool fits(const bignum_t &a, const bignum_t &b) noexcept {
+    return a.len >= 1 && a.len <= BIGNUM_CAPACITY && b.len <= BIGNUM_CAPACITY;
+}
+
+/** r = a - b при a >= b: все слова, нормализованная длина. */
+constexpr void store(bignum_t &r, const bignum_t &a, const bignum_t &b) noexcept {
+    std::uint64_t borrow = 0;
+    for (std::size_t i = 0; i < BIGNUM_CAPACITY; ++i) {
+        if (i >= a.len) {
+            r.words[i] = 0;
+            continue;
+        }
+        const std::uint64_t x = a.words[i], y = i < b.len ? b.words[i] : 0;
+        r.words[i] = x - y - borrow;
+        borrow = (x < y || (x == y && borrow)) ? 1 : 0;
+    }
+    std::size_t len = a.len;
+    while (len > 1 && r.words[len - 1] == 0) len--;
+    r.len = len;
+}
+
+} // namespace ce_detail
+
+/**
+ * @brief constexpr-аналог bignum_sub с тем же контрактом.
+ * @return Код возврата bignum_sub; при ошибке `*r` не меняется.
+ */
+constexpr bignum_sub_status_t constexpr_sub(bignum_t *r, const bignum_t *a, const bignum_t *b) noexcept {
+    if (!r || !a || !b) return BIGNUM_SUB_ERROR_NULL_PTR;
+    if (!ce_detail::fits(*a, *b)) return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    if (ce_detail::overlap(r, a) || ce_detail::overlap(r, b)) return BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
+    if (ce_detail::cmp(*a, *b) < 0) return BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    ce_detail::store(*r, *a, *b);
+    return BIGNUM_SUB_SUCCESS;
+}
+
+/**
+ * @brief bignum_sub, пригодный в константных выражениях.
+ * @details В константном вычислении — constexpr_sub(), иначе — ассемблерное ядро.
+ */
+constexpr bignum_sub_status_t sub(bignum_t *r, const bignum_t *a, const bignum_t *b) noexcept {
+    if (std::is_constant_evaluated()) return constexpr_sub(r, a, b);
+    return ::bignum_sub(r, a, b);
+}
+
+/** @brief Константа a - b; ошибка компиляции при любом коде, кроме BIGNUM_SUB_SUCCESS. */
+consteval bignum_t const_sub(const bignum_t &a, const bignum_t &b) {
+    // Операнды-ссылки: NULL и перекрытие с локальным результатом невозможны
+    if (!ce_detail::fits(a, b)) throw std::length_error("bn::const_sub: capacity exceeded");
+    if (ce_detail::cmp(a, b) < 0) throw std::domain_error("bn::const_sub: negative result");
+    bignum_t r{};
+    ce_detail::store(r, a, b);
+    return r;
+}
+
+/**
+ * @brief Нормализованное число из слов, младшее первым (пустой список — ноль).
+ * @details Больше BIGNUM_CAPACITY слов — std::length_error (в константном вычислении — ошибка компиляции).
+ */
+constexpr bignum_t make_bignum(std::initializer_list<std::uint64_t> words) {
+    if (words.size() > BIGNUM_CAPACITY) {
+        throw std::length_error("bn::make_bignum: more than BIGNUM_CAPACITY words");
+    }
+    bignum_t x{};
+    std::size_t len = 0;
+    for (std::uint64_t w : words) x.words[len++] = w;
+    while (len > 1 && x.words[len - 1] == 0) len--;
+    x.len = len ? len : 1;
+    return x;
+}
+
+} // namespace bn
+
+#endif /* BIGNUM_SUB_CONSTEXPR_HPP */
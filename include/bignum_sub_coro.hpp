@@ -0,0 +1,208 @@
+/**
+ * @file    bignum_sub_coro.hpp
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   C++20: ожидаемое `co_await bn::sub(a, b)` с пакетным выполнением по тактам.
+ *
+ * @details
+ *   Заголовочный слой над bignum_sub.h для сервисов на корутинах.
+ *   `co_await bn::sub(...)` не вызывает ядро сразу: корутина
+ *   приостанавливается, а заявка встаёт в очередь планировщика
+ *   bn::batcher (по умолчанию — свой на каждый поток, batcher::local()).
+ *   Цикл событий приложения раз в такт вызывает batcher::tick(): все
+ *   накопившиеся заявки выполняются одним проходом, затем ожидающие
+ *   корутины возобновляются с результатом и кодом возврата.
+ *
+ *   ### Проход
+ *   Заявки независимы, поэтому проход — подряд идущие вызовы bignum_sub
+ *   без ветвлений между ними, с предвыборкой операндов заявки, стоящей
+ *   на BN_SUB_CORO_PREFETCH позиций впереди. Так внеочередное выполнение
+ *   перекрывает соседние вычитания, а промахи кэша по операндам
+ *   перекрываются вычислением текущей заявки.
+ *
+ *   ### Время жизни
+ *   Операнды и результат должны жить до возобновления корутины (обычно
+ *   это её локальные переменные). Корутину, ожидающую в очереди, нельзя
+ *   уничтожать до такта. Заявки, поставленные возобновлёнными корутинами,
+ *   выполняются в следующем такте. Если возобновление бросило исключение,
+ *   tick() передаёт его вызывающему, а оставшиеся корутины прохода
+ *   возобновляет следующий tick() до нового прохода.
+ *
+ *   Планировщик однопоточный: заявки ставятся и такты выполняются в
+ *   одном потоке.
+ *
+ * @note    Требуется C++20 (`-std=c++20`).
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+#ifndef BIGNUM_SUB_CORO_HPP
+#define BIGNUM_SUB_CORO_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bignum_sub.h"
+
+/** Дистанция предвыборки операндов в проходе (в заявках). */
+#ifndef BN_SUB_CORO_PREFETCH
+#  define BN_SUB_CORO_PREFETCH 4
+#endif
+
+namespace bn {
+
+/** Результат `co_await bn::sub(a, b)`. */
+struct sub_result {
+    bignum_t            value;
+    bignum_sub_status_t status;
+};
+
+namespace detail {
+
+/** Заявка в очереди планировщика; живёт в кадре ожидающей корутины. */
+struct sub_request {
+    bignum_t               *r;
+    const bignum_t         *a;
+    const bignum_t         *b;
+    bignum_sub_status_t     status;
+    std::coroutine_handle<> handle;
+};
+
+} // namespace detail
+
+/** Планировщик заявок: собирает их между тактами и выполняет пакетом. */
+class batcher {
+public:
+    /** Счётчики планировщика. */
+    struct counters {
+        std::uint64_t ticks;   /** Непустые проходы. **/
+        std::uint64_t calls;   /** Выполненные заявки. **/
+    };
+
+    batcher() = default;
+    batcher(const batcher &) = delete;
+    batcher &operator=(const batcher &) = delete;
+
+    /** @brief Планировщик текущего потока (используется bn::sub без явного планировщика). */
+    static batcher &local() noexcept {
+        thread_local batcher instance;
+        return instance;
+    }
+
+    /** @brief Заявок в очереди следующего такта. */
+    std::size_t pending() const noexcept { return queue_.size(); }
+
+    /** @brief Снимок счётчиков. */
+    counters stats() const noexcept { return stats_; }
+
+    /**
+     * @brief Такт: выполняет все заявки, поставленные до его начала, и возобновляет их корутины.
+     * @return Число выполненных заявок.
+     */
+    std::size_t tick() {
+        resume_running();
+        if (queue_.empty()) return 0;
+        running_.swap(queue_);
+        const std::size_t n = running_.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i + BN_SUB_CORO_PREFETCH < n) {
+                const detail::sub_request *next = running_[i + BN_SUB_CORO_PREFETCH];
+                __builtin_prefetch(next->a);
+                __builtin_prefetch(next->b);
+            }
+            detail::sub_request *w = running_[i];
+            w->status = bignum_sub(w->r, w->a, w->b);
+        }
+        stats_.ticks++;
+        stats_.calls += n;
+        resume_running();
+        return n;
+    }
+
+    /** @brief Такты, пока очередь не опустеет. @return Число выполненных заявок. */
+    std::size_t drain() {
+        std::size_t total = 0;
+        while (!queue_.empty() || next_ < running_.size()) total += tick();
+        return total;
+    }
+
+    /** @brief Ставит заявку в очередь (вызывается из await_suspend). */
+    void enqueue(detail::sub_request *w) { queue_.push_back(w); }
+
+private:
+    /** Возобновляет корутины текущего прохода; next_ переживает исключение из resume(). */
+    void resume_running() {
+        while (next_ < running_.size()) running_[next_++]->handle.resume();
+        running_.clear();
+        next_ = 0;
+    }
+
+    std::vector<detail::sub_request *> queue_;
+    std::vector<detail::sub_request *> running_;
+    std::size_t                        next_ = 0;
+    counters                           stats_{};
+};
+
+/** Ожидаемое с результатом в вызывающем буфере: `co_await` возвращает код возврата. */
+class sub_into_awaitable {
+public:
+    sub_into_awaitable(batcher &q, bignum_t *r, const bignum_t *a, const bignum_t *b) noexcept
+        : q_(&q), req_{r, a, b, BIGNUM_SUB_SUCCESS, {}} {}
+    sub_into_awaitable(const sub_into_awaitable &) = delete;
+    sub_into_awaitable &operator=(const sub_into_awaitable &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        req_.handle = h;
+        q_->enqueue(&req_);
+    }
+    bignum_sub_status_t await_resume() const noexcept { return req_.status; }
+
+private:
+    batcher            *q_;
+    detail::sub_request req_;
+};
+
+/** Ожидаемое с результатом в кадре корутины: `co_await` возвращает sub_result. */
+class sub_awaitable {
+public:
+    sub_awaitable(batcher &q, const bignum_t *a, const bignum_t *b) noexcept
+        : q_(&q), req_{nullptr, a, b, BIGNUM_SUB_SUCCESS, {}} {}
+    sub_awaitable(const sub_awaitable &) = delete;
+    sub_awaitable &operator=(const sub_awaitable &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        // Адрес результата фиксируется здесь: объект уже в кадре корутины
+        req_.r = &res_.value;
+        req_.handle = h;
+        q_->enqueue(&req_);
+    }
+    sub_result await_resume() noexcept {
+        res_.status = req_.status;
+        return res_;
+    }
+
+private:
+    batcher            *q_;
+    detail::sub_request req_;
+    sub_result          res_;
+};
+
+/** @brief `co_await bn::sub(a, b)` → sub_result{a - b, код возврата}. */
+inline sub_awaitable sub(const bignum_t &a, const bignum_t &b, batcher &q = batcher::local()) noexcept {
+    return sub_awaitable(q, &a, &b);
+}
+
+/** @brief `co_await bn::sub(r, a, b)` → код возврата; результат пишется в `r` без копии. */
+inline sub_into_awaitable sub(bignum_t &r, const bignum_t &a, const bignum_t &b,
+                              batcher &q = batcher::local()) noexcept {
+    return sub_into_awaitable(q, &r, &a, &b);
+}
+
+} // namespace bn
+
+#endif /* BIGNUM_SUB_CORO_HPP */
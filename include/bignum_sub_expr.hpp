@@ -0,0 +1,242 @@
+/**
+ * @file    bignum_sub_expr.hpp
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   C++20: шаблоны выражений над bignum_t — цепочки `a - b - c + d` за один проход.
+ *
+ * @details
+ *   Обёртка bn::num (раскладка совпадает с bignum_t) и операторы `-`/`+`,
+ *   которые не вычисляют ничего, а строят лёгкое выражение из указателей
+ *   на операнды. Присваивание выражения выполняет один слитый цикл по
+ *   словам: на каждом слове операнды со своими знаками складываются в
+ *   знаковый 128-битный аккумулятор, младшие 64 бита уходят в результат,
+ *   старшие (многобитный перенос/заём) — в следующее слово. Нет ни
+ *   промежуточных bignum_t по 264 байта, ни отдельного прохода bignum_sub
+ *   с bignum_cmp на каждый оператор.
+ *
+ *   ### Контракт
+ *   Как у bignum_sub: все BIGNUM_CAPACITY слов результата записаны, длина
+ *   нормализована (ноль — len = 1). Коды возврата:
+ *   - BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED — длина операнда больше
+ *     BIGNUM_CAPACITY, первый операнд (уменьшаемое) имеет len = 0 или
+ *     сумма не помещается в BIGNUM_CAPACITY слов;
+ *   - BIGNUM_SUB_ERROR_NEGATIVE_RESULT — значение выражения отрицательно.
+ *
+ *   Знак проверяется только у итогового значения: `a - b + c` при a < b
+ *   вычисляется, тогда как цепочка вызовов bignum_sub вернула бы ошибку на
+ *   первом шаге. При ошибке приёмник не меняется. Приёмник может совпадать
+ *   с любым операндом (`x = x - y - z`): слово i результата зависит только
+ *   от слов i операндов и попадает в приёмник после проверки.
+ *
+ *   Выражение хранит указатели на операнды и должно вычисляться, пока они
+ *   живы. Сырой bignum_t становится операндом через bn::ref().
+ *
+ * @note    Требуется C++20 (`-std=c++20`).
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+#ifndef BIGNUM_SUB_EXPR_HPP
+#define BIGNUM_SUB_EXPR_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include "bignum_sub.h"
+
+namespace bn {
+
+/** База выражений: метка для концепта и поиска операторов bn по ADL. */
+struct expr_base {};
+
+class num;
+
+namespace expr_detail {
+
+__extension__ typedef __int128 acc_t;
+
+/** Лист: один операнд. */
+struct leaf : expr_base {
+    static constexpr std::size_t terms = 1;
+    const bignum_t *x;
+
+    constexpr explicit leaf(const bignum_t *p) noexcept : x(p) {}
+    void collect(const bignum_t **xs, bool *neg, std::size_t &k, bool minus) const noexcept {
+        xs[k] = x;
+        neg[k++] = minus;
+    }
+};
+
+/** Узел `l + r` или `l - r`; поддеревья хранятся по значению (это указатели). */
+template <class L, class R, bool Minus>
+struct binary : expr_base {
+    static constexpr std::size_t terms = L::terms + R::terms;
+    L l;
+    R r;
+
+    constexpr binary(const L &a, const R &b) noexcept : l(a), r(b) {}
+    void collect(const bignum_t **xs, bool *neg, std::size_t &k, bool minus) const noexcept {
+        l.collect(xs, neg, k, minus);
+        r.collect(xs, neg, k, minus != Minus);
+    }
+};
+
+} // namespace expr_detail
+
+/** Выражение над bignum_t (лист или узел). */
+template <class E>
+concept expression = std::derived_from<E, expr_base>;
+
+/** Операнд оператора или присваивания: выражение или num (становится листом). */
+template <class T>
+concept operand = expression<T> || std::same_as<T, num>;
+
+/** @brief Сырой bignum_t как операнд выражения. */
+constexpr expr_detail::leaf ref(const bignum_t &x) noexcept {
+    return expr_detail::leaf(&x);
+}
+
+/**
+ * @brief Вычисляет выражение в `dst` одним проходом по словам.
+ * @return BIGNUM_SUB_SUCCESS или код ошибки (см. @details файла); при ошибке `dst` не меняется.
+ */
+template <expression E>
+bignum_sub_status_t eval(bignum_t &dst, const E &e) noexcept {
+    constexpr std::size_t n = E::terms;
+    const bignum_t *xs[n];
+    bool neg[n];
+    std::size_t k = 0;
+    e.collect(xs, neg, k, false);
+
+    if (xs[0]->len < 1) return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    std::size_t len = 0, common = BIGNUM_CAPACITY;
+    for (std::size_t j = 0; j < n; ++j) {
+        if (xs[j]->len > BIGNUM_CAPACITY) return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+        if (xs[j]->len > len) len = xs[j]->len;
+        if (xs[j]->len < common) common = xs[j]->len;
+    }
+
+    // Слитый цикл: знаковая сумма слов i всех операндов плюс перенос/заём предыдущего слова.
+    // До common слова есть у всех операндов, дальше отсутствующие считаются нулями.
+    std::uint64_t out[BIGNUM_CAPACITY];
+    expr_detail::acc_t acc = 0;
+    std::size_t i = 0;
+    for (; i < common; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (neg[j]) acc -= xs[j]->words[i];
+            else acc += xs[j]->words[i];
+        }
+        out[i] = static_cast<std::uint64_t>(acc);
+        acc >>= 64;
+    }
+    for (; i < len; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const std::uint64_t w = i < xs[j]->len ? xs[j]->words[i] : 0;
+            if (neg[j]) acc -= w;
+            else acc += w;
+        }
+        out[i] = static_cast<std::uint64_t>(acc);
+        acc >>= 64;
+    }
+    if (acc < 0) return BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    // Перенос сложений — не больше n - 1, одно слово
+    if (acc > 0) {
+        if (len == BIGNUM_CAPACITY) return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+        out[len++] = static_cast<std::uint64_t>(acc);
+    }
+
+    while (len > 1 && out[len - 1] == 0) len--;
+    std::memcpy(dst.words, out, sizeof(std::uint64_t) * len);
+    std::memset(dst.words + len, 0, sizeof(std::uint64_t) * (BIGNUM_CAPACITY - len));
+    dst.len = len;
+    return BIGNUM_SUB_SUCCESS;
+}
+
+/** Ошибка присваивания выражения через оператор `=`; код — status(). */
+class sub_error : public std::runtime_error {
+public:
+    explicit sub_error(bignum_sub_status_t st)
+        : std::runtime_error(st == BIGNUM_SUB_ERROR_NEGATIVE_RESULT ? "bn: negative result"
+                                                                    : "bn: capacity exceeded"),
+          status_(st) {}
+    bignum_sub_status_t status() const noexcept { return status_; }
+
+private:
+    bignum_sub_status_t status_;
+};
+
+/** Большое число: bignum_t с операторами выражений. */
+class num {
+public:
+    bignum_t v;
+
+    /** Ноль (len = 1). */
+    num() noexcept : v{} { v.len = 1; }
+    explicit num(const bignum_t &x) noexcept : v(x) {}
+    /** Значение выражения; sub_error при ошибке. */
+    template <expression E>
+    num(const E &e) : v{} { *this = e; }
+
+    /** Присваивание выражения: sub_error при ошибке, значение при этом не меняется. */
+    template <expression E>
+    num &operator=(const E &e) {
+        bignum_sub_status_t st = eval(v, e);
+        if (st != BIGNUM_SUB_SUCCESS) throw sub_error(st);
+        return *this;
+    }
+
+    /** Присваивание без исключений: код возврата, при ошибке значение не меняется. */
+    template <expression E>
+    bignum_sub_status_t assign(const E &e) noexcept { return eval(v, e); }
+
+    template <operand T>
+    num &operator-=(const T &x);
+    template <operand T>
+    num &operator+=(const T &x);
+};
+
+static_assert(sizeof(num) == sizeof(bignum_t) && std::is_standard_layout_v<num>,
+              "bn::num must keep the bignum_t layout");
+
+namespace expr_detail {
+
+template <class T>
+constexpr auto as_expr(const T &x) noexcept {
+    if constexpr (std::same_as<T, num>) return leaf(&x.v);
+    else return x;
+}
+
+} // namespace expr_detail
+
+template <operand A, operand B>
+constexpr auto operator-(const A &a, const B &b) noexcept {
+    using L = decltype(expr_detail::as_expr(a));
+    using R = decltype(expr_detail::as_expr(b));
+    return expr_detail::binary<L, R, true>(expr_detail::as_expr(a), expr_detail::as_expr(b));
+}
+
+template <operand A, operand B>
+constexpr auto operator+(const A &a, const B &b) noexcept {
+    using L = decltype(expr_detail::as_expr(a));
+    using R = decltype(expr_detail::as_expr(b));
+    return expr_detail::binary<L, R, false>(expr_detail::as_expr(a), expr_detail::as_expr(b));
+}
+
+template <operand T>
+num &num::operator-=(const T &x) {
+    return *this = expr_detail::leaf(&v) - x;
+}
+
+template <operand T>
+num &num::operator+=(const T &x) {
+    return *this = expr_detail::leaf(&v) + x;
+}
+
+} // namespace bn
+
+#endif /* BIGNUM_SUB_EXPR_HPP */
@@ -0,0 +1,97 @@
+/**
+ * @file    bignum_sub_field.h
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Вычитание в простых полях P-256, P-384, 2^255 - 19 и secp256k1: r = (a - b) mod p.
+ *
+ * @details
+ *   Ядра из src/bignum_sub_field.asm генерируются макросами из таблицы
+ *   модулей: слова p вшиты в код непосредственными значениями (P-256,
+ *   P-384), модули вида 2^k - c (2^255 - 19, secp256k1) приводятся
+ *   вычитанием `c` по маске заёма. Модуль не читается из памяти, ветвлений
+ *   нет — время не зависит от значений операндов.
+ *
+ *   Элементы поля — числа фиксированной ширины (bn256_t из
+ *   bignum_sub_fixed.h, bn384_t для P-384), слова младшим первым. Операнды
+ *   должны быть приведены (a, b < p), результат приведён. Указатели не
+ *   проверяются на NULL; `r` может совпадать с `a` или `b`.
+ *
+ *   bn_<поле>_from_bignum принимает только значения меньше p (иначе
+ *   BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED), поэтому перевод в обе стороны —
+ *   без потерь. Эти преобразования не предназначены для секретных данных:
+ *   проверка `x < p` выполняется не за постоянное время.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#ifndef BIGNUM_SUB_FIELD_H
+#define BIGNUM_SUB_FIELD_H
+
+#include "bignum_sub_fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BN384_WORDS 6
+
+/** @brief 384-битное беззнаковое число (элемент P-384), слова младшим первым. */
+typedef struct { uint64_t words[BN384_WORDS]; } bn384_t;
+
+/** @brief r = (a - b) mod p, p = 2^256 - 2^224 + 2^192 + 2^96 - 1 (NIST P-256). */
+void bn_p256_sub(bn256_t *r, const bn256_t *a, const bn256_t *b);
+/** @brief r = (a - b) mod p, p = 2^384 - 2^128 - 2^96 + 2^32 - 1 (NIST P-384). */
+void bn_p384_sub(bn384_t *r, const bn384_t *a, const bn384_t *b);
+/** @brief r = (a - b) mod p, p = 2^255 - 19 (Curve25519). */
+void bn_p25519_sub(bn256_t *r, const bn256_t *a, const bn256_t *b);
+/** @brief r = (a - b) mod p, p = 2^256 - 2^32 - 977 (secp256k1). */
+void bn_secp256k1_sub(bn256_t *r, const bn256_t *a, const bn256_t *b);
+
+/**
+ * @brief Слова bignum_t в элемент поля из n слов с модулем p.
+ * @retval BIGNUM_SUB_ERROR_NULL_PTR           Один из указателей NULL.
+ * @retval BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED  x->len > BIGNUM_CAPACITY или x >= p.
+ * @details При ошибке `w` не меняется.
+ */
+static inline bignum_sub_status_t bignum_sub_field_load(uint64_t *w, const uint64_t *p, size_t n,
+                                                        const bignum_t *x) {
+    uint64_t t[BIGNUM_CAPACITY];
+    bignum_sub_status_t st = bignum_sub_fixed_load(w ? t : NULL, n, x);
+    if (st != BIGNUM_SUB_SUCCESS) return st;
+    size_t i = n;
+    while (i > 0 && t[i - 1] == p[i - 1]) i--;
+    if (i == 0 || t[i - 1] > p[i - 1]) return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    memcpy(w, t, sizeof(uint64_t) * n);
+    return BIGNUM_SUB_SUCCESS;
+}
+
+/* bn_<поле>_from_bignum(r, x) и bn_<поле>_to_bignum(x, a); p — слова модуля младшим первым */
+#define BIGNUM_SUB_FIELD_CONVERT(field, type, n, ...)                                          \
+    static inline bignum_sub_status_t bn_##field##_from_bignum(type *r, const bignum_t *x) {   \
+        static const uint64_t p[n] = { __VA_ARGS__ };                                          \
+        return bignum_sub_field_load(r ? r->words : NULL, p, n, x);                            \
+    }                                                                                          \
+    static inline bignum_sub_status_t bn_##field##_to_bignum(bignum_t *x, const type *a) {     \
+        return bignum_sub_fixed_store(x, a ? a->words : NULL, n);                              \
+    }
+
+BIGNUM_SUB_FIELD_CONVERT(p256, bn256_t, BN256_WORDS,
+                         0xFFFFFFFFFFFFFFFFull, 0x00000000FFFFFFFFull, 0x0000000000000000ull, 0xFFFFFFFF00000001ull)
+BIGNUM_SUB_FIELD_CONVERT(p384, bn384_t, BN384_WORDS,
+                         0x00000000FFFFFFFFull, 0xFFFFFFFF00000000ull, 0xFFFFFFFFFFFFFFFEull,
+                         0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull)
+BIGNUM_SUB_FIELD_CONVERT(p25519, bn256_t, BN256_WORDS,
+                         0xFFFFFFFFFFFFFFEDull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0x7FFFFFFFFFFFFFFFull)
+BIGNUM_SUB_FIELD_CONVERT(secp256k1, bn256_t, BN256_WORDS,
+                         0xFFFFFFFEFFFFFC2Full, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull)
+
+#undef BIGNUM_SUB_FIELD_CONVERT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIGNUM_SUB_FIELD_H */
@@ -0,0 +1,134 @@
+/**
+ * @file    bignum_sub_fixed.h
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Числа фиксированной ширины 256/512/1024/2048 бит и ядра вычитания для них.
+ *
+ * @details
+ *   bn256_t, bn512_t, bn1024_t и bn2048_t — массивы слов (младшее первым)
+ *   без поля len: ширина известна при компиляции, поэтому ядрам из
+ *   src/bignum_sub_fixed.asm не нужны проверки длины, цикл, очистка хвоста
+ *   и нормализация. Каждое ядро — прямолинейная цепочка sub/sbb на всю
+ *   ширину; память — только слова операндов и результата.
+ *
+ *   Для каждой ширины N:
+ *   - bnN_sub_mod(r, a, b) — r = (a - b) mod 2^N, возвращает заём (0/1);
+ *   - bnN_borrow(a, b)     — только заём: 1, если a < b;
+ *   - bnN_sub(r, a, b)     — как bignum_sub: BIGNUM_SUB_SUCCESS или
+ *                            BIGNUM_SUB_ERROR_NEGATIVE_RESULT, при a < b
+ *                            `*r` не меняется.
+ *
+ *   bnN_sub_mod и bnN_borrow выполняются за постоянное время. Указатели не
+ *   проверяются на NULL. `r` может совпадать с `a` или `b`; частичное
+ *   перекрытие не допускается.
+ *
+ *   Преобразования bnN_from_bignum / bnN_to_bignum переводят значения без
+ *   потерь: в bignum_t записываются все BIGNUM_CAPACITY слов и нормализуется
+ *   длина, как у bignum_sub.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#ifndef BIGNUM_SUB_FIXED_H
+#define BIGNUM_SUB_FIXED_H
+
+#include <string.h>
+#include "bignum_sub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BN256_WORDS   4
+#define BN512_WORDS   8
+#define BN1024_WORDS  16
+#define BN2048_WORDS  32
+
+#if BN2048_WORDS > BIGNUM_CAPACITY
+#  error "bn2048_t does not fit in bignum_t"
+#endif
+
+/** @brief 256-битное беззнаковое число, слова младшим первым. */
+typedef struct { uint64_t words[BN256_WORDS]; } bn256_t;
+/** @brief 512-битное беззнаковое число. */
+typedef struct { uint64_t words[BN512_WORDS]; } bn512_t;
+/** @brief 1024-битное беззнаковое число. */
+typedef struct { uint64_t words[BN1024_WORDS]; } bn1024_t;
+/** @brief 2048-битное беззнаковое число. */
+typedef struct { uint64_t words[BN2048_WORDS]; } bn2048_t;
+
+/** @brief r = (a - b) mod 2^256. @return Заём из старшего слова (1, если a < b). */
+uint64_t bn256_sub_mod(bn256_t *r, const bn256_t *a, const bn256_t *b);
+/** @brief 1, если a < b; ничего не пишет. */
+uint64_t bn256_borrow(const bn256_t *a, const bn256_t *b);
+/** @brief r = a - b; BIGNUM_SUB_ERROR_NEGATIVE_RESULT при a < b (`*r` не меняется). */
+bignum_sub_status_t bn256_sub(bn256_t *r, const bn256_t *a, const bn256_t *b);
+
+uint64_t bn512_sub_mod(bn512_t *r, const bn512_t *a, const bn512_t *b);
+uint64_t bn512_borrow(const bn512_t *a, const bn512_t *b);
+bignum_sub_status_t bn512_sub(bn512_t *r, const bn512_t *a, const bn512_t *b);
+
+uint64_t bn1024_sub_mod(bn1024_t *r, const bn1024_t *a, const bn1024_t *b);
+uint64_t bn1024_borrow(const bn1024_t *a, const bn1024_t *b);
+bignum_sub_status_t bn1024_sub(bn1024_t *r, const bn1024_t *a, const bn1024_t *b);
+
+uint64_t bn2048_sub_mod(bn2048_t *r, const bn2048_t *a, const bn2048_t *b);
+uint64_t bn2048_borrow(const bn2048_t *a, const bn2048_t *b);
+bignum_sub_status_t bn2048_sub(bn2048_t *r, const bn2048_t *a, const bn2048_t *b);
+
+/**
+ * @brief Слова bignum_t в массив из n слов.
+ * @retval BIGNUM_SUB_ERROR_NULL_PTR           Один из указателей NULL.
+ * @retval BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED  x->len > BIGNUM_CAPACITY или значение не помещается в n слов.
+ * @details len = 0 — ноль. При ошибке `w` не меняется.
+ */
+static inline bignum_sub_status_t bignum_sub_fixed_load(uint64_t *w, size_t n, const bignum_t *x) {
+    if (!w || !x) return BIGNUM_SUB_ERROR_NULL_PTR;
+    if (x->len > BIGNUM_CAPACITY) return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    size_t len = x->len < n ? x->len : n;
+    for (size_t i = n; i < x->len; ++i) {
+        if (x->words[i] != 0) return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    }
+    memcpy(w, x->words, sizeof(uint64_t) * len);
+    memset(w + len, 0, sizeof(uint64_t) * (n - len));
+    return BIGNUM_SUB_SUCCESS;
+}
+
+/**
+ * @brief Массив из n слов в bignum_t: все BIGNUM_CAPACITY слов, нормализованная длина (ноль — len = 1).
+ * @retval BIGNUM_SUB_ERROR_NULL_PTR Один из указателей NULL.
+ */
+static inline bignum_sub_status_t bignum_sub_fixed_store(bignum_t *x, const uint64_t *w, size_t n) {
+    if (!x || !w) return BIGNUM_SUB_ERROR_NULL_PTR;
+    size_t len = n;
+    while (len > 1 && w[len - 1] == 0) len--;
+    memcpy(x->words, w, sizeof(uint64_t) * n);
+    memset(x->words + n, 0, sizeof(uint64_t) * (BIGNUM_CAPACITY - n));
+    x->len = len;
+    return BIGNUM_SUB_SUCCESS;
+}
+
+/* bnN_from_bignum(r, x) и bnN_to_bignum(x, a) для каждой ширины */
+#define BIGNUM_SUB_FIXED_CONVERT(bits)                                                         \
+    static inline bignum_sub_status_t bn##bits##_from_bignum(bn##bits##_t *r, const bignum_t *x) { \
+        return bignum_sub_fixed_load(r ? r->words : NULL, BN##bits##_WORDS, x);                \
+    }                                                                                          \
+    static inline bignum_sub_status_t bn##bits##_to_bignum(bignum_t *x, const bn##bits##_t *a) {   \
+        return bignum_sub_fixed_store(x, a ? a->words : NULL, BN##bits##_WORDS);               \
+    }
+
+BIGNUM_SUB_FIXED_CONVERT(256)
+BIGNUM_SUB_FIXED_CONVERT(512)
+BIGNUM_SUB_FIXED_CONVERT(1024)
+BIGNUM_SUB_FIXED_CONVERT(2048)
+
+#undef BIGNUM_SUB_FIXED_CONVERT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIGNUM_SUB_FIXED_H */
@@ -0,0 +1,117 @@
+/**
+ * @file    bignum_sub_flight.h
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Бортовой самописец (opt-in): последние вызовы bignum_sub каждого потока в памяти.
+ *
+ * @details
+ *   Как трассировка и статистика, подключается сборкой приложения с
+ *   обёрткой `-Wl,--wrap=bignum_sub` и библиотекой инструментирования.
+ *   Включается вызовом bignum_sub_flight_start() или переменной окружения
+ *   `BIGNUM_SUB_FLIGHT=1` при старте процесса; переменная дополнительно
+ *   устанавливает обработчик аварийных сигналов, печатающий кольца в stderr.
+ *
+ *   ### Кольца
+ *   У каждого потока своё кольцо из BIGNUM_SUB_FLIGHT_DEPTH записей по
+ *   одной кэш-линии. Запись вызова — заполнение очередной записи и
+ *   release-запись счётчика головы; блокировок и атомарных
+ *   read-modify-write нет. Хэш операндов считается за один проход по
+ *   словам a и b (bignum_sub_flight_hash()). Кольцо завершившегося потока
+ *   сохраняет записи до того, как его займёт следующий поток.
+ *
+ *   ### Чтение
+ *   bignum_sub_flight_snapshot() копирует записи всех колец в массив и
+ *   отбрасывает записи, которые мог перезаписать работающий поток.
+ *   bignum_sub_flight_dump() печатает кольца текстом в дескриптор и
+ *   безопасна в обработчике сигнала: не выделяет память и использует только
+ *   write(2). В core-файле кольца доступны отладчику из списка колец
+ *   `flight_rings` (src/bignum_sub_flight.c).
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+#ifndef BIGNUM_SUB_FLIGHT_H
+#define BIGNUM_SUB_FLIGHT_H
+
+#include <bignum.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "bignum_sub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Записей в кольце потока (степень двойки; задаётся при сборке библиотеки). */
+#ifndef BIGNUM_SUB_FLIGHT_DEPTH
+#  define BIGNUM_SUB_FLIGHT_DEPTH 256
+#endif
+
+/** Запись об одном вызове (64 байта). */
+typedef struct {
+    uint64_t        seq;       /** Номер записи в кольце. **/
+    uint64_t        tsc;       /** TSC после возврата из bignum_sub. **/
+    const bignum_t *result;    /** Аргументы вызова как есть. **/
+    const bignum_t *a;
+    const bignum_t *b;
+    uint64_t        hash;      /** bignum_sub_flight_hash(a, b). **/
+    int32_t         tid;       /** Поток-владелец кольца. **/
+    uint32_t        len_a;     /** a->len (насыщение на UINT32_MAX; 0 при a == NULL). **/
+    uint32_t        len_b;     /** b->len (так же). **/
+    int32_t         status;    /** Код возврата bignum_sub. **/
+} bignum_sub_flight_rec_t;
+
+/**
+ * @brief Начинает запись.
+ * @return 0 при успехе, -1 если запись уже идёт.
+ */
+int bignum_sub_flight_start(void);
+
+/**
+ * @brief Прекращает запись; кольца и записи сохраняются для чтения.
+ * @return 0 при успехе, -1 если запись не шла.
+ */
+int bignum_sub_flight_stop(void);
+
+/** @brief Записывает один вызов; вызывается обёрткой `__wrap_bignum_sub`. */
+void bignum_sub_flight_hook(const bignum_t *result, const bignum_t *a, const bignum_t *b,
+                            bignum_sub_status_t status);
+
+/**
+ * @brief Хэш операндов, который пишется в запись.
+ * @details Fletcher-64 по словам a и b (до min(len, BIGNUM_CAPACITY)) и
+ *          длинам, затем перемешивание; 0 при a == NULL или b == NULL.
+ *          Позволяет сопоставить запись с операндами, сохранёнными
+ *          приложением.
+ */
+uint64_t bignum_sub_flight_hash(const bignum_t *a, const bignum_t *b);
+
+/**
+ * @brief Копирует записи всех колец.
+ * @details Записи одного кольца идут от старой к новой, кольца — подряд.
+ *          Для общего порядка записи можно отсортировать по tsc.
+ * @return Число скопированных записей (не больше max).
+ */
+size_t bignum_sub_flight_snapshot(bignum_sub_flight_rec_t *out, size_t max);
+
+/**
+ * @brief Печатает все кольца текстом в дескриптор `fd`.
+ * @details Async-signal-safe: без блокировок, malloc и stdio.
+ * @return 0 при успехе, -1 при ошибке write(2).
+ */
+int bignum_sub_flight_dump(int fd);
+
+/**
+ * @brief Устанавливает обработчик SIGSEGV, SIGBUS, SIGILL, SIGFPE и SIGABRT,
+ *        который печатает кольца в `fd` и передаёт сигнал прежнему обработчику.
+ * @return 0 при успехе, -1 при ошибке sigaction.
+ */
+int bignum_sub_flight_install_crash_handler(int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIGNUM_SUB_FLIGHT_H */
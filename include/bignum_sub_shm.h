@@ -0,0 +1,160 @@
+/**
+ * @file    bignum_sub_shm.h
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Межпроцессный сервис bignum_sub: демон и клиенты с общим кольцом в memfd.
+ *
+ * @details
+ *   Несколько процессов одной машины отдают вычитания одному демону
+ *   (tools/bignum_sub_shmd.c, `bin/bignum-sub-shmd`) вместо того, чтобы
+ *   каждый держал свою копию и конкурировал за ядра. Модуль входит в
+ *   библиотеку инструментирования (build/libbignum_sub_instr.a).
+ *
+ *   ### Память
+ *   Клиент создаёт memfd с кольцом заявок и ареной bignum_t, запечатывает
+ *   его размер (F_SEAL_SHRINK, F_SEAL_GROW) и передаёт дескриптор демону
+ *   через Unix-сокет (SCM_RIGHTS). Операнды и результаты лежат в арене
+ *   (bignum_sub_shm_arena()): заявка — три индекса слотов, данные не
+ *   сериализуются. Демон проверяет каждый индекс слота; неверный
+ *   выполняется как NULL (BIGNUM_SUB_ERROR_NULL_PTR).
+ *
+ *   ### Доверие
+ *   Демон и клиенты — процессы одного пользователя. Сокет создаётся с
+ *   правами 0600, и обе стороны проверяют собеседника через SO_PEERCRED:
+ *   подключение другого пользователя отклоняется (errno EPERM у клиента).
+ *   Арену клиент может менять в любой момент, поэтому демон копирует
+ *   операнды в свою память до проверок и вычисления, а результат — обратно
+ *   в слот только при успехе; гонка с записью в арену портит лишь данные
+ *   этого клиента. Клиент, не приславший memfd за секунду, отключается и
+ *   не задерживает приём остальных.
+ *
+ *   ### Выполнение
+ *   Демон закрепляет рабочие потоки за заданными CPU и раздаёт клиентов
+ *   по кругу; рабочий поток обходит кольца своих клиентов и выполняет
+ *   готовые заявки пакетами через bignum_sub. Ожидание с обеих сторон —
+ *   опрос, затем futex на общей памяти: клиент будит рабочий поток через
+ *   страницу "звонков" демона (второй memfd, передаётся в ответе), демон
+ *   будит клиента через счётчик завершений в его memfd. Системный вызов
+ *   делается, только если другая сторона спит.
+ *
+ *   Клиентское соединение однопоточное: каждый поток приложения открывает
+ *   своё. Отключение — закрытие сокета (в том числе при завершении
+ *   процесса); демон освобождает отображение, когда рабочий поток
+ *   закончил с кольцом. Если демон завершился, ожидание возвращает
+ *   BIGNUM_SUB_SHM_DISCONNECTED.
+ *
+ * @note    Для сборки требуется флаг `-pthread`. Только Linux (memfd, futex).
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Операнды копируются из арены, сокет 0600 и SO_PEERCRED, неблокирующее рукопожатие.
+ */
+#ifndef BIGNUM_SUB_SHM_H
+#define BIGNUM_SUB_SHM_H
+
+#include <bignum.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bignum_sub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Сокет демона по умолчанию (права 0600, только пользователь демона). */
+#define BIGNUM_SUB_SHM_SOCKET "/tmp/bignum_sub_shmd.sock"
+/** Заявок в кольце клиента (степень двойки). */
+#define BIGNUM_SUB_SHM_RING 256
+/** Пределы демона. */
+#define BIGNUM_SUB_SHM_MAX_WORKERS 64
+#define BIGNUM_SUB_SHM_MAX_CLIENTS 1024
+#define BIGNUM_SUB_SHM_MAX_BATCH   256
+#define BIGNUM_SUB_SHM_MAX_SLOTS   (1u << 20)
+/** Код ожидания: демон закрыл соединение, заявка не выполнена. */
+#define BIGNUM_SUB_SHM_DISCONNECTED (-100)
+
+/* --- Клиент --- */
+
+typedef struct bignum_sub_shm_client bignum_sub_shm_client_t;
+
+/**
+ * @brief Создаёт общую память на `arena_slots` чисел (до BIGNUM_SUB_SHM_MAX_SLOTS) и подключается к демону.
+ * @param path Сокет демона или NULL — BIGNUM_SUB_SHM_SOCKET.
+ * @return Соединение или NULL при ошибке (errno).
+ */
+bignum_sub_shm_client_t *bignum_sub_shm_connect(const char *path, size_t arena_slots);
+
+/** @brief Закрывает соединение; незавершённые заявки теряются. */
+void bignum_sub_shm_disconnect(bignum_sub_shm_client_t *c);
+
+/** @brief Арена общих чисел: операнды и результаты заявок. @param count Число слотов (может быть NULL). */
+bignum_t *bignum_sub_shm_arena(bignum_sub_shm_client_t *c, size_t *count);
+
+/**
+ * @brief Ставит заявку `bignum_sub(result, a, b)`, не блокируясь.
+ * @details Указатели — слоты арены соединения или NULL.
+ * @return Номер заявки (>= 0) или -1: errno EAGAIN — кольцо заполнено
+ *         (BIGNUM_SUB_SHM_RING незавершённых заявок), EINVAL — указатель вне арены.
+ */
+int64_t bignum_sub_shm_submit(bignum_sub_shm_client_t *c, bignum_t *result, const bignum_t *a,
+                              const bignum_t *b);
+
+/** @brief 1, если заявка `ticket` завершена, иначе 0. */
+int bignum_sub_shm_poll(bignum_sub_shm_client_t *c, int64_t ticket);
+
+/**
+ * @brief Ждёт заявку `ticket`: `spin` опросов, затем сон на futex.
+ * @details Заявки завершаются по порядку постановки; результат заявки
+ *          читается до постановки BIGNUM_SUB_SHM_RING следующих.
+ * @return Код возврата bignum_sub или BIGNUM_SUB_SHM_DISCONNECTED.
+ */
+int bignum_sub_shm_wait(bignum_sub_shm_client_t *c, int64_t ticket, unsigned spin);
+
+/**
+ * @brief Синхронный вызов через демон: submit + wait.
+ * @return Код возврата bignum_sub, BIGNUM_SUB_SHM_DISCONNECTED или -1 от
+ *         bignum_sub_shm_submit() (errno EAGAIN/EINVAL).
+ */
+int bignum_sub_shm_call(bignum_sub_shm_client_t *c, bignum_t *result, const bignum_t *a, const bignum_t *b);
+
+/* --- Демон --- */
+
+typedef struct bignum_sub_shm_server bignum_sub_shm_server_t;
+
+/** Параметры демона; нулевое поле — значение по умолчанию. */
+typedef struct {
+    const char *path;      /** Сокет (NULL — BIGNUM_SUB_SHM_SOCKET); существующий файл заменяется. **/
+    unsigned    workers;   /** Рабочих потоков (0 — 1). **/
+    const int  *cpus;      /** CPU рабочих потоков (workers штук) или NULL — без закрепления. **/
+    unsigned    batch;     /** Наибольший пакет с одного кольца (0 — 64). **/
+    unsigned    spin;      /** Холостых обходов перед сном (0 — 4096). **/
+} bignum_sub_shm_server_config_t;
+
+/**
+ * @brief Создаёт сокет и запускает поток приёма соединений и рабочие потоки.
+ * @return Демон или NULL при ошибке (errno).
+ */
+bignum_sub_shm_server_t *bignum_sub_shm_server_start(const bignum_sub_shm_server_config_t *cfg);
+
+/** @brief Останавливает потоки, отключает клиентов и удаляет сокет. */
+void bignum_sub_shm_server_stop(bignum_sub_shm_server_t *srv);
+
+/** Счётчики демона. */
+typedef struct {
+    uint64_t clients;   /** Подключений за всё время. **/
+    uint64_t calls;     /** Выполненные заявки. **/
+    uint64_t batches;   /** Непустые пакеты. **/
+    uint64_t sleeps;    /** Засыпания рабочих потоков. **/
+} bignum_sub_shm_server_counters_t;
+
+/** @brief Снимок счётчиков (во время работы — приблизительный). */
+void bignum_sub_shm_server_counters(const bignum_sub_shm_server_t *srv,
+                                    bignum_sub_shm_server_counters_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIGNUM_SUB_SHM_H */
@@ -0,0 +1,126 @@
+/**
+ * @file    bignum_sub_stat.h
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Счётчики вызовов bignum_sub по потокам (opt-in) в разделяемой памяти и их чтение извне.
+ *
+ * @details
+ *   Как и трассировка (bignum_sub_trace.h), статистика подключается только
+ *   при сборке приложения с обёрткой `-Wl,--wrap=bignum_sub` и библиотекой
+ *   инструментирования. Вызов хука дополнительно отключается при сборке
+ *   библиотеки: `make STATS=0` определяет BIGNUM_SUB_STATS=0, и обёртка
+ *   его не вызывает, а bignum_sub_stat_start() возвращает -1.
+ *
+ *   Публикация включается вызовом bignum_sub_stat_start() или переменной
+ *   окружения `BIGNUM_SUB_STAT=1` при старте процесса. Тогда создаётся
+ *   POSIX-сегмент разделяемой памяти `/bignum_sub_stat.<pid>` с правами
+ *   0600 (только пользователь процесса: гистограммы длин и заёмов выдают
+ *   сведения об операндах), который читает утилита `bignum-sub-stat <pid>` (tools/bignum_sub_stat.c) или
+ *   любой процесс через bignum_sub_stat_open().
+ *
+ *   ### Счётчики
+ *   Для каждого потока: число вызовов, число вызовов по каждому коду
+ *   возврата, гистограмма a->len (0..32 и "больше 32") и гистограмма
+ *   наибольшей цепочки заимствования в словах (0..32, только успешные
+ *   вызовы; считается проходом по операндам после вызова).
+ *
+ *   ### Потоки
+ *   Поток при первом вызове захватывает собственный слот сегмента
+ *   (выравнивание по 64 байта, слоты не делят кэш-линий) и далее пишет
+ *   в него без блокировок и без атомарных read-modify-write: у каждого
+ *   счётчика один писатель, а 64-битные выровненные записи читаются
+ *   без разрывов. Снимок, сделанный во время работы, может быть
+ *   несогласован между счётчиками на несколько вызовов. Слот
+ *   завершившегося потока сохраняет счёт и переиспользуется следующим
+ *   потоком. Если слотов не хватило, вызовы потока не считаются.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Права сегмента 0600.
+ */
+#ifndef BIGNUM_SUB_STAT_H
+#define BIGNUM_SUB_STAT_H
+
+#include <bignum.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "bignum_sub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Подсчёт вкомпилирован в библиотеку инструментирования (make STATS=0 — нет). */
+#ifndef BIGNUM_SUB_STATS
+#  define BIGNUM_SUB_STATS 1
+#endif
+
+/** Число кодов возврата: индекс счётчика — `-status`. */
+#define BIGNUM_SUB_STAT_STATUSES 5
+/** Корзины a->len: 0..BIGNUM_CAPACITY и последняя — "больше". */
+#define BIGNUM_SUB_STAT_LEN_BINS (BIGNUM_CAPACITY + 2)
+/** Корзины длины цепочки заимствования: 0..BIGNUM_CAPACITY. */
+#define BIGNUM_SUB_STAT_BORROW_BINS (BIGNUM_CAPACITY + 1)
+/** Наибольшее число потоков со своим слотом. */
+#define BIGNUM_SUB_STAT_MAX_THREADS 256
+
+/** Счётчики одного потока или сумма по потокам. */
+typedef struct {
+    uint64_t calls;                                  /** Все вызовы. **/
+    uint64_t status[BIGNUM_SUB_STAT_STATUSES];       /** По коду возврата, индекс -status. **/
+    uint64_t len[BIGNUM_SUB_STAT_LEN_BINS];          /** По a->len (a != NULL). **/
+    uint64_t borrow[BIGNUM_SUB_STAT_BORROW_BINS];    /** По длине цепочки заимствования. **/
+} bignum_sub_stat_counts_t;
+
+/**
+ * @brief Создаёт сегмент `/bignum_sub_stat.<pid>` и начинает публикацию.
+ * @return 0 при успехе, -1 при ошибке (errno), повторном старте или
+ *         если статистика отключена при сборке (BIGNUM_SUB_STATS=0).
+ */
+int bignum_sub_stat_start(void);
+
+/**
+ * @brief Прекращает подсчёт и удаляет имя сегмента.
+ * @details Отображение остаётся (потоки могут быть внутри хука), уже
+ *          открытые читатели продолжают видеть последние значения.
+ * @return 0 при успехе, -1 если публикация не шла.
+ */
+int bignum_sub_stat_stop(void);
+
+/** @brief Учитывает один вызов; вызывается обёрткой `__wrap_bignum_sub`. */
+void bignum_sub_stat_hook(const bignum_t *a, const bignum_t *b, bignum_sub_status_t status);
+
+/** Открытый сегмент другого (или своего) процесса. */
+typedef struct {
+    const void *map;
+    size_t      size;
+} bignum_sub_stat_reader_t;
+
+/**
+ * @brief Открывает сегмент процесса `pid` только для чтения.
+ * @return 0 при успехе, -1 если сегмента нет или формат несовместим.
+ */
+int bignum_sub_stat_open(bignum_sub_stat_reader_t *rd, pid_t pid);
+
+/**
+ * @brief Снимок счётчиков.
+ * @param total       Сумма по всем слотам (может быть NULL).
+ * @param per_thread  Счётчики занятых слотов (может быть NULL).
+ * @param tids        Идентификаторы потоков последних владельцев (может быть NULL).
+ * @param max_threads Ёмкость per_thread и tids.
+ * @return Число занятых слотов (может превышать max_threads).
+ */
+unsigned bignum_sub_stat_read(const bignum_sub_stat_reader_t *rd, bignum_sub_stat_counts_t *total,
+                              bignum_sub_stat_counts_t *per_thread, pid_t *tids,
+                              unsigned max_threads);
+
+/** @brief Закрывает сегмент. */
+void bignum_sub_stat_close(bignum_sub_stat_reader_t *rd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIGNUM_SUB_STAT_H */
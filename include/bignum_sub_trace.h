@@ -0,0 +1,146 @@
+/**
+ * @file    bignum_sub_trace.h
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Захват трассы вызовов bignum_sub (opt-in) и чтение трассы для replay-бенчмарка.
+ *
+ * @details
+ *   Захват подключается только при сборке приложения с обёрткой:
+ *
+ *       gcc app.c -Wl,--wrap=bignum_sub -lbignum_sub_instr bignum_sub.o bignum_cmp.o -pthread
+ *
+ *   Тогда вызовы `bignum_sub` проходят через `__wrap_bignum_sub`
+ *   (src/bignum_sub_wrap.c), которая после настоящего вызова передаёт
+ *   аргументы и код возврата в bignum_sub_trace_hook(). Без `--wrap` код
+ *   библиотеки и его производительность не меняются.
+ *
+ *   Запись включается вызовом bignum_sub_trace_start() или переменными
+ *   окружения при старте процесса:
+ *   - `BIGNUM_SUB_TRACE=<path>`   — файл трассы;
+ *   - `BIGNUM_SUB_TRACE_SHAPES=1` — писать только формы (без слов операндов).
+ *   Инструменты, которые сами читают или пишут трассы (replay, worst),
+ *   отключают автозапуск, определяя bignum_sub_trace_no_autostart.
+ *
+ *   ### Формат файла
+ *   Заголовок bignum_sub_trace_header_t, затем записи подряд: 4 байта
+ *   bignum_sub_trace_rec_t и, если установлен флаг
+ *   BIGNUM_SUB_TRACE_REC_OPERANDS, слова a и b (min(len, BIGNUM_CAPACITY)
+ *   слов каждого, little-endian). Длины больше 255 сохраняются как 255,
+ *   что по-прежнему превышает BIGNUM_CAPACITY.
+ *
+ *   ### Потоки
+ *   Каждый поток пишет в свой буфер без блокировок; заполненный буфер
+ *   сбрасывается одним write(2) в файл, открытый с O_APPEND, поэтому записи
+ *   разных потоков не перемешиваются внутри блока, но порядок между
+ *   потоками не сохраняется. Буфер завершившегося потока сбрасывается и
+ *   переиспользуется следующим потоком. bignum_sub_trace_stop() сбрасывает
+ *   все буферы и должна вызываться, когда другие потоки не находятся
+ *   внутри bignum_sub.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Отключение автозапуска: bignum_sub_trace_no_autostart.
+ */
+#ifndef BIGNUM_SUB_TRACE_H
+#define BIGNUM_SUB_TRACE_H
+
+#include <bignum.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "bignum_sub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Сигнатура файла трассы. */
+#define BIGNUM_SUB_TRACE_MAGIC "BNSUBTR1"
+/** Версия формата. */
+#define BIGNUM_SUB_TRACE_VERSION 1u
+
+/** Флаги bignum_sub_trace_start(). */
+#define BIGNUM_SUB_TRACE_SHAPES_ONLY 1u   /** Не записывать слова операндов. **/
+
+/** Флаги записи. */
+enum {
+    BIGNUM_SUB_TRACE_REC_OPERANDS = 1u << 0,  /** За записью следуют слова a и b. **/
+    BIGNUM_SUB_TRACE_REC_NULL_R   = 1u << 1,  /** result == NULL. **/
+    BIGNUM_SUB_TRACE_REC_NULL_A   = 1u << 2,  /** a == NULL. **/
+    BIGNUM_SUB_TRACE_REC_NULL_B   = 1u << 3,  /** b == NULL. **/
+    BIGNUM_SUB_TRACE_REC_ALIAS_A  = 1u << 4,  /** result == a. **/
+    BIGNUM_SUB_TRACE_REC_ALIAS_B  = 1u << 5   /** result == b. **/
+};
+
+/** Заголовок файла трассы (24 байта). */
+typedef struct {
+    char     magic[8];     /** BIGNUM_SUB_TRACE_MAGIC без завершающего нуля. **/
+    uint32_t version;      /** BIGNUM_SUB_TRACE_VERSION. **/
+    uint32_t flags;        /** Флаги bignum_sub_trace_start(). **/
+    uint32_t capacity;     /** BIGNUM_CAPACITY процесса, записавшего трассу. **/
+    uint32_t word_size;    /** sizeof(uint64_t). **/
+} bignum_sub_trace_header_t;
+
+/** Запись об одном вызове (4 байта). */
+typedef struct {
+    uint8_t len_a;         /** a->len (насыщение на 255). **/
+    uint8_t len_b;         /** b->len (насыщение на 255). **/
+    int8_t  status;        /** Код возврата bignum_sub. **/
+    uint8_t flags;         /** BIGNUM_SUB_TRACE_REC_*. **/
+} bignum_sub_trace_rec_t;
+
+/**
+ * @brief Отключение автозапуска по BIGNUM_SUB_TRACE.
+ * @details В библиотеке символ слабый и не определён; программа, которая
+ *          определяет его ненулевым (`const int bignum_sub_trace_no_autostart = 1;`),
+ *          не начинает запись при старте.
+ */
+extern const int bignum_sub_trace_no_autostart;
+
+/**
+ * @brief Начинает запись трассы в файл `path` (файл перезаписывается).
+ * @param flags BIGNUM_SUB_TRACE_SHAPES_ONLY или 0.
+ * @return 0 при успехе, -1 при ошибке (errno) или если запись уже идёт.
+ */
+int bignum_sub_trace_start(const char *path, unsigned flags);
+
+/**
+ * @brief Останавливает запись: сбрасывает буферы всех потоков и закрывает файл.
+ * @return 0 при успехе, -1 если запись не шла или сброс не удался.
+ */
+int bignum_sub_trace_stop(void);
+
+/** @brief Записывает один вызов; вызывается обёрткой `__wrap_bignum_sub`. */
+void bignum_sub_trace_hook(const bignum_t *result, const bignum_t *a, const bignum_t *b,
+                           bignum_sub_status_t status);
+
+/** Состояние чтения трассы. */
+typedef struct {
+    FILE                     *f;
+    bignum_sub_trace_header_t hdr;
+} bignum_sub_trace_reader_t;
+
+/**
+ * @brief Открывает трассу и проверяет заголовок.
+ * @return 0 при успехе, -1 при ошибке открытия или несовместимом формате.
+ */
+int bignum_sub_trace_open(bignum_sub_trace_reader_t *rd, const char *path);
+
+/**
+ * @brief Читает следующую запись.
+ * @details `a` и `b` обнуляются; len берётся из записи, слова — если в
+ *          записи есть операнды.
+ * @return 1 — запись прочитана, 0 — конец трассы, -1 — повреждённая трасса.
+ */
+int bignum_sub_trace_next(bignum_sub_trace_reader_t *rd, bignum_sub_trace_rec_t *rec,
+                          bignum_t *a, bignum_t *b);
+
+/** @brief Закрывает трассу. */
+void bignum_sub_trace_close(bignum_sub_trace_reader_t *rd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIGNUM_SUB_TRACE_H */
@@ -0,0 +1,311 @@
+/**
+ * @file    bignum_sub_async.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Кольца заявок bignum_sub и рабочие потоки, выполняющие их пакетами.
+ *
+ * @details
+ *   Кольцо — ограниченная очередь с номерами последовательности в каждой
+ *   записи: запись с позицией pos свободна для производителя при
+ *   seq == pos, готова для потребителя при seq == pos + 1 и снова
+ *   освобождается записью seq = pos + size. Записи выровнены по кэш-линии,
+ *   поэтому соседние производители не делят строк. Хвост — общий счётчик
+ *   производителей (CAS), голова принадлежит рабочему потоку.
+ *
+ *   Рабочий поток собирает пакет из подряд готовых записей, выполняет все
+ *   вызовы ядра подряд, затем освобождает записи и сообщает о завершении.
+ *   Сон рабочего потока и ожидающих — futex с флагом "спит": сторона,
+ *   публикующая данные, делает системный вызов только если флаг поднят;
+ *   порядок "запись данных — барьер — чтение флага" у одной стороны и
+ *   "запись флага — барьер — чтение данных" у другой исключает потерю
+ *   пробуждения.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#define _GNU_SOURCE
+#include "bignum_sub_async.h"
+#include <errno.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+enum { DONE_PENDING = 0, DONE_READY = 1, DONE_SLEEPING = 2 };
+
+typedef struct {
+    _Alignas(64) atomic_size_t seq;
+    bignum_t                *result;
+    const bignum_t          *a;
+    const bignum_t          *b;
+    bignum_sub_completion_t *c;
+} async_slot_t;
+
+typedef struct {
+    _Alignas(64) atomic_size_t tail;     // производители
+    _Alignas(64) atomic_uint   sleeping; // рабочий поток спит на futex
+    _Alignas(64) size_t        head;     // только рабочий поток
+    _Atomic uint64_t calls, batches, sleeps, wakeups;
+    async_slot_t *slots;
+    size_t        mask;
+    pthread_t     thread;
+    int           cpu;
+    struct bignum_sub_async *svc;
+} async_ring_t;
+
+struct bignum_sub_async {
+    async_ring_t *rings;
+    unsigned      workers;
+    unsigned      batch;
+    unsigned      spin;
+    atomic_int    stop;
+    atomic_uint   next_ring;
+};
+
+static _Thread_local unsigned async_ring_hint;
+static _Thread_local int      async_ring_set;
+
+static void futex_wait(void *addr, uint32_t val) {
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static void futex_wake(void *addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static inline void cpu_relax(void) {
+    __builtin_ia32_pause();
+}
+
+/** Единственный писатель: обычная загрузка и запись, без lock-префикса. */
+static inline void ring_count(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static inline int slot_ready(const async_ring_t *r, size_t pos) {
+    return atomic_load_explicit(&r->slots[pos & r->mask].seq, memory_order_acquire) == pos + 1;
+}
+
+static void complete(async_ring_t *r, bignum_sub_completion_t *c, bignum_sub_status_t st) {
+    c->status = st;
+    if (c->notify) {
+        c->notify(c);
+        return;
+    }
+    // После записи флага ожидающий может освободить c: дальше только адрес для futex
+    uint32_t old = __atomic_exchange_n(&c->state, DONE_READY, __ATOMIC_ACQ_REL);
+    if (old == DONE_SLEEPING) {
+        futex_wake(&c->state);
+        ring_count(&r->wakeups, 1);
+    }
+}
+
+/** Ждёт готовности записи с позицией head: опрос, затем сон. @return 0 — остановка. */
+static int worker_idle(async_ring_t *r) {
+    struct bignum_sub_async *svc = r->svc;
+    for (unsigned i = 0; i < svc->spin; ++i) {
+        if (slot_ready(r, r->head)) return 1;
+        cpu_relax();
+    }
+    atomic_store(&r->sleeping, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!slot_ready(r, r->head)) {
+        if (atomic_load(&svc->stop)) return 0;
+        ring_count(&r->sleeps, 1);
+        futex_wait(&r->sleeping, 1);
+    }
+    atomic_store(&r->sleeping, 0);
+    return 1;
+}
+
+static void *worker_main(void *arg) {
+    async_ring_t *r = arg;
+    const unsigned batch = r->svc->batch;
+    bignum_sub_status_t st[BIGNUM_SUB_ASYNC_MAX_BATCH];
+    async_slot_t *s[BIGNUM_SUB_ASYNC_MAX_BATCH];
+
+    for (;;) {
+        size_t n = 0;
+        while (n < batch && slot_ready(r, r->head + n)) {
+            s[n] = &r->slots[(r->head + n) & r->mask];
+            n++;
+        }
+        if (n == 0) {
+            if (!worker_idle(r)) break;
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) st[i] = bignum_sub(s[i]->result, s[i]->a, s[i]->b);
+        // Счётчики до завершений: дождавшийся заявки видит её в bignum_sub_async_counters()
+        ring_count(&r->calls, n);
+        ring_count(&r->batches, 1);
+        for (size_t i = 0; i < n; ++i) {
+            bignum_sub_completion_t *c = s[i]->c;
+            atomic_store_explicit(&s[i]->seq, r->head + i + r->mask + 1, memory_order_release);
+            complete(r, c, st[i]);
+        }
+        r->head += n;
+    }
+    return NULL;
+}
+
+/** Занимает позицию в кольце и публикует заявку. @return 0 — кольцо заполнено. */
+static int ring_push(async_ring_t *r, bignum_t *result, const bignum_t *a, const bignum_t *b,
+                     bignum_sub_completion_t *c) {
+    size_t pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    async_slot_t *slot;
+    for (;;) {
+        slot = &r->slots[pos & r->mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        }
+    }
+    slot->result = result;
+    slot->a = a;
+    slot->b = b;
+    slot->c = c;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&r->sleeping, memory_order_relaxed) &&
+        atomic_exchange(&r->sleeping, 0) == 1) {
+        futex_wake(&r->sleeping);
+    }
+    return 1;
+}
+
+bignum_sub_async_t *bignum_sub_async_create(const bignum_sub_async_config_t *cfg) {
+    bignum_sub_async_config_t def;
+    memset(&def, 0, sizeof(def));
+    if (!cfg) cfg = &def;
+    unsigned workers = cfg->workers ? cfg->workers : 1;
+    size_t ring_size = cfg->ring_size ? cfg->ring_size : BIGNUM_SUB_ASYNC_RING_SIZE;
+    unsigned batch = cfg->batch ? cfg->batch : BIGNUM_SUB_ASYNC_BATCH;
+    if (workers > BIGNUM_SUB_ASYNC_MAX_WORKERS || (ring_size & (ring_size - 1)) != 0 ||
+        batch > BIGNUM_SUB_ASYNC_MAX_BATCH) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    struct bignum_sub_async *svc = calloc(1, sizeof(*svc));
+    async_ring_t *rings = svc ? aligned_alloc(64, workers * sizeof(async_ring_t)) : NULL;
+    if (!rings) {
+        free(svc);
+        errno = ENOMEM;
+        return NULL;
+    }
+    memset(rings, 0, workers * sizeof(async_ring_t));
+    svc->rings = rings;
+    svc->batch = batch;
+    svc->spin = cfg->spin ? cfg->spin : BIGNUM_SUB_ASYNC_SPIN;
+
+    for (unsigned w = 0; w < workers; ++w) {
+        async_ring_t *r = &rings[w];
+        r->slots = aligned_alloc(64, ring_size * sizeof(async_slot_t));
+        if (!r->slots) {
+            errno = ENOMEM;
+            break;
+        }
+        for (size_t i = 0; i < ring_size; ++i) atomic_init(&r->slots[i].seq, i);
+        r->mask = ring_size - 1;
+        r->svc = svc;
+        r->cpu = cfg->cpus ? cfg->cpus[w] : -1;
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (r->cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(r->cpu, &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+        int rc = pthread_create(&r->thread, &attr, worker_main, r);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            free(r->slots);
+            errno = rc;
+            break;
+        }
+        svc->workers = w + 1;
+    }
+    if (svc->workers != workers) {
+        int err = errno;
+        bignum_sub_async_destroy(svc);
+        errno = err;
+        return NULL;
+    }
+    return svc;
+}
+
+void bignum_sub_async_destroy(bignum_sub_async_t *svc) {
+    if (!svc) return;
+    atomic_store(&svc->stop, 1);
+    for (unsigned w = 0; w < svc->workers; ++w) {
+        async_ring_t *r = &svc->rings[w];
+        if (atomic_exchange(&r->sleeping, 0) == 1) futex_wake(&r->sleeping);
+        pthread_join(r->thread, NULL);
+        free(r->slots);
+    }
+    free(svc->rings);
+    free(svc);
+}
+
+int bignum_sub_async_submit(bignum_sub_async_t *svc, bignum_t *result, const bignum_t *a,
+                            const bignum_t *b, bignum_sub_completion_t *c) {
+    if (!async_ring_set) {
+        async_ring_hint = atomic_fetch_add_explicit(&svc->next_ring, 1, memory_order_relaxed);
+        async_ring_set = 1;
+    }
+    __atomic_store_n(&c->state, DONE_PENDING, __ATOMIC_RELAXED);
+    for (unsigned i = 0; i < svc->workers; ++i) {
+        if (ring_push(&svc->rings[(async_ring_hint + i) % svc->workers], result, a, b, c)) return 0;
+    }
+    return -1;
+}
+
+int bignum_sub_async_poll(const bignum_sub_completion_t *c) {
+    return __atomic_load_n(&c->state, __ATOMIC_ACQUIRE) == DONE_READY;
+}
+
+bignum_sub_status_t bignum_sub_async_wait(bignum_sub_completion_t *c, unsigned spin) {
+    for (unsigned i = 0; i < spin; ++i) {
+        if (__atomic_load_n(&c->state, __ATOMIC_ACQUIRE) == DONE_READY) return c->status;
+        cpu_relax();
+    }
+    uint32_t expected = DONE_PENDING;
+    if (__atomic_compare_exchange_n(&c->state, &expected, DONE_SLEEPING, 0, __ATOMIC_ACQ_REL,
+                                    __ATOMIC_ACQUIRE)) {
+        expected = DONE_SLEEPING;
+    }
+    while (expected == DONE_SLEEPING) {
+        futex_wait(&c->state, DONE_SLEEPING);
+        expected = __atomic_load_n(&c->state, __ATOMIC_ACQUIRE);
+    }
+    return c->status;
+}
+
+void bignum_sub_async_counters(const bignum_sub_async_t *svc, bignum_sub_async_counters_t *out) {
+    memset(out, 0, sizeof(*out));
+    for (unsigned w = 0; w < svc->workers; ++w) {
+        async_ring_t *r = &svc->rings[w];
+        out->calls += atomic_load_explicit(&r->calls, memory_order_relaxed);
+        out->batches += atomic_load_explicit(&r->batches, memory_order_relaxed);
+        out->sleeps += atomic_load_explicit(&r->sleeps, memory_order_relaxed);
+        out->wakeups += atomic_load_explicit(&r->wakeups, memory_order_relaxed);
+    }
+}
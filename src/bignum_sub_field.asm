@@ -0,0 +1,260 @@
+; -----------------------------------------------------------------------------
+; @file    bignum_sub_field.asm
+; @author  git@bayborodov.com
+; @version 1.0.0
+; @date    17.10.2026
+;
+; @brief   Вычитание в простых полях с фиксированным модулем: r = (a - b) mod p.
+;
+; @details
+;   Ядра для полей P-256, P-384, 2^255 - 19 и secp256k1
+;   (include/bignum_sub_field.h) генерируются макросами из таблицы модулей
+;   в конце файла. Модуль не читается из памяти:
+;
+;   - FIELD_SUB имя, p0, p1, ... — произвольный модуль. После a - b маска
+;     заёма (0 или -1) выбирает p: слова p вшиты непосредственными
+;     значениями, нулевые слова дают `adc reg, 0`, слова 2^64 - 1 — саму
+;     маску, остальные — `mov imm64` + `and` с маской в регистр пула
+;     до цепочки adc (rdi, rbx, r12 на это время лежат в xmm0..xmm2);
+;   - FIELD_SUB_2KC имя, слов, k, c — модуль p = 2^k - c, k = 64*слов или
+;     64*слов - 1. При заёме прибавить p — то же, что вычесть c и 2^k по
+;     модулю 2^(64*слов): вычитается `c & маска`, а 2^255 у 2^255 - 19
+;     снимается сбросом старшего бита (`xor` со сдвинутой маской).
+;
+;   Операнды должны быть приведены (a, b < p); результат тоже приведён.
+;   Слова a и разность держатся в регистрах, ветвлений нет: время не
+;   зависит от значений. r может совпадать с a или b.
+;
+; @abi        System V AMD64 ABI
+; @param[in]  rdi: r, rsi: a, rdx: b (массивы слов, младшее первым)
+; @clobbers   rax, rcx, rdx, rsi, r8–r11, xmm0–xmm2, флаги
+;
+; @history
+;   - rev. 1 (17.10.2026): Первоначальная реализация.
+; -----------------------------------------------------------------------------
+
+section .text
+
+; -----------------------------------------------------------------------------
+; FREG_OP op, i, src — `op` над регистром слова i: rax, rcx, r8, r9, r10, r11.
+; -----------------------------------------------------------------------------
+%macro FREG_OP 3
+%if %2 == 0
+    %1      rax, %3
+%elif %2 == 1
+    %1      rcx, %3
+%elif %2 == 2
+    %1      r8, %3
+%elif %2 == 3
+    %1      r9, %3
+%elif %2 == 4
+    %1      r10, %3
+%elif %2 == 5
+    %1      r11, %3
+%else
+    %error "field kernels keep at most 6 words in registers"
+%endif
+%endmacro
+
+; -----------------------------------------------------------------------------
+; FREG_STORE i — [rdi + 8*i] = регистр слова i.
+; -----------------------------------------------------------------------------
+%macro FREG_STORE 1
+%if %1 == 0
+    mov     [rdi], rax
+%elif %1 == 1
+    mov     [rdi + 8], rcx
+%elif %1 == 2
+    mov     [rdi + 16], r8
+%elif %1 == 3
+    mov     [rdi + 24], r9
+%elif %1 == 4
+    mov     [rdi + 32], r10
+%else
+    mov     [rdi + 40], r11
+%endif
+%endmacro
+
+; -----------------------------------------------------------------------------
+; FIELD_PROLOGUE имя, слов
+;   Метка ядра, регистры слов = a - b, rsi = маска заёма (0 или -1).
+; -----------------------------------------------------------------------------
+%macro FIELD_PROLOGUE 2
+global %1_sub
+%1_sub:
+%assign i 0
+%rep %2
+    FREG_OP mov, i, [rsi + 8*i]
+%assign i i + 1
+%endrep
+    FREG_OP sub, 0, [rdx]
+%assign i 1
+%rep %2 - 1
+    FREG_OP sbb, i, [rdx + 8*i]
+%assign i i + 1
+%endrep
+    sbb     rsi, rsi
+%endmacro
+
+; -----------------------------------------------------------------------------
+; FIELD_EPILOGUE слов — запись регистров слов в [rdi].
+; -----------------------------------------------------------------------------
+%macro FIELD_EPILOGUE 1
+%assign i 0
+%rep %1
+    FREG_STORE i
+%assign i i + 1
+%endrep
+    ret
+%endmacro
+
+; -----------------------------------------------------------------------------
+; POOL_OP op, k, src — `op` над регистром пула k: rdx, rdi, rbx, r12.
+;   Пул держит маскированные слова p, посчитанные до цепочки adc (`and`
+;   сбрасывает CF). rdi (указатель r), rbx и r12 на это время сохраняются
+;   в xmm0..xmm2 — без обращений к памяти.
+; -----------------------------------------------------------------------------
+%macro POOL_OP 3
+%if %2 == 0
+    %1      rdx, %3
+%elif %2 == 1
+    %1      rdi, %3
+%elif %2 == 2
+    %1      rbx, %3
+%elif %2 == 3
+    %1      r12, %3
+%else
+    %error "field kernels keep at most 4 special modulus words in registers"
+%endif
+%endmacro
+
+; -----------------------------------------------------------------------------
+; POOL_SAVE k / POOL_RESTORE k — сохранение/восстановление регистра пула k > 0.
+; -----------------------------------------------------------------------------
+%macro POOL_SAVE 1
+%if %1 == 1
+    movq    xmm0, rdi
+%elif %1 == 2
+    movq    xmm1, rbx
+%elif %1 == 3
+    movq    xmm2, r12
+%endif
+%endmacro
+
+%macro POOL_RESTORE 1
+%if %1 == 1
+    movq    rdi, xmm0
+%elif %1 == 2
+    movq    rbx, xmm1
+%elif %1 == 3
+    movq    r12, xmm2
+%endif
+%endmacro
+
+; -----------------------------------------------------------------------------
+; POOL_ADD op, i, k — `op` регистра слова i с регистром пула k.
+; -----------------------------------------------------------------------------
+%macro POOL_ADD 3
+%if %3 == 0
+    FREG_OP %1, %2, rdx
+%elif %3 == 1
+    FREG_OP %1, %2, rdi
+%elif %3 == 2
+    FREG_OP %1, %2, rbx
+%else
+    FREG_OP %1, %2, r12
+%endif
+%endmacro
+
+; -----------------------------------------------------------------------------
+; ADD_BACK op, i, pi — регистр слова i += pi & маска (op = add для слова 0, иначе adc).
+;   Слово p 0 даёт `adc reg, 0`, слово 2^64 - 1 — `adc reg, маска`,
+;   остальные — очередной регистр пула k.
+; -----------------------------------------------------------------------------
+%macro ADD_BACK 3
+%if %3 == 0
+    FREG_OP %1, %2, 0
+%elif %3 == 0xFFFFFFFFFFFFFFFF
+    FREG_OP %1, %2, rsi
+%else
+    POOL_ADD %1, %2, k
+%assign k k + 1
+%endif
+%endmacro
+
+; -----------------------------------------------------------------------------
+; FIELD_SUB имя, p0, p1, ... — произвольный модуль, слова младшим первым.
+; -----------------------------------------------------------------------------
+%macro FIELD_SUB 2-*
+    FIELD_PROLOGUE %1, %0 - 1
+%assign words %0 - 1
+; 1) Маскированные слова p в регистры пула
+%assign pool 0
+%rep words
+%rotate 1
+%if %1 != 0 && %1 != 0xFFFFFFFFFFFFFFFF
+    POOL_SAVE pool
+    POOL_OP mov, pool, %1
+    POOL_OP and, pool, rsi
+%assign pool pool + 1
+%endif
+%endrep
+; 2) Цепочка add/adc: r += p & маска
+%rotate 2
+%assign k 0
+    ADD_BACK add, 0, %1
+%assign i 1
+%rep words - 1
+%rotate 1
+    ADD_BACK adc, i, %1
+%assign i i + 1
+%endrep
+; 3) Восстановление регистров пула и запись
+%assign k pool - 1
+%rep pool
+%if k > 0
+    POOL_RESTORE k
+%endif
+%assign k k - 1
+%endrep
+    FIELD_EPILOGUE words
+%endmacro
+
+; -----------------------------------------------------------------------------
+; FIELD_SUB_2KC имя, слов, k, c — модуль p = 2^k - c.
+; -----------------------------------------------------------------------------
+%macro FIELD_SUB_2KC 4
+%if %3 != 64 * %2 && %3 != 64 * %2 - 1
+    %error "FIELD_SUB_2KC supports k = 64*words or 64*words - 1"
+%endif
+    FIELD_PROLOGUE %1, %2
+    mov     rdx, %4
+    and     rdx, rsi
+    FREG_OP sub, 0, rdx
+%assign i 1
+%rep %2 - 1
+    FREG_OP sbb, i, 0
+%assign i i + 1
+%endrep
+%if %3 == 64 * %2 - 1
+    shl     rsi, 63
+    FREG_OP xor, %2 - 1, rsi
+%endif
+    FIELD_EPILOGUE %2
+%endmacro
+
+; =============================================================================
+; Таблица модулей (слова младшим первым). Имена — bn_<поле>_sub.
+; =============================================================================
+
+; P-256: 2^256 - 2^224 + 2^192 + 2^96 - 1
+FIELD_SUB bn_p256, 0xFFFFFFFFFFFFFFFF, 0x00000000FFFFFFFF, 0x0000000000000000, 0xFFFFFFFF00000001
+
+; P-384: 2^384 - 2^128 - 2^96 + 2^32 - 1
+FIELD_SUB bn_p384, 0x00000000FFFFFFFF, 0xFFFFFFFF00000000, 0xFFFFFFFFFFFFFFFE, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF
+
+; 2^255 - 19
+FIELD_SUB_2KC bn_p25519, 4, 255, 19
+
+; secp256k1: 2^256 - 2^32 - 977
+FIELD_SUB_2KC bn_secp256k1, 4, 256, 0x1000003D1
@@ -0,0 +1,128 @@
+; -----------------------------------------------------------------------------
+; @file    bignum_sub_fixed.asm
+; @author  git@bayborodov.com
+; @version 1.0.0
+; @date    17.10.2026
+;
+; @brief   Вычитание чисел фиксированной ширины 256/512/1024/2048 бит на YASM x86_64.
+;
+; @details
+;   Ядра для типов bn256_t ... bn2048_t (include/bignum_sub_fixed.h): у
+;   операндов нет поля len, поэтому нет проверок длины, цикла, очистки
+;   хвоста результата и нормализации. Каждое ядро — прямолинейная цепочка
+;   sub/sbb, развёрнутая макросом на всю ширину; память — только слова
+;   операндов и результата, без стека и ветвлений внутри цепочки.
+;
+;   Для каждой ширины N:
+;   - bnN_sub_mod(r, a, b) — r = (a - b) mod 2^N, rax = заём из старшего слова;
+;   - bnN_borrow(a, b)     — только заём (1, если a < b), r не пишется;
+;   - bnN_sub(r, a, b)     — контракт bignum_sub: BIGNUM_SUB_SUCCESS или
+;                            BIGNUM_SUB_ERROR_NEGATIVE_RESULT, при a < b
+;                            результат не меняется (сначала проход заёма).
+;
+;   bnN_sub_mod и bnN_borrow выполняются за постоянное время. Слово i
+;   результата записывается после чтения слов i операндов, поэтому r может
+;   совпадать с a или b (частичное перекрытие не допускается).
+;
+; @history
+;   - rev. 1 (17.10.2026): Первоначальная реализация.
+; -----------------------------------------------------------------------------
+
+section .text
+
+; bignum_sub_status_t из bignum_sub.h
+BIGNUM_SUB_SUCCESS                 equ  0
+BIGNUM_SUB_ERROR_NEGATIVE_RESULT   equ -2
+
+; -----------------------------------------------------------------------------
+; SUB_CHAIN words
+;   [rdi] = [rsi] - [rdx] по words словам (чётно, >= 2), CF = заём.
+;   Слова идут парами: две загрузки a, два sbb с памятью b, две записи.
+; @clobbers r8, r9, флаги
+; -----------------------------------------------------------------------------
+%macro SUB_CHAIN 1
+    mov     r8, [rsi]
+    mov     r9, [rsi + 8]
+    sub     r8, [rdx]
+    sbb     r9, [rdx + 8]
+    mov     [rdi], r8
+    mov     [rdi + 8], r9
+%assign i 2
+%rep (%1 - 2) / 2
+    mov     r8, [rsi + 8*i]
+    mov     r9, [rsi + 8*i + 8]
+    sbb     r8, [rdx + 8*i]
+    sbb     r9, [rdx + 8*i + 8]
+    mov     [rdi + 8*i], r8
+    mov     [rdi + 8*i + 8], r9
+%assign i i + 2
+%endrep
+%endmacro
+
+; -----------------------------------------------------------------------------
+; BORROW_CHAIN words
+;   CF = заём [rsi] - [rdx] по words словам (чётно, >= 2); ничего не пишет.
+; @clobbers r8, r9, флаги
+; -----------------------------------------------------------------------------
+%macro BORROW_CHAIN 1
+    mov     r8, [rsi]
+    mov     r9, [rsi + 8]
+    cmp     r8, [rdx]
+    sbb     r9, [rdx + 8]
+%assign i 2
+%rep (%1 - 2) / 2
+    mov     r8, [rsi + 8*i]
+    mov     r9, [rsi + 8*i + 8]
+    sbb     r8, [rdx + 8*i]
+    sbb     r9, [rdx + 8*i + 8]
+%assign i i + 2
+%endrep
+%endmacro
+
+; -----------------------------------------------------------------------------
+; FIXED_KERNELS bits, words
+;   Три ядра одной ширины (System V AMD64 ABI).
+;
+;   uint64_t            bnN_sub_mod(bnN_t *r, const bnN_t *a, const bnN_t *b);
+;     rdi = r, rsi = a, rdx = b; rax = заём (0 или 1).
+;   uint64_t            bnN_borrow(const bnN_t *a, const bnN_t *b);
+;     rdi = a, rsi = b; rax = 1, если a < b.
+;   bignum_sub_status_t bnN_sub(bnN_t *r, const bnN_t *a, const bnN_t *b);
+;     rdi = r, rsi = a, rdx = b; eax = BIGNUM_SUB_SUCCESS или
+;     BIGNUM_SUB_ERROR_NEGATIVE_RESULT (r не меняется).
+; @clobbers r8, r9, флаги
+; -----------------------------------------------------------------------------
+%macro FIXED_KERNELS 2
+global bn%1_sub_mod
+global bn%1_borrow
+global bn%1_sub
+
+bn%1_sub_mod:
+    SUB_CHAIN %2
+    setc    al
+    movzx   eax, al
+    ret
+
+bn%1_borrow:
+    mov     rdx, rsi                ; b
+    mov     rsi, rdi                ; a
+    BORROW_CHAIN %2
+    setc    al
+    movzx   eax, al
+    ret
+
+bn%1_sub:
+    BORROW_CHAIN %2
+    jc      %%negative
+    SUB_CHAIN %2
+    mov     eax, BIGNUM_SUB_SUCCESS
+    ret
+%%negative:
+    mov     eax, BIGNUM_SUB_ERROR_NEGATIVE_RESULT
+    ret
+%endmacro
+
+FIXED_KERNELS 256, 4
+FIXED_KERNELS 512, 8
+FIXED_KERNELS 1024, 16
+FIXED_KERNELS 2048, 32
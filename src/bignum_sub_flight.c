@@ -0,0 +1,335 @@
+/**
+ * @file    bignum_sub_flight.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Бортовой самописец вызовов bignum_sub: кольца потоков, снимок, дамп и аварийный хук.
+ *
+ * @details
+ *   Кольца хранятся в односвязном списке, который только растёт (вставка
+ *   CAS-ом в голову), как буферы трассы: поток захватывает свободное кольцо
+ *   CAS-ом флага in_use, деструктор ключа pthread освобождает его.
+ *
+ *   Писатель у кольца один: он заполняет запись head % DEPTH и публикует
+ *   её release-записью head + 1. Читатель копирует записи между двумя
+ *   чтениями head (seqlock без повторов) и оставляет только те, которые
+ *   писатель не мог начать перезаписывать, т.е. с номером не меньше
+ *   head_после - DEPTH + 1.
+ *
+ *   При выключенной записи хук — одна relaxed-загрузка флага.
+ *   Формат и ограничения описаны в bignum_sub_flight.h.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#define _GNU_SOURCE
+#include "bignum_sub_flight.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+_Static_assert((BIGNUM_SUB_FLIGHT_DEPTH & (BIGNUM_SUB_FLIGHT_DEPTH - 1)) == 0 && BIGNUM_SUB_FLIGHT_DEPTH > 0,
+               "BIGNUM_SUB_FLIGHT_DEPTH must be a power of two");
+_Static_assert(sizeof(bignum_sub_flight_rec_t) == 64, "flight record must fill one cache line");
+
+#define FLIGHT_MASK (BIGNUM_SUB_FLIGHT_DEPTH - 1)
+
+typedef struct flight_ring {
+    struct flight_ring *next;        // список всех колец (элементы не удаляются)
+    atomic_int          in_use;      // кольцо принадлежит живому потоку
+    int32_t             tid;
+    _Alignas(64) _Atomic uint64_t head;   // число записанных вызовов
+    _Alignas(64) bignum_sub_flight_rec_t recs[BIGNUM_SUB_FLIGHT_DEPTH];
+} flight_ring_t;
+
+static _Atomic(flight_ring_t *) flight_rings;
+static atomic_int flight_on;
+static pthread_key_t  flight_key;
+static pthread_once_t flight_key_once = PTHREAD_ONCE_INIT;
+static _Thread_local flight_ring_t *flight_tls;
+
+static int flight_crash_fd = 2;
+static atomic_flag flight_crashing = ATOMIC_FLAG_INIT;
+static const int flight_signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+static struct sigaction flight_old[sizeof(flight_signals) / sizeof(flight_signals[0])];
+
+/** Деструктор ключа: поток завершается — кольцо свободно, записи остаются. */
+static void flight_thread_exit(void *p) {
+    flight_ring_t *ring = p;
+    atomic_store_explicit(&ring->in_use, 0, memory_order_release);
+}
+
+static void flight_key_create(void) {
+    pthread_key_create(&flight_key, flight_thread_exit);
+}
+
+/** Захватывает свободное кольцо или создаёт новое. */
+static flight_ring_t *flight_acquire(void) {
+    flight_ring_t *ring;
+    for (ring = atomic_load(&flight_rings); ring; ring = ring->next) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&ring->in_use, &expected, 1)) break;
+    }
+    if (!ring) {
+        ring = aligned_alloc(64, sizeof(*ring));
+        if (!ring) return NULL;
+        memset(ring, 0, sizeof(*ring));
+        atomic_init(&ring->in_use, 1);
+        ring->next = atomic_load(&flight_rings);
+        while (!atomic_compare_exchange_weak(&flight_rings, &ring->next, ring)) {
+        }
+    }
+    ring->tid = (int32_t)syscall(SYS_gettid);
+    pthread_once(&flight_key_once, flight_key_create);
+    pthread_setspecific(flight_key, ring);
+    flight_tls = ring;
+    return ring;
+}
+
+static uint32_t flight_len(size_t len) {
+    return len > UINT32_MAX ? UINT32_MAX : (uint32_t)len;
+}
+
+static size_t flight_words(size_t len) {
+    return len > BIGNUM_CAPACITY ? BIGNUM_CAPACITY : len;
+}
+
+/** Финальное перемешивание MurmurHash3 (fmix64). */
+static inline uint64_t flight_mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+uint64_t bignum_sub_flight_hash(const bignum_t *a, const bignum_t *b) {
+    if (!a || !b) return 0;
+    // Fletcher-64: два сложения на слово, цепочка зависимостей в один такт
+    uint64_t s1 = a->len, s2 = b->len;
+    size_t wa = flight_words(a->len), wb = flight_words(b->len);
+    for (size_t i = 0; i < wa; ++i) {
+        s1 += a->words[i];
+        s2 += s1;
+    }
+    for (size_t i = 0; i < wb; ++i) {
+        s1 += b->words[i];
+        s2 += s1;
+    }
+    return flight_mix(s2 ^ flight_mix(s1));
+}
+
+void bignum_sub_flight_hook(const bignum_t *result, const bignum_t *a, const bignum_t *b,
+                            bignum_sub_status_t status) {
+    if (!atomic_load_explicit(&flight_on, memory_order_relaxed)) return;
+    flight_ring_t *ring = flight_tls;
+    if (!ring && !(ring = flight_acquire())) return;
+
+    uint64_t h = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    bignum_sub_flight_rec_t *rec = &ring->recs[h & FLIGHT_MASK];
+    rec->seq = h;
+    rec->tsc = __rdtsc();
+    rec->result = result;
+    rec->a = a;
+    rec->b = b;
+    rec->hash = bignum_sub_flight_hash(a, b);
+    rec->tid = ring->tid;
+    rec->len_a = a ? flight_len(a->len) : 0;
+    rec->len_b = b ? flight_len(b->len) : 0;
+    rec->status = (int32_t)status;
+    atomic_store_explicit(&ring->head, h + 1, memory_order_release);
+}
+
+int bignum_sub_flight_start(void) {
+    int expected = 0;
+    return atomic_compare_exchange_strong(&flight_on, &expected, 1) ? 0 : -1;
+}
+
+int bignum_sub_flight_stop(void) {
+    return atomic_exchange(&flight_on, 0) ? 0 : -1;
+}
+
+/**
+ * Копирует в out последние записи кольца (не больше max), от старой к новой.
+ * Возвращает число записей, которые писатель точно не трогал.
+ */
+static size_t flight_copy_ring(const flight_ring_t *ring, bignum_sub_flight_rec_t *out, size_t max) {
+    uint64_t h1 = atomic_load_explicit(&((flight_ring_t *)ring)->head, memory_order_acquire);
+    uint64_t first = h1 > BIGNUM_SUB_FLIGHT_DEPTH ? h1 - BIGNUM_SUB_FLIGHT_DEPTH : 0;
+    size_t n = (size_t)(h1 - first);
+    if (n > max) {
+        first = h1 - max;
+        n = max;
+    }
+    for (size_t i = 0; i < n; ++i) out[i] = ring->recs[(first + i) & FLIGHT_MASK];
+    atomic_thread_fence(memory_order_acquire);
+    if (ring == flight_tls) return n;   // своё кольцо: писатель — мы сами
+    uint64_t h2 = atomic_load_explicit(&((flight_ring_t *)ring)->head, memory_order_relaxed);
+    // Запись h2 - DEPTH могла переписываться прямо сейчас, более старые — уже переписаны
+    uint64_t safe = h2 >= BIGNUM_SUB_FLIGHT_DEPTH ? h2 - BIGNUM_SUB_FLIGHT_DEPTH + 1 : 0;
+    if (safe <= first) return n;
+    size_t drop = safe - first >= n ? n : (size_t)(safe - first);
+    memmove(out, out + drop, (n - drop) * sizeof(*out));
+    return n - drop;
+}
+
+size_t bignum_sub_flight_snapshot(bignum_sub_flight_rec_t *out, size_t max) {
+    size_t n = 0;
+    for (flight_ring_t *ring = atomic_load(&flight_rings); ring && n < max; ring = ring->next) {
+        n += flight_copy_ring(ring, out + n, max - n);
+    }
+    return n;
+}
+
+// --- Дамп: только write(2) и форматирование в стековом буфере ---
+
+typedef struct {
+    int    fd;
+    int    rc;
+    size_t used;
+    char   buf[512];
+} flight_out_t;
+
+static void out_flush(flight_out_t *o) {
+    const char *p = o->buf;
+    size_t n = o->used;
+    while (n > 0 && o->rc == 0) {
+        ssize_t w = write(o->fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            o->rc = -1;
+            break;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+    o->used = 0;
+}
+
+static void out_str(flight_out_t *o, const char *s) {
+    for (; *s; ++s) {
+        if (o->used == sizeof(o->buf)) out_flush(o);
+        o->buf[o->used++] = *s;
+    }
+}
+
+static void out_udec(flight_out_t *o, uint64_t v) {
+    char tmp[24];
+    int i = (int)sizeof(tmp) - 1;
+    tmp[i] = '\0';
+    do {
+        tmp[--i] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    out_str(o, tmp + i);
+}
+
+static void out_dec(flight_out_t *o, int64_t v) {
+    if (v < 0) {
+        out_str(o, "-");
+        out_udec(o, (uint64_t)0 - (uint64_t)v);
+    } else {
+        out_udec(o, (uint64_t)v);
+    }
+}
+
+static void out_hex(flight_out_t *o, uint64_t v) {
+    static const char digits[] = "0123456789abcdef";
+    char tmp[19];
+    tmp[0] = '0';
+    tmp[1] = 'x';
+    for (int i = 0; i < 16; ++i) tmp[2 + i] = digits[(v >> (60 - 4 * i)) & 0xF];
+    tmp[18] = '\0';
+    out_str(o, tmp);
+}
+
+int bignum_sub_flight_dump(int fd) {
+    flight_out_t o = { .fd = fd };
+    bignum_sub_flight_rec_t recs[16];
+    out_str(&o, "bignum_sub flight recorder\n");
+    for (flight_ring_t *ring = atomic_load(&flight_rings); ring; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        out_str(&o, "thread ");
+        out_dec(&o, ring->tid);
+        out_str(&o, atomic_load(&ring->in_use) ? "" : " (exited)");
+        out_str(&o, ": ");
+        out_udec(&o, head);
+        out_str(&o, " call(s), oldest first\n");
+        // Кусками по 16 записей: стек обработчика сигнала может быть маленьким
+        uint64_t first = head > BIGNUM_SUB_FLIGHT_DEPTH ? head - BIGNUM_SUB_FLIGHT_DEPTH : 0;
+        for (uint64_t seq = first; seq < head; seq += 16) {
+            size_t n = head - seq < 16 ? (size_t)(head - seq) : 16;
+            for (size_t i = 0; i < n; ++i) recs[i] = ring->recs[(seq + i) & FLIGHT_MASK];
+            for (size_t i = 0; i < n; ++i) {
+                const bignum_sub_flight_rec_t *r = &recs[i];
+                if (r->seq != seq + i) continue;   // уже переписана живым потоком
+                out_str(&o, "  #");
+                out_udec(&o, r->seq);
+                out_str(&o, " tsc=");
+                out_udec(&o, r->tsc);
+                out_str(&o, " status=");
+                out_dec(&o, r->status);
+                out_str(&o, " len_a=");
+                out_udec(&o, r->len_a);
+                out_str(&o, " len_b=");
+                out_udec(&o, r->len_b);
+                out_str(&o, " result=");
+                out_hex(&o, (uint64_t)(uintptr_t)r->result);
+                out_str(&o, " a=");
+                out_hex(&o, (uint64_t)(uintptr_t)r->a);
+                out_str(&o, " b=");
+                out_hex(&o, (uint64_t)(uintptr_t)r->b);
+                out_str(&o, " hash=");
+                out_hex(&o, r->hash);
+                out_str(&o, "\n");
+            }
+        }
+    }
+    out_flush(&o);
+    return o.rc;
+}
+
+static void flight_crash(int sig) {
+    int saved = errno;
+    if (!atomic_flag_test_and_set(&flight_crashing)) {
+        static const char msg[] = "bignum_sub: fatal signal, dumping flight recorder\n";
+        ssize_t w = write(flight_crash_fd, msg, sizeof(msg) - 1);
+        (void)w;
+        bignum_sub_flight_dump(flight_crash_fd);
+    }
+    // Прежний обработчик и повтор сигнала: процесс завершается как без хука
+    for (size_t i = 0; i < sizeof(flight_signals) / sizeof(flight_signals[0]); ++i) {
+        if (flight_signals[i] == sig) sigaction(sig, &flight_old[i], NULL);
+    }
+    errno = saved;
+    raise(sig);
+}
+
+int bignum_sub_flight_install_crash_handler(int fd) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = flight_crash;
+    sa.sa_flags = SA_ONSTACK | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    flight_crash_fd = fd;
+    for (size_t i = 0; i < sizeof(flight_signals) / sizeof(flight_signals[0]); ++i) {
+        if (sigaction(flight_signals[i], &sa, &flight_old[i]) != 0) return -1;
+    }
+    return 0;
+}
+
+/** Автозапуск по переменной окружения BIGNUM_SUB_FLIGHT: запись и дамп в stderr при аварии. */
+__attribute__((constructor)) static void flight_autostart(void) {
+    const char *on = getenv("BIGNUM_SUB_FLIGHT");
+    if (!on || !*on || *on == '0') return;
+    if (bignum_sub_flight_start() == 0) bignum_sub_flight_install_crash_handler(STDERR_FILENO);
+}
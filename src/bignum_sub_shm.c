@@ -0,0 +1,806 @@
+/**
+ * @file    bignum_sub_shm.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Клиент и демон межпроцессного сервиса bignum_sub на memfd.
+ *
+ * @details
+ *   memfd клиента: заголовок (магия, версия, смещения, счётчик завершений
+ *   в своей кэш-линии), кольцо записей и арена bignum_t. Кольцо — SPSC с
+ *   номером последовательности в записи: seq == pos — свободна для клиента,
+ *   pos + 1 — заявка готова, pos + size — выполнена (статус записан).
+ *   Записи ссылаются на слоты арены индексами, потому что адреса
+ *   отображений у процессов разные.
+ *
+ *   Демон: поток приёма слушает Unix-сокет, сокеты клиентов и ещё не
+ *   приславшие memfd подключения (poll, рукопожатие без блокировки),
+ *   проверяет печати и заголовок присланного memfd, отображает его и
+ *   отдаёт соединение рабочему потоку через ячейку его таблицы
+ *   (release-запись указателя). Закрытие сокета клиента поток приёма
+ *   отмечает флагом closing; отображение снимает и память освобождает
+ *   рабочий поток, когда больше не обращается к кольцу.
+ *
+ *   Futex на общей памяти — без FUTEX_PRIVATE_FLAG. Порядок "данные —
+ *   барьер — флаг сна" тот же, что в bignum_sub_async.c.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Заявки над копиями слотов, SO_PEERCRED, сокет 0600, неблокирующее рукопожатие.
+ */
+
+#define _GNU_SOURCE
+#include "bignum_sub_shm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHM_MAGIC    "BNSUBSH1"
+#define SHM_VERSION  1u
+#define SHM_NULL     UINT32_MAX
+#define SHM_SEALS    (F_SEAL_SHRINK | F_SEAL_GROW)
+// Сон клиента ограничен, чтобы заметить завершение демона
+#define SHM_WAIT_NS  100000000L
+// Подключения, ещё не приславшие memfd, и срок рукопожатия
+#define SHM_MAX_PENDING   64
+#define SHM_HANDSHAKE_MS  1000
+
+typedef struct {
+    _Alignas(32) _Atomic uint64_t seq;
+    uint32_t r, a, b;
+    int32_t  status;
+} shm_slot_t;
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t ring_size;
+    uint64_t ring_off;
+    uint64_t arena_off;
+    uint64_t arena_slots;
+    uint64_t size;
+    _Alignas(64) atomic_uint cq_seq;     // +1 после каждого пакета демона
+    atomic_uint              cq_waiting; // клиент спит на cq_seq
+} shm_header_t;
+
+/** Звонок рабочего потока демона (страница звонков общая для всех клиентов). */
+typedef struct {
+    _Alignas(64) atomic_uint sleeping;
+} shm_bell_t;
+
+/** Ответ демона на подключение (вместе с дескриптором страницы звонков). */
+typedef struct {
+    int32_t  status;    // 0 или -errno
+    uint32_t worker;
+    uint32_t workers;
+} shm_reply_t;
+
+static void futex_wait_shared(atomic_uint *addr, uint32_t val, long ns) {
+    struct timespec ts = { 0, ns }, *tp = ns ? &ts : NULL;
+    syscall(SYS_futex, addr, FUTEX_WAIT, val, tp, NULL, 0);
+}
+
+static void futex_wake_shared(atomic_uint *addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static inline void cpu_relax(void) {
+    __builtin_ia32_pause();
+}
+
+static size_t round_page(size_t n) {
+    size_t pg = (size_t)sysconf(_SC_PAGESIZE);
+    return (n + pg - 1) / pg * pg;
+}
+
+static int sock_addr(struct sockaddr_un *sa, const char *path) {
+    if (!path) path = BIGNUM_SUB_SHM_SOCKET;
+    memset(sa, 0, sizeof(*sa));
+    sa->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(sa->sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(sa->sun_path, path);
+    return 0;
+}
+
+/** Передаёт `len` байт и (если fd >= 0) дескриптор. */
+static int send_fd(int sock, const void *buf, size_t len, int fd) {
+    union {
+        struct cmsghdr hdr;
+        char           buf[CMSG_SPACE(sizeof(int))];
+    } ctl;
+    struct iovec iov = { (void *)buf, len };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (fd >= 0) {
+        memset(&ctl, 0, sizeof(ctl));
+        msg.msg_control = ctl.buf;
+        msg.msg_controllen = sizeof(ctl.buf);
+        struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+        cm->cmsg_level = SOL_SOCKET;
+        cm->cmsg_type = SCM_RIGHTS;
+        cm->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cm), &fd, sizeof(int));
+    }
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == (ssize_t)len ? 0 : -1;
+}
+
+/** Принимает ровно `len` байт и дескриптор (*fd = -1, если его нет); `flags` — для recvmsg. */
+static int recv_fd(int sock, void *buf, size_t len, int *fd, int flags) {
+    union {
+        struct cmsghdr hdr;
+        char           buf[CMSG_SPACE(sizeof(int))];
+    } ctl;
+    struct iovec iov = { buf, len };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctl.buf;
+    msg.msg_controllen = sizeof(ctl.buf);
+    *fd = -1;
+    ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC | flags);
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); n >= 0 && cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS) memcpy(fd, CMSG_DATA(cm), sizeof(int));
+    }
+    if (n != (ssize_t)len) {
+        if (*fd >= 0) close(*fd);
+        *fd = -1;
+        if (n >= 0) errno = EPROTO;
+        return -1;
+    }
+    return 0;
+}
+
+/** Другая сторона сокета работает под тем же пользователем. */
+static int peer_trusted(int sock) {
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) return 0;
+    if (cred.uid != geteuid()) {
+        errno = EPERM;
+        return 0;
+    }
+    return 1;
+}
+
+/* --- Клиент --- */
+
+struct bignum_sub_shm_client {
+    int           sock;
+    shm_header_t *hdr;
+    size_t        size;
+    shm_slot_t   *ring;
+    uint32_t      mask;
+    bignum_t     *arena;
+    size_t        arena_slots;
+    shm_bell_t   *bells;
+    size_t        bells_size;
+    unsigned      worker;
+    uint64_t      tail;
+};
+
+bignum_sub_shm_client_t *bignum_sub_shm_connect(const char *path, size_t arena_slots) {
+    struct sockaddr_un sa;
+    if (arena_slots == 0 || arena_slots > BIGNUM_SUB_SHM_MAX_SLOTS) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (sock_addr(&sa, path) != 0) return NULL;
+    bignum_sub_shm_client_t *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->sock = -1;
+
+    const size_t ring_off = round_page(sizeof(shm_header_t));
+    const size_t arena_off = ring_off + round_page(BIGNUM_SUB_SHM_RING * sizeof(shm_slot_t));
+    c->size = arena_off + round_page(arena_slots * sizeof(bignum_t));
+    int fd = memfd_create("bignum_sub_shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    int bell_fd = -1, err = 0;
+    shm_reply_t reply;
+    if (fd < 0 || ftruncate(fd, (off_t)c->size) != 0 || fcntl(fd, F_ADD_SEALS, SHM_SEALS) != 0) goto fail;
+    void *map = mmap(NULL, c->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) goto fail;
+    c->hdr = map;
+    memcpy(c->hdr->magic, SHM_MAGIC, 8);
+    c->hdr->version = SHM_VERSION;
+    c->hdr->ring_size = BIGNUM_SUB_SHM_RING;
+    c->hdr->ring_off = ring_off;
+    c->hdr->arena_off = arena_off;
+    c->hdr->arena_slots = arena_slots;
+    c->hdr->size = c->size;
+    c->ring = (shm_slot_t *)((char *)map + ring_off);
+    c->mask = BIGNUM_SUB_SHM_RING - 1;
+    for (uint32_t i = 0; i < BIGNUM_SUB_SHM_RING; ++i) atomic_init(&c->ring[i].seq, i);
+    c->arena = (bignum_t *)((char *)map + arena_off);
+    c->arena_slots = arena_slots;
+
+    c->sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (c->sock < 0 || connect(c->sock, (struct sockaddr *)&sa, sizeof(sa)) != 0 || !peer_trusted(c->sock)) goto fail;
+    if (send_fd(c->sock, "S", 1, fd) != 0 || recv_fd(c->sock, &reply, sizeof(reply), &bell_fd, 0) != 0) goto fail;
+    if (reply.status != 0 || bell_fd < 0 || reply.worker >= reply.workers) {
+        errno = reply.status != 0 ? -reply.status : EPROTO;
+        goto fail;
+    }
+    c->bells_size = round_page(reply.workers * sizeof(shm_bell_t));
+    map = mmap(NULL, c->bells_size, PROT_READ | PROT_WRITE, MAP_SHARED, bell_fd, 0);
+    if (map == MAP_FAILED) goto fail;
+    c->bells = map;
+    c->worker = reply.worker;
+    close(bell_fd);
+    close(fd);
+    return c;
+
+fail:
+    err = errno;
+    if (bell_fd >= 0) close(bell_fd);
+    if (fd >= 0) close(fd);
+    if (c->sock >= 0) close(c->sock);
+    if (c->hdr) munmap(c->hdr, c->size);
+    free(c);
+    errno = err;
+    return NULL;
+}
+
+void bignum_sub_shm_disconnect(bignum_sub_shm_client_t *c) {
+    if (!c) return;
+    close(c->sock);
+    munmap(c->bells, c->bells_size);
+    munmap(c->hdr, c->size);
+    free(c);
+}
+
+bignum_t *bignum_sub_shm_arena(bignum_sub_shm_client_t *c, size_t *count) {
+    if (count) *count = c->arena_slots;
+    return c->arena;
+}
+
+/** Индекс слота арены для указателя; SHM_NULL для NULL, -1 вне арены. */
+static int64_t arena_index(const bignum_sub_shm_client_t *c, const bignum_t *p) {
+    if (!p) return SHM_NULL;
+    uintptr_t off = (uintptr_t)p - (uintptr_t)c->arena;
+    if ((uintptr_t)p < (uintptr_t)c->arena || off % sizeof(bignum_t) != 0 || off / sizeof(bignum_t) >= c->arena_slots) {
+        return -1;
+    }
+    return (int64_t)(off / sizeof(bignum_t));
+}
+
+int64_t bignum_sub_shm_submit(bignum_sub_shm_client_t *c, bignum_t *result, const bignum_t *a,
+                              const bignum_t *b) {
+    int64_t ir = arena_index(c, result), ia = arena_index(c, a), ib = arena_index(c, b);
+    if (ir < 0 || ia < 0 || ib < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    uint64_t pos = c->tail;
+    shm_slot_t *s = &c->ring[pos & c->mask];
+    if (atomic_load_explicit(&s->seq, memory_order_acquire) != pos) {
+        errno = EAGAIN;
+        return -1;
+    }
+    s->r = (uint32_t)ir;
+    s->a = (uint32_t)ia;
+    s->b = (uint32_t)ib;
+    atomic_store_explicit(&s->seq, pos + 1, memory_order_release);
+    c->tail = pos + 1;
+
+    shm_bell_t *bell = &c->bells[c->worker];
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&bell->sleeping, memory_order_relaxed) && atomic_exchange(&bell->sleeping, 0) == 1) {
+        futex_wake_shared(&bell->sleeping);
+    }
+    return (int64_t)pos;
+}
+
+static inline int slot_done(const bignum_sub_shm_client_t *c, uint64_t t) {
+    return atomic_load_explicit(&c->ring[t & c->mask].seq, memory_order_acquire) == t + c->mask + 1;
+}
+
+int bignum_sub_shm_poll(bignum_sub_shm_client_t *c, int64_t ticket) {
+    return slot_done(c, (uint64_t)ticket);
+}
+
+/** Демон закрыл соединение (он ничего не пишет в сокет после ответа). */
+static int server_gone(const bignum_sub_shm_client_t *c) {
+    struct pollfd p = { c->sock, POLLIN, 0 };
+    return poll(&p, 1, 0) > 0 && (p.revents & (POLLIN | POLLHUP | POLLERR));
+}
+
+int bignum_sub_shm_wait(bignum_sub_shm_client_t *c, int64_t ticket, unsigned spin) {
+    const uint64_t t = (uint64_t)ticket;
+    shm_slot_t *s = &c->ring[t & c->mask];
+    for (unsigned i = 0; i < spin; ++i) {
+        if (slot_done(c, t)) return s->status;
+        cpu_relax();
+    }
+    while (!slot_done(c, t)) {
+        unsigned seen = atomic_load(&c->hdr->cq_seq);
+        atomic_store(&c->hdr->cq_waiting, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (slot_done(c, t)) break;
+        if (server_gone(c)) return BIGNUM_SUB_SHM_DISCONNECTED;
+        futex_wait_shared(&c->hdr->cq_seq, seen, SHM_WAIT_NS);
+    }
+    atomic_store(&c->hdr->cq_waiting, 0);
+    return s->status;
+}
+
+int bignum_sub_shm_call(bignum_sub_shm_client_t *c, bignum_t *result, const bignum_t *a, const bignum_t *b) {
+    int64_t t = bignum_sub_shm_submit(c, result, a, b);
+    return t < 0 ? -1 : bignum_sub_shm_wait(c, t, 0);
+}
+
+/* --- Демон --- */
+
+typedef struct {
+    int           sock;       // поток приёма
+    shm_header_t *hdr;
+    size_t        size;
+    shm_slot_t   *ring;
+    uint32_t      mask;
+    bignum_t     *arena;
+    uint64_t      arena_slots;
+    uint64_t      head;       // рабочий поток
+    unsigned      worker;
+    atomic_int    closing;
+} shm_conn_t;
+
+typedef struct {
+    _Alignas(64) _Atomic(shm_conn_t *) conns[BIGNUM_SUB_SHM_MAX_CLIENTS];
+    atomic_uint       used;   // верхняя граница занятых ячеек
+    _Atomic uint64_t  calls, batches, sleeps;
+    pthread_t         thread;
+    unsigned          index;
+    struct bignum_sub_shm_server *srv;
+} shm_worker_t;
+
+/** Принятое подключение до получения memfd. */
+typedef struct {
+    int     sock;
+    int64_t deadline_ms;
+} shm_pending_t;
+
+struct bignum_sub_shm_server {
+    int           listen_fd;
+    int           bell_fd;
+    shm_bell_t   *bells;
+    size_t        bells_size;
+    int           wake[2];    // пробуждение потока приёма при остановке
+    char          path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    unsigned      nworkers, batch, spin, next_worker;
+    atomic_int    stop;
+    shm_worker_t *workers;
+    pthread_t     acceptor;
+    _Atomic uint64_t clients;
+    shm_conn_t   *live[BIGNUM_SUB_SHM_MAX_CLIENTS];
+    size_t        nlive;
+    shm_pending_t pending[SHM_MAX_PENDING];
+    size_t        npending;
+    struct pollfd pfd[BIGNUM_SUB_SHM_MAX_CLIENTS + SHM_MAX_PENDING + 2];
+};
+
+static inline void worker_count(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static void bell_ring(shm_bell_t *bell) {
+    if (atomic_exchange(&bell->sleeping, 0) == 1) futex_wake_shared(&bell->sleeping);
+}
+
+/** Копия слота арены в `dst`; NULL для неверного индекса. */
+static bignum_t *conn_load(const shm_conn_t *k, uint32_t idx, bignum_t *dst) {
+    if (idx >= k->arena_slots) return NULL;
+    memcpy(dst, &k->arena[idx], sizeof(*dst));
+    return dst;
+}
+
+static inline int conn_ready(const shm_conn_t *k, uint64_t pos) {
+    return atomic_load_explicit(&k->ring[pos & k->mask].seq, memory_order_acquire) == pos + 1;
+}
+
+/**
+ * Одна заявка. Ядро читает len повторно после проверки, а арена доступна
+ * клиенту на запись, поэтому операнды копируются в память демона, и только
+ * результат успешного вызова копируется обратно в слот. Совпадающие индексы
+ * дают одну копию: совпадение слотов по-прежнему видно ядру.
+ */
+static int conn_call(const shm_conn_t *k, const shm_slot_t *s) {
+    const uint32_t ir = ((volatile const shm_slot_t *)s)->r;
+    const uint32_t ia = ((volatile const shm_slot_t *)s)->a;
+    const uint32_t ib = ((volatile const shm_slot_t *)s)->b;
+    bignum_t x, y, z;
+    bignum_t *pa = conn_load(k, ia, &x);
+    bignum_t *pb = ib == ia ? pa : conn_load(k, ib, &y);
+    bignum_t *pr = ir >= k->arena_slots ? NULL : ir == ia ? pa : ir == ib ? pb : &z;
+    int st = bignum_sub(pr, pa, pb);
+    if (st == BIGNUM_SUB_SUCCESS) memcpy(&k->arena[ir], pr, sizeof(*pr));
+    return st;
+}
+
+/** Выполняет пакет готовых заявок клиента. @return Число заявок. */
+static size_t conn_serve(shm_conn_t *k, unsigned batch) {
+    size_t n = 0;
+    while (n < batch && conn_ready(k, k->head + n)) n++;
+    if (n == 0) return 0;
+    for (size_t i = 0; i < n; ++i) {
+        shm_slot_t *s = &k->ring[(k->head + i) & k->mask];
+        s->status = conn_call(k, s);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        atomic_store_explicit(&k->ring[(k->head + i) & k->mask].seq, k->head + i + k->mask + 1,
+                              memory_order_release);
+    }
+    k->head += n;
+    atomic_fetch_add(&k->hdr->cq_seq, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&k->hdr->cq_waiting, memory_order_relaxed) &&
+        atomic_exchange(&k->hdr->cq_waiting, 0) == 1) {
+        futex_wake_shared(&k->hdr->cq_seq);
+    }
+    return n;
+}
+
+static void conn_free(shm_conn_t *k) {
+    munmap(k->hdr, k->size);
+    free(k);
+}
+
+/** Один обход колец рабочего потока. @return Выполненные заявки; *pending — есть готовые. */
+static size_t worker_pass(shm_worker_t *w, int serve, int *pending) {
+    size_t done = 0;
+    unsigned used = atomic_load_explicit(&w->used, memory_order_acquire);
+    for (unsigned i = 0; i < used; ++i) {
+        shm_conn_t *k = atomic_load_explicit(&w->conns[i], memory_order_acquire);
+        if (!k) continue;
+        if (atomic_load_explicit(&k->closing, memory_order_acquire)) {
+            atomic_store_explicit(&w->conns[i], NULL, memory_order_release);
+            conn_free(k);
+            continue;
+        }
+        if (serve) {
+            size_t n = conn_serve(k, w->srv->batch);
+            if (n) {
+                done += n;
+                worker_count(&w->calls, n);
+                worker_count(&w->batches, 1);
+            }
+        } else if (conn_ready(k, k->head)) {
+            *pending = 1;
+        }
+    }
+    return done;
+}
+
+static void *worker_main(void *arg) {
+    shm_worker_t *w = arg;
+    struct bignum_sub_shm_server *srv = w->srv;
+    shm_bell_t *bell = &srv->bells[w->index];
+    unsigned idle = 0;
+    for (;;) {
+        if (worker_pass(w, 1, NULL)) {
+            idle = 0;
+            continue;
+        }
+        if (atomic_load(&srv->stop)) break;
+        if (++idle < srv->spin) {
+            cpu_relax();
+            continue;
+        }
+        int pending = 0;
+        atomic_store(&bell->sleeping, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        worker_pass(w, 0, &pending);
+        if (!pending && !atomic_load(&srv->stop)) {
+            worker_count(&w->sleeps, 1);
+            futex_wait_shared(&bell->sleeping, 1, 0);
+        }
+        atomic_store(&bell->sleeping, 0);
+        idle = 0;
+    }
+    for (unsigned i = 0; i < atomic_load(&w->used); ++i) {
+        shm_conn_t *k = atomic_load(&w->conns[i]);
+        if (k) conn_free(k);
+    }
+    return NULL;
+}
+
+/** Проверяет memfd клиента и отображает его. @return 0 или -errno. */
+static int conn_map(shm_conn_t *k, int fd) {
+    struct stat st;
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & SHM_SEALS) != SHM_SEALS || fstat(fd, &st) != 0) return -EPERM;
+    k->size = (size_t)st.st_size;
+    if (k->size < sizeof(shm_header_t)) return -EINVAL;
+    void *map = mmap(NULL, k->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) return -errno;
+    k->hdr = map;
+    // Заголовок копируется: клиент может менять его после проверки
+    shm_header_t h;
+    memcpy(&h, map, offsetof(shm_header_t, cq_seq));
+    uint64_t ring_bytes = (uint64_t)h.ring_size * sizeof(shm_slot_t);
+    if (memcmp(h.magic, SHM_MAGIC, 8) != 0 || h.version != SHM_VERSION || h.size != k->size ||
+        h.ring_size == 0 || (h.ring_size & (h.ring_size - 1)) != 0 || h.ring_size > (1u << 20) ||
+        h.ring_off % 64 != 0 || h.ring_off < sizeof(shm_header_t) || h.arena_off > k->size ||
+        h.ring_off > h.arena_off || ring_bytes > h.arena_off - h.ring_off ||
+        h.arena_off % 64 != 0 || h.arena_slots > BIGNUM_SUB_SHM_MAX_SLOTS ||
+        h.arena_off + h.arena_slots * sizeof(bignum_t) > k->size) {
+        munmap(map, k->size);
+        return -EPROTO;
+    }
+    k->ring = (shm_slot_t *)((char *)map + h.ring_off);
+    k->mask = h.ring_size - 1;
+    k->arena = (bignum_t *)((char *)map + h.arena_off);
+    k->arena_slots = h.arena_slots;
+    k->head = 0;
+    return 0;
+}
+
+/** Отдаёт соединение рабочему потоку. @return 0 или -1 (нет свободной ячейки). */
+static int conn_attach(struct bignum_sub_shm_server *srv, shm_conn_t *k) {
+    shm_worker_t *w = &srv->workers[k->worker];
+    unsigned used = atomic_load(&w->used);
+    for (unsigned i = 0; i < BIGNUM_SUB_SHM_MAX_CLIENTS; ++i) {
+        if (atomic_load(&w->conns[i]) != NULL) continue;
+        atomic_store_explicit(&w->conns[i], k, memory_order_release);
+        if (i >= used) atomic_store_explicit(&w->used, i + 1, memory_order_release);
+        bell_ring(&srv->bells[k->worker]);
+        return 0;
+    }
+    return -1;
+}
+
+static void conn_close(struct bignum_sub_shm_server *srv, size_t i) {
+    shm_conn_t *k = srv->live[i];
+    close(k->sock);
+    atomic_store_explicit(&k->closing, 1, memory_order_release);
+    bell_ring(&srv->bells[k->worker]);
+    srv->live[i] = srv->live[--srv->nlive];
+}
+
+static int64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Принимает подключение. Сокет неблокирующий: memfd читается в
+ * client_handshake(), когда сокет готов, поэтому молчащий клиент не
+ * задерживает других. Чужой пользователь (SO_PEERCRED) отклоняется сразу.
+ */
+static void accept_client(struct bignum_sub_shm_server *srv) {
+    int sock = accept4(srv->listen_fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (sock < 0) return;
+    if (srv->npending == SHM_MAX_PENDING || !peer_trusted(sock)) {
+        close(sock);
+        return;
+    }
+    srv->pending[srv->npending++] = (shm_pending_t){ sock, now_ms() + SHM_HANDSHAKE_MS };
+}
+
+/** Рукопожатие подключения pending[i]: memfd клиента, ответ и дескриптор звонков. */
+static void client_handshake(struct bignum_sub_shm_server *srv, size_t i) {
+    int sock = srv->pending[i].sock;
+    char tag;
+    int fd;
+    shm_reply_t reply = { 0, 0, srv->nworkers };
+    shm_conn_t *k = NULL;
+    if (recv_fd(sock, &tag, 1, &fd, MSG_DONTWAIT) != 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    srv->pending[i] = srv->pending[--srv->npending];
+    if (fd < 0) {
+        close(sock);
+        return;
+    }
+    if (srv->nlive == BIGNUM_SUB_SHM_MAX_CLIENTS || !(k = calloc(1, sizeof(*k)))) {
+        reply.status = -EMFILE;
+    } else {
+        reply.status = conn_map(k, fd);
+    }
+    close(fd);
+    if (reply.status == 0) {
+        k->sock = sock;
+        k->worker = srv->next_worker++ % srv->nworkers;
+        reply.worker = k->worker;
+        if (conn_attach(srv, k) != 0) {
+            munmap(k->hdr, k->size);
+            reply.status = -EMFILE;
+        }
+    }
+    if (reply.status != 0) {
+        free(k);
+        send_fd(sock, &reply, sizeof(reply), -1);
+        close(sock);
+        return;
+    }
+    srv->live[srv->nlive++] = k;
+    atomic_fetch_add(&srv->clients, 1);
+    if (send_fd(sock, &reply, sizeof(reply), srv->bell_fd) != 0) conn_close(srv, srv->nlive - 1);
+}
+
+/** Тайм-аут poll до ближайшего срока рукопожатия (-1 — без срока). */
+static int pending_timeout(const struct bignum_sub_shm_server *srv) {
+    if (srv->npending == 0) return -1;
+    int64_t first = srv->pending[0].deadline_ms;
+    for (size_t i = 1; i < srv->npending; ++i) {
+        if (srv->pending[i].deadline_ms < first) first = srv->pending[i].deadline_ms;
+    }
+    int64_t left = first - now_ms();
+    return left < 0 ? 0 : (int)left;
+}
+
+static void *acceptor_main(void *arg) {
+    struct bignum_sub_shm_server *srv = arg;
+    struct pollfd *p = srv->pfd;
+    while (!atomic_load(&srv->stop)) {
+        p[0] = (struct pollfd){ srv->wake[0], POLLIN, 0 };
+        p[1] = (struct pollfd){ srv->listen_fd, POLLIN, 0 };
+        for (size_t i = 0; i < srv->nlive; ++i) p[i + 2] = (struct pollfd){ srv->live[i]->sock, POLLIN, 0 };
+        size_t n = srv->nlive, m = srv->npending;
+        for (size_t i = 0; i < m; ++i) p[n + i + 2] = (struct pollfd){ srv->pending[i].sock, POLLIN, 0 };
+        if (poll(p, n + m + 2, pending_timeout(srv)) < 0) continue;
+        // Сокеты клиентов: любые данные или закрытие — отключение
+        for (size_t i = n; i-- > 0;) {
+            if (p[i + 2].revents) conn_close(srv, i);
+        }
+        // Рукопожатия: готовые выполняются, просроченные закрываются
+        int64_t now = now_ms();
+        for (size_t i = m; i-- > 0;) {
+            if (p[n + i + 2].revents) {
+                client_handshake(srv, i);
+            } else if (srv->pending[i].deadline_ms <= now) {
+                close(srv->pending[i].sock);
+                srv->pending[i] = srv->pending[--srv->npending];
+            }
+        }
+        if (p[1].revents & POLLIN) accept_client(srv);
+    }
+    while (srv->nlive) conn_close(srv, srv->nlive - 1);
+    while (srv->npending) close(srv->pending[--srv->npending].sock);
+    return NULL;
+}
+
+bignum_sub_shm_server_t *bignum_sub_shm_server_start(const bignum_sub_shm_server_config_t *cfg) {
+    bignum_sub_shm_server_config_t def;
+    memset(&def, 0, sizeof(def));
+    if (!cfg) cfg = &def;
+    unsigned nworkers = cfg->workers ? cfg->workers : 1;
+    unsigned batch = cfg->batch ? cfg->batch : 64;
+    if (nworkers > BIGNUM_SUB_SHM_MAX_WORKERS || batch > BIGNUM_SUB_SHM_MAX_BATCH) {
+        errno = EINVAL;
+        return NULL;
+    }
+    struct sockaddr_un sa;
+    if (sock_addr(&sa, cfg->path) != 0) return NULL;
+
+    struct bignum_sub_shm_server *srv = calloc(1, sizeof(*srv));
+    if (!srv) return NULL;
+    srv->listen_fd = srv->bell_fd = srv->wake[0] = srv->wake[1] = -1;
+    srv->nworkers = nworkers;
+    srv->batch = batch;
+    srv->spin = cfg->spin ? cfg->spin : 4096;
+    strcpy(srv->path, sa.sun_path);
+    srv->bells_size = round_page(nworkers * sizeof(shm_bell_t));
+    srv->workers = aligned_alloc(64, nworkers * sizeof(shm_worker_t));
+    int err;
+
+    srv->bell_fd = memfd_create("bignum_sub_shm_bells", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (!srv->workers || srv->bell_fd < 0 || ftruncate(srv->bell_fd, (off_t)srv->bells_size) != 0 ||
+        fcntl(srv->bell_fd, F_ADD_SEALS, SHM_SEALS) != 0 || pipe2(srv->wake, O_CLOEXEC) != 0) {
+        goto fail;
+    }
+    void *map = mmap(NULL, srv->bells_size, PROT_READ | PROT_WRITE, MAP_SHARED, srv->bell_fd, 0);
+    if (map == MAP_FAILED) goto fail;
+    srv->bells = map;
+
+    // Права 0600 выставляются до listen(): раньше подключиться нельзя
+    unlink(sa.sun_path);
+    srv->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (srv->listen_fd < 0 || bind(srv->listen_fd, (struct sockaddr *)&sa, sizeof(sa)) != 0 ||
+        chmod(sa.sun_path, S_IRUSR | S_IWUSR) != 0 || listen(srv->listen_fd, 64) != 0) {
+        goto fail;
+    }
+
+    memset(srv->workers, 0, nworkers * sizeof(shm_worker_t));
+    for (unsigned i = 0; i < nworkers; ++i) {
+        shm_worker_t *w = &srv->workers[i];
+        w->index = i;
+        w->srv = srv;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (cfg->cpus && cfg->cpus[i] >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cfg->cpus[i], &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+        int rc = pthread_create(&w->thread, &attr, worker_main, w);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            // Уже запущенные рабочие потоки останавливаются как при обычной остановке
+            srv->nworkers = i;
+            atomic_store(&srv->stop, 1);
+            for (unsigned j = 0; j < i; ++j) {
+                bell_ring(&srv->bells[j]);
+                pthread_join(srv->workers[j].thread, NULL);
+            }
+            errno = rc;
+            goto fail;
+        }
+    }
+    int rc = pthread_create(&srv->acceptor, NULL, acceptor_main, srv);
+    if (rc != 0) {
+        srv->acceptor = pthread_self();
+        bignum_sub_shm_server_stop(srv);
+        errno = rc;
+        return NULL;
+    }
+    return srv;
+
+fail:
+    err = errno;
+    if (srv->listen_fd >= 0) {
+        close(srv->listen_fd);
+        unlink(srv->path);
+    }
+    if (srv->bells) munmap(srv->bells, srv->bells_size);
+    if (srv->bell_fd >= 0) close(srv->bell_fd);
+    if (srv->wake[0] >= 0) close(srv->wake[0]);
+    if (srv->wake[1] >= 0) close(srv->wake[1]);
+    free(srv->workers);
+    free(srv);
+    errno = err;
+    return NULL;
+}
+
+void bignum_sub_shm_server_stop(bignum_sub_shm_server_t *srv) {
+    if (!srv) return;
+    atomic_store(&srv->stop, 1);
+    if (!pthread_equal(srv->acceptor, pthread_self())) {
+        ssize_t rc = write(srv->wake[1], "x", 1);
+        (void)rc;
+        pthread_join(srv->acceptor, NULL);
+    }
+    for (unsigned i = 0; i < srv->nworkers; ++i) {
+        bell_ring(&srv->bells[i]);
+        pthread_join(srv->workers[i].thread, NULL);
+    }
+    close(srv->listen_fd);
+    unlink(srv->path);
+    munmap(srv->bells, srv->bells_size);
+    close(srv->bell_fd);
+    close(srv->wake[0]);
+    close(srv->wake[1]);
+    free(srv->workers);
+    free(srv);
+}
+
+void bignum_sub_shm_server_counters(const bignum_sub_shm_server_t *srv,
+                                    bignum_sub_shm_server_counters_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->clients = atomic_load_explicit(&srv->clients, memory_order_relaxed);
+    for (unsigned i = 0; i < srv->nworkers; ++i) {
+        const shm_worker_t *w = &srv->workers[i];
+        out->calls += atomic_load_explicit(&w->calls, memory_order_relaxed);
+        out->batches += atomic_load_explicit(&w->batches, memory_order_relaxed);
+        out->sleeps += atomic_load_explicit(&w->sleeps, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,271 @@
+/**
+ * @file    bignum_sub_stat.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Счётчики вызовов bignum_sub по потокам в разделяемой памяти и их чтение.
+ *
+ * @details
+ *   Сегмент: заголовок (одна кэш-линия) и массив слотов по
+ *   BIGNUM_SUB_STAT_MAX_THREADS, каждый слот выровнен по 64 байта.
+ *   Поток захватывает слот CAS-ом состояния (свободный, затем
+ *   освобождённый завершившимся потоком) один раз; дальше счётчики
+ *   обновляются парой relaxed-загрузка/relaxed-запись — это обычные
+ *   mov/add/mov без префикса lock. Деструктор ключа pthread помечает слот
+ *   освобождённым, счёт в нём сохраняется.
+ *
+ *   При выключенной публикации хук — одна relaxed-загрузка флага.
+ *   Формат и ограничения описаны в bignum_sub_stat.h.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Сегмент создаётся с правами 0600.
+ */
+
+#define _GNU_SOURCE
+#include "bignum_sub_stat.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define STAT_MAGIC   "BNSUBST1"
+#define STAT_VERSION 1u
+
+enum { SLOT_FREE = 0, SLOT_LIVE = 1, SLOT_RETIRED = 2 };
+
+typedef struct {
+    _Alignas(64) char magic[8];
+    uint32_t    version;
+    uint32_t    slot_size;
+    uint32_t    max_slots;
+    uint32_t    capacity;
+    atomic_uint used;           // верхняя граница занятых слотов
+} stat_header_t;
+
+typedef struct {
+    _Alignas(64) atomic_int state;
+    atomic_int       tid;
+    _Atomic uint64_t calls;
+    _Atomic uint64_t status[BIGNUM_SUB_STAT_STATUSES];
+    _Atomic uint64_t len[BIGNUM_SUB_STAT_LEN_BINS];
+    _Atomic uint64_t borrow[BIGNUM_SUB_STAT_BORROW_BINS];
+} stat_slot_t;
+
+typedef struct {
+    stat_header_t hdr;
+    stat_slot_t   slots[BIGNUM_SUB_STAT_MAX_THREADS];
+} stat_segment_t;
+
+static _Atomic(stat_segment_t *) stat_seg;
+static atomic_int stat_on;
+static char stat_name[64];
+static pthread_key_t  stat_key;
+static pthread_once_t stat_key_once = PTHREAD_ONCE_INIT;
+static _Thread_local stat_slot_t    *stat_tls;
+static _Thread_local stat_segment_t *stat_tls_seg;
+// Слот потоков, которым не хватило места: счёт теряется
+static stat_slot_t stat_overflow;
+
+static void stat_segment_name(char *buf, size_t n, pid_t pid) {
+    snprintf(buf, n, "/bignum_sub_stat.%d", (int)pid);
+}
+
+/** Единственный писатель: обычная загрузка и запись, без lock-префикса. */
+static inline void stat_inc(_Atomic uint64_t *c) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/** Деструктор ключа: поток завершается — слот свободен для следующего. */
+static void stat_thread_exit(void *p) {
+    stat_slot_t *slot = p;
+    if (slot != &stat_overflow) atomic_store_explicit(&slot->state, SLOT_RETIRED, memory_order_release);
+}
+
+static void stat_key_create(void) {
+    pthread_key_create(&stat_key, stat_thread_exit);
+}
+
+static int stat_claim(stat_slot_t *slot, int from) {
+    return atomic_compare_exchange_strong(&slot->state, &from, SLOT_LIVE);
+}
+
+/** Захватывает слот текущего сегмента для потока. */
+static stat_slot_t *stat_acquire(stat_segment_t *seg) {
+    stat_slot_t *slot = &stat_overflow;
+    for (int from = SLOT_FREE; from <= SLOT_RETIRED && slot == &stat_overflow; from += SLOT_RETIRED) {
+        for (unsigned i = 0; i < BIGNUM_SUB_STAT_MAX_THREADS; ++i) {
+            if (stat_claim(&seg->slots[i], from)) {
+                slot = &seg->slots[i];
+                unsigned used = atomic_load(&seg->hdr.used);
+                while (used < i + 1 && !atomic_compare_exchange_weak(&seg->hdr.used, &used, i + 1)) {
+                }
+                atomic_store_explicit(&slot->tid, (int)syscall(SYS_gettid), memory_order_relaxed);
+                break;
+            }
+        }
+    }
+    pthread_once(&stat_key_once, stat_key_create);
+    pthread_setspecific(stat_key, slot);
+    stat_tls = slot;
+    stat_tls_seg = seg;
+    return slot;
+}
+
+/** Наибольшая длина цепочки слов, через которые прошло заимствование. */
+static unsigned stat_borrow_chain(const bignum_t *a, const bignum_t *b) {
+    unsigned best = 0, run = 0, borrow = 0;
+    for (size_t i = 0; i < a->len; ++i) {
+        uint64_t bw = i < b->len ? b->words[i] : 0;
+        unsigned next = a->words[i] < bw || (a->words[i] == bw && borrow);
+        run = next ? run + 1 : 0;
+        if (run > best) best = run;
+        borrow = next;
+    }
+    return best;
+}
+
+void bignum_sub_stat_hook(const bignum_t *a, const bignum_t *b, bignum_sub_status_t status) {
+    if (!atomic_load_explicit(&stat_on, memory_order_relaxed)) return;
+    stat_segment_t *seg = atomic_load_explicit(&stat_seg, memory_order_acquire);
+    stat_slot_t *slot = stat_tls;
+    if (stat_tls_seg != seg) slot = stat_acquire(seg);   // первый вызов потока или новый сегмент
+
+    stat_inc(&slot->calls);
+    unsigned st = (unsigned)-(int)status;
+    if (st < BIGNUM_SUB_STAT_STATUSES) stat_inc(&slot->status[st]);
+    if (a) stat_inc(&slot->len[a->len > BIGNUM_CAPACITY ? BIGNUM_CAPACITY + 1 : a->len]);
+    if (status == BIGNUM_SUB_SUCCESS) stat_inc(&slot->borrow[stat_borrow_chain(a, b)]);
+}
+
+int bignum_sub_stat_start(void) {
+#if BIGNUM_SUB_STATS
+    if (atomic_load(&stat_on)) return -1;
+    char name[sizeof(stat_name)];
+    stat_segment_name(name, sizeof(name), getpid());
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return -1;
+    // Оставшийся от прежнего процесса с тем же pid сегмент сохраняет свои права
+    if (fchmod(fd, 0600) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(stat_segment_t)) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+    stat_segment_t *seg = mmap(NULL, sizeof(*seg), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+        shm_unlink(name);
+        return -1;
+    }
+    // Сегмент свежий (O_TRUNC): слоты нулевые, т.е. свободные
+    seg->hdr.version = STAT_VERSION;
+    seg->hdr.slot_size = sizeof(stat_slot_t);
+    seg->hdr.max_slots = BIGNUM_SUB_STAT_MAX_THREADS;
+    seg->hdr.capacity = BIGNUM_CAPACITY;
+    atomic_thread_fence(memory_order_release);
+    memcpy(seg->hdr.magic, STAT_MAGIC, sizeof(seg->hdr.magic));   // читатель проверяет последним
+    memcpy(stat_name, name, sizeof(stat_name));
+    atomic_store_explicit(&stat_seg, seg, memory_order_release);
+    atomic_store_explicit(&stat_on, 1, memory_order_release);
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int bignum_sub_stat_stop(void) {
+    if (!atomic_exchange(&stat_on, 0)) return -1;
+    shm_unlink(stat_name);
+    return 0;
+}
+
+static void stat_atexit(void) {
+    if (atomic_load(&stat_on)) bignum_sub_stat_stop();
+}
+
+/** Автозапуск по переменной окружения BIGNUM_SUB_STAT. */
+__attribute__((constructor)) static void stat_autostart(void) {
+    const char *on = getenv("BIGNUM_SUB_STAT");
+    if (!on || !*on || *on == '0') return;
+    if (bignum_sub_stat_start() == 0) atexit(stat_atexit);
+}
+
+int bignum_sub_stat_open(bignum_sub_stat_reader_t *rd, pid_t pid) {
+    char name[sizeof(stat_name)];
+    struct stat sb;
+    rd->map = NULL;
+    rd->size = 0;
+    stat_segment_name(name, sizeof(name), pid);
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (fstat(fd, &sb) != 0 || (size_t)sb.st_size < sizeof(stat_segment_t)) {
+        close(fd);
+        return -1;
+    }
+    const stat_segment_t *seg = mmap(NULL, sizeof(*seg), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) return -1;
+    if (memcmp(seg->hdr.magic, STAT_MAGIC, sizeof(seg->hdr.magic)) != 0 ||
+        seg->hdr.version != STAT_VERSION || seg->hdr.slot_size != sizeof(stat_slot_t) ||
+        seg->hdr.max_slots != BIGNUM_SUB_STAT_MAX_THREADS || seg->hdr.capacity != BIGNUM_CAPACITY) {
+        munmap((void *)seg, sizeof(*seg));
+        return -1;
+    }
+    rd->map = seg;
+    rd->size = sizeof(*seg);
+    return 0;
+}
+
+static void stat_add(bignum_sub_stat_counts_t *dst, const stat_slot_t *s) {
+    dst->calls += atomic_load_explicit(&s->calls, memory_order_relaxed);
+    for (unsigned i = 0; i < BIGNUM_SUB_STAT_STATUSES; ++i) {
+        dst->status[i] += atomic_load_explicit(&s->status[i], memory_order_relaxed);
+    }
+    for (unsigned i = 0; i < BIGNUM_SUB_STAT_LEN_BINS; ++i) {
+        dst->len[i] += atomic_load_explicit(&s->len[i], memory_order_relaxed);
+    }
+    for (unsigned i = 0; i < BIGNUM_SUB_STAT_BORROW_BINS; ++i) {
+        dst->borrow[i] += atomic_load_explicit(&s->borrow[i], memory_order_relaxed);
+    }
+}
+
+unsigned bignum_sub_stat_read(const bignum_sub_stat_reader_t *rd, bignum_sub_stat_counts_t *total,
+                              bignum_sub_stat_counts_t *per_thread, pid_t *tids,
+                              unsigned max_threads) {
+    const stat_segment_t *seg = rd->map;
+    unsigned used = atomic_load_explicit(&((stat_segment_t *)seg)->hdr.used, memory_order_acquire);
+    unsigned n = 0;
+    if (total) memset(total, 0, sizeof(*total));
+    if (used > BIGNUM_SUB_STAT_MAX_THREADS) used = BIGNUM_SUB_STAT_MAX_THREADS;
+    for (unsigned i = 0; i < used; ++i) {
+        const stat_slot_t *s = &seg->slots[i];
+        if (atomic_load_explicit((atomic_int *)&s->state, memory_order_acquire) == SLOT_FREE) continue;
+        if (total) stat_add(total, s);
+        if (n < max_threads) {
+            if (per_thread) {
+                memset(&per_thread[n], 0, sizeof(per_thread[n]));
+                stat_add(&per_thread[n], s);
+            }
+            if (tids) tids[n] = atomic_load_explicit((atomic_int *)&s->tid, memory_order_relaxed);
+        }
+        n++;
+    }
+    return n;
+}
+
+void bignum_sub_stat_close(bignum_sub_stat_reader_t *rd) {
+    if (rd->map) munmap((void *)rd->map, rd->size);
+    rd->map = NULL;
+    rd->size = 0;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file    bignum_sub_trace.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Захват трассы вызовов bignum_sub в компактный бинарный файл и чтение трассы.
+ *
+ * @details
+ *   Горячий путь (bignum_sub_trace_hook) при выключенной записи — одна
+ *   relaxed-загрузка флага. При включённой — копирование записи в буфер
+ *   потока (thread-local, без атомарных операций); системный вызов
+ *   write(2) выполняется только при заполнении буфера.
+ *
+ *   Буферы хранятся в односвязном списке, который только растёт (вставка
+ *   CAS-ом в голову). Поток захватывает свободный буфер CAS-ом флага
+ *   in_use, а при завершении сбрасывает его и освобождает для других
+ *   потоков (деструктор ключа pthread). Формат и ограничения описаны в
+ *   bignum_sub_trace.h.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Автозапуск пропускается, если программа определила bignum_sub_trace_no_autostart.
+ */
+
+#define _GNU_SOURCE
+#include "bignum_sub_trace.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Размер буфера потока; запись с операндами занимает не более 4 + 2*256 байт
+#define TRACE_BUF_SIZE (64 * 1024)
+#define TRACE_LEN_MAX 255u
+
+typedef struct trace_buf {
+    struct trace_buf *next;      // список всех буферов (элементы не удаляются)
+    atomic_int        in_use;    // буфер принадлежит живому потоку
+    size_t            used;
+    unsigned char     data[TRACE_BUF_SIZE];
+} trace_buf_t;
+
+static _Atomic(trace_buf_t *) trace_bufs;
+static atomic_int   trace_on;
+static atomic_int   trace_fd = -1;
+static atomic_uint  trace_flags;
+static pthread_key_t  trace_key;
+static pthread_once_t trace_key_once = PTHREAD_ONCE_INIT;
+static _Thread_local trace_buf_t *trace_tls;
+
+/** Записывает `n` байт целиком; 0 при успехе. */
+static int trace_write_all(int fd, const void *p, size_t n) {
+    const unsigned char *c = p;
+    while (n > 0) {
+        ssize_t w = write(fd, c, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        c += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+static int trace_flush(trace_buf_t *buf) {
+    int fd = atomic_load_explicit(&trace_fd, memory_order_acquire);
+    int rc = 0;
+    if (buf->used > 0 && fd >= 0) rc = trace_write_all(fd, buf->data, buf->used);
+    buf->used = 0;
+    return rc;
+}
+
+/** Деструктор ключа: поток завершается — сбросить и освободить буфер. */
+static void trace_thread_exit(void *p) {
+    trace_buf_t *buf = p;
+    if (atomic_load_explicit(&trace_on, memory_order_acquire)) trace_flush(buf);
+    else buf->used = 0;
+    atomic_store_explicit(&buf->in_use, 0, memory_order_release);
+}
+
+static void trace_key_create(void) {
+    pthread_key_create(&trace_key, trace_thread_exit);
+}
+
+/** Захватывает свободный буфер или создаёт новый. */
+static trace_buf_t *trace_acquire(void) {
+    trace_buf_t *buf;
+    for (buf = atomic_load(&trace_bufs); buf; buf = buf->next) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&buf->in_use, &expected, 1)) break;
+    }
+    if (!buf) {
+        buf = calloc(1, sizeof(*buf));
+        if (!buf) return NULL;
+        atomic_init(&buf->in_use, 1);
+        buf->next = atomic_load(&trace_bufs);
+        while (!atomic_compare_exchange_weak(&trace_bufs, &buf->next, buf)) {
+        }
+    }
+    pthread_once(&trace_key_once, trace_key_create);
+    pthread_setspecific(trace_key, buf);
+    trace_tls = buf;
+    return buf;
+}
+
+static uint8_t trace_len(size_t len) {
+    return (uint8_t)(len > TRACE_LEN_MAX ? TRACE_LEN_MAX : len);
+}
+
+static size_t trace_words(size_t len) {
+    return len > BIGNUM_CAPACITY ? BIGNUM_CAPACITY : len;
+}
+
+static int trace_overlap(const void *p, const void *q) {
+    const char *x = p, *y = q;
+    const size_t n = sizeof(((bignum_t *)0)->words);
+    return x && y && x < y + n && y < x + n;
+}
+
+void bignum_sub_trace_hook(const bignum_t *result, const bignum_t *a, const bignum_t *b,
+                           bignum_sub_status_t status) {
+    if (!atomic_load_explicit(&trace_on, memory_order_relaxed)) return;
+    trace_buf_t *buf = trace_tls;
+    if (!buf && !(buf = trace_acquire())) return;
+
+    bignum_sub_trace_rec_t rec;
+    size_t wa = 0, wb = 0;
+    rec.len_a = a ? trace_len(a->len) : 0;
+    rec.len_b = b ? trace_len(b->len) : 0;
+    rec.status = (int8_t)status;
+    rec.flags = (uint8_t)((!result ? BIGNUM_SUB_TRACE_REC_NULL_R : 0) |
+                          (!a ? BIGNUM_SUB_TRACE_REC_NULL_A : 0) |
+                          (!b ? BIGNUM_SUB_TRACE_REC_NULL_B : 0) |
+                          (trace_overlap(result, a) ? BIGNUM_SUB_TRACE_REC_ALIAS_A : 0) |
+                          (trace_overlap(result, b) ? BIGNUM_SUB_TRACE_REC_ALIAS_B : 0));
+    if (!(atomic_load_explicit(&trace_flags, memory_order_relaxed) & BIGNUM_SUB_TRACE_SHAPES_ONLY)) {
+        rec.flags |= BIGNUM_SUB_TRACE_REC_OPERANDS;
+        wa = a ? trace_words(a->len) : 0;
+        wb = b ? trace_words(b->len) : 0;
+    }
+
+    size_t need = sizeof(rec) + (wa + wb) * sizeof(uint64_t);
+    if (buf->used + need > TRACE_BUF_SIZE) trace_flush(buf);
+    unsigned char *p = buf->data + buf->used;
+    memcpy(p, &rec, sizeof(rec));
+    p += sizeof(rec);
+    if (wa) memcpy(p, a->words, wa * sizeof(uint64_t));
+    p += wa * sizeof(uint64_t);
+    if (wb) memcpy(p, b->words, wb * sizeof(uint64_t));
+    buf->used += need;
+}
+
+int bignum_sub_trace_start(const char *path, unsigned flags) {
+    if (!path || atomic_load(&trace_on)) return -1;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    bignum_sub_trace_header_t hdr;
+    memcpy(hdr.magic, BIGNUM_SUB_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = BIGNUM_SUB_TRACE_VERSION;
+    hdr.flags = flags;
+    hdr.capacity = BIGNUM_CAPACITY;
+    hdr.word_size = sizeof(uint64_t);
+    if (trace_write_all(fd, &hdr, sizeof(hdr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    atomic_store(&trace_flags, flags);
+    atomic_store_explicit(&trace_fd, fd, memory_order_release);
+    atomic_store_explicit(&trace_on, 1, memory_order_release);
+    return 0;
+}
+
+int bignum_sub_trace_stop(void) {
+    if (!atomic_exchange(&trace_on, 0)) return -1;
+    int rc = 0;
+    for (trace_buf_t *buf = atomic_load(&trace_bufs); buf; buf = buf->next) {
+        if (trace_flush(buf) != 0) rc = -1;
+    }
+    int fd = atomic_exchange(&trace_fd, -1);
+    if (close(fd) != 0) rc = -1;
+    return rc;
+}
+
+static void trace_atexit(void) {
+    if (atomic_load(&trace_on)) bignum_sub_trace_stop();
+}
+
+/** Определяется программой, которой автозапуск не нужен; иначе адрес — NULL. */
+extern const int bignum_sub_trace_no_autostart __attribute__((weak));
+
+/** Автозапуск по переменным окружения BIGNUM_SUB_TRACE / BIGNUM_SUB_TRACE_SHAPES. */
+__attribute__((constructor)) static void trace_autostart(void) {
+    if (&bignum_sub_trace_no_autostart && bignum_sub_trace_no_autostart) return;
+    const char *path = getenv("BIGNUM_SUB_TRACE");
+    if (!path || !*path) return;
+    const char *shapes = getenv("BIGNUM_SUB_TRACE_SHAPES");
+    unsigned flags = (shapes && *shapes && *shapes != '0') ? BIGNUM_SUB_TRACE_SHAPES_ONLY : 0;
+    if (bignum_sub_trace_start(path, flags) == 0) atexit(trace_atexit);
+}
+
+int bignum_sub_trace_open(bignum_sub_trace_reader_t *rd, const char *path) {
+    rd->f = fopen(path, "rb");
+    if (!rd->f) return -1;
+    if (fread(&rd->hdr, sizeof(rd->hdr), 1, rd->f) != 1 ||
+        memcmp(rd->hdr.magic, BIGNUM_SUB_TRACE_MAGIC, sizeof(rd->hdr.magic)) != 0 ||
+        rd->hdr.version != BIGNUM_SUB_TRACE_VERSION || rd->hdr.capacity != BIGNUM_CAPACITY ||
+        rd->hdr.word_size != sizeof(uint64_t)) {
+        fclose(rd->f);
+        rd->f = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int bignum_sub_trace_next(bignum_sub_trace_reader_t *rd, bignum_sub_trace_rec_t *rec,
+                          bignum_t *a, bignum_t *b) {
+    size_t n = fread(rec, 1, sizeof(*rec), rd->f);
+    if (n == 0 && feof(rd->f)) return 0;
+    if (n != sizeof(*rec)) return -1;
+    memset(a, 0, sizeof(*a));
+    memset(b, 0, sizeof(*b));
+    a->len = rec->len_a;
+    b->len = rec->len_b;
+    if (rec->flags & BIGNUM_SUB_TRACE_REC_OPERANDS) {
+        size_t wa = trace_words(rec->len_a), wb = trace_words(rec->len_b);
+        if (fread(a->words, sizeof(uint64_t), wa, rd->f) != wa ||
+            fread(b->words, sizeof(uint64_t), wb, rd->f) != wb) {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+void bignum_sub_trace_close(bignum_sub_trace_reader_t *rd) {
+    if (rd->f) fclose(rd->f);
+    rd->f = NULL;
+}
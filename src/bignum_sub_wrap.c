@@ -0,0 +1,36 @@
+/**
+ * @file    bignum_sub_wrap.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Обёртка `__wrap_bignum_sub` для инструментирования (линковка с -Wl,--wrap=bignum_sub).
+ *
+ * @details
+ *   Линкер перенаправляет на эту функцию все внешние вызовы `bignum_sub`,
+ *   а `__real_bignum_sub` указывает на ассемблерную реализацию. Обёртка
+ *   вызывает ядро и передаёт результат в подключённые хуки.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание, хук трассировки.
+ *   - rev. 2 (17.10.2026): Хук счётчиков по потокам (отключается BIGNUM_SUB_STATS=0).
+ *   - rev. 3 (17.10.2026): Хук бортового самописца.
+ */
+
+#include "bignum_sub.h"
+#include "bignum_sub_flight.h"
+#include "bignum_sub_stat.h"
+#include "bignum_sub_trace.h"
+
+bignum_sub_status_t __real_bignum_sub(bignum_t *result, const bignum_t *a, const bignum_t *b);
+bignum_sub_status_t __wrap_bignum_sub(bignum_t *result, const bignum_t *a, const bignum_t *b);
+
+bignum_sub_status_t __wrap_bignum_sub(bignum_t *result, const bignum_t *a, const bignum_t *b) {
+    bignum_sub_status_t status = __real_bignum_sub(result, a, b);
+#if BIGNUM_SUB_STATS
+    bignum_sub_stat_hook(a, b, status);
+#endif
+    bignum_sub_trace_hook(result, a, b, status);
+    bignum_sub_flight_hook(result, a, b, status);
+    return status;
+}
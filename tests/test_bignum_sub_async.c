@@ -0,0 +1,229 @@
+/**
+ * @file    test_bignum_sub_async.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты асинхронного сервиса bignum_sub (bignum_sub_async.h).
+ *
+ * @details
+ *   Проверяется, что заявки дают тот же результат и код возврата, что и
+ *   прямой вызов (включая ошибки), при ожидании опросом и через futex, с
+ *   несколькими производителями и рабочими потоками; что notify вызывается
+ *   для каждой заявки; что заполненное кольцо отклоняет заявку, а
+ *   bignum_sub_async_destroy() выполняет всё поставленное до остановки.
+ *
+ * @note    Для сборки требуется флаг `-pthread`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#include "bignum_sub.h"
+#include "bignum_sub_async.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_PRODUCERS 4
+#define CALLS_PER_PRODUCER 20000
+#define WINDOW 16
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static void bignum_set(bignum_t *x, size_t len, uint64_t seed) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) x->words[i] = seed * 0x9E3779B97F4A7C15ull + i;
+    if (len > 0 && x->words[len - 1] == 0) x->words[len - 1] = 1;
+    x->len = len;
+}
+
+/** Заявка совпадает с прямым вызовом на тех же операндах. */
+static int same_as_direct(const bignum_t *r, const bignum_t *a, const bignum_t *b, bignum_sub_status_t st) {
+    bignum_t want;
+    memset(&want, 0, sizeof(want));
+    if (bignum_sub(&want, a, b) != st) return 0;
+    return st != BIGNUM_SUB_SUCCESS || memcmp(r, &want, sizeof(want)) == 0;
+}
+
+int test_async_single() {
+    bignum_sub_async_t *svc = bignum_sub_async_create(NULL);
+    if (!svc) return 0;
+    bignum_t a, b, r;
+    bignum_sub_completion_t c;
+    memset(&c, 0, sizeof(c));
+    int ok = 1;
+    bignum_set(&a, 7, 1);
+    bignum_set(&b, 3, 2);
+    ok = ok && bignum_sub_async_submit(svc, &r, &a, &b, &c) == 0;
+    ok = ok && bignum_sub_async_wait(&c, 0) == BIGNUM_SUB_SUCCESS && bignum_sub_async_poll(&c);
+    ok = ok && same_as_direct(&r, &a, &b, c.status);
+    // Ошибки ядра возвращаются статусом заявки
+    ok = ok && bignum_sub_async_submit(svc, &r, &b, &a, &c) == 0;
+    while (ok && !bignum_sub_async_poll(&c)) sched_yield();
+    ok = ok && c.status == BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    ok = ok && bignum_sub_async_submit(svc, &r, NULL, &a, &c) == 0;
+    ok = ok && bignum_sub_async_wait(&c, 100) == BIGNUM_SUB_ERROR_NULL_PTR;
+    ok = ok && bignum_sub_async_submit(svc, &a, &a, &b, &c) == 0;
+    ok = ok && bignum_sub_async_wait(&c, 100) == BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
+    bignum_sub_async_counters_t cnt;
+    bignum_sub_async_counters(svc, &cnt);
+    ok = ok && cnt.calls == 4 && cnt.batches >= 1 && cnt.batches <= 4;
+    bignum_sub_async_destroy(svc);
+    return ok;
+}
+
+typedef struct {
+    bignum_sub_async_t *svc;
+    unsigned            id;
+    int                 ok;
+} producer_arg_t;
+
+/** Окно из WINDOW заявок: ждём самую старую, сверяем, ставим следующую. */
+static void *producer(void *arg) {
+    producer_arg_t *p = arg;
+    static _Thread_local bignum_t a[WINDOW], b[WINDOW], r[WINDOW];
+    bignum_sub_completion_t c[WINDOW];
+    memset(c, 0, sizeof(c));
+    p->ok = 1;
+    for (unsigned i = 0; i < CALLS_PER_PRODUCER + WINDOW && p->ok; ++i) {
+        unsigned k = i % WINDOW;
+        if (i >= WINDOW) {
+            bignum_sub_status_t st = (i & 1) ? bignum_sub_async_wait(&c[k], 64) : bignum_sub_async_wait(&c[k], 0);
+            p->ok = same_as_direct(&r[k], &a[k], &b[k], st);
+        }
+        if (i >= CALLS_PER_PRODUCER) continue;
+        uint64_t seed = (uint64_t)p->id * CALLS_PER_PRODUCER + i;
+        bignum_set(&a[k], 1 + seed % BIGNUM_CAPACITY, seed);
+        bignum_set(&b[k], seed % (a[k].len + 1), ~seed);
+        if (b[k].len == a[k].len && (seed & 7) != 0) b[k].words[b[k].len - 1] = a[k].words[a[k].len - 1] - 1;
+        while (bignum_sub_async_submit(p->svc, &r[k], &a[k], &b[k], &c[k]) != 0) sched_yield();
+    }
+    return NULL;
+}
+
+int test_async_producers() {
+    bignum_sub_async_config_t cfg = { .workers = 2, .ring_size = 64, .batch = 16, .spin = 256, .cpus = NULL };
+    bignum_sub_async_t *svc = bignum_sub_async_create(&cfg);
+    if (!svc) return 0;
+    pthread_t th[NUM_PRODUCERS];
+    producer_arg_t args[NUM_PRODUCERS];
+    for (unsigned t = 0; t < NUM_PRODUCERS; ++t) {
+        args[t].svc = svc;
+        args[t].id = t;
+        pthread_create(&th[t], NULL, producer, &args[t]);
+    }
+    int ok = 1;
+    for (unsigned t = 0; t < NUM_PRODUCERS; ++t) {
+        pthread_join(th[t], NULL);
+        ok = ok && args[t].ok;
+    }
+    bignum_sub_async_counters_t cnt;
+    bignum_sub_async_counters(svc, &cnt);
+    bignum_sub_async_destroy(svc);
+    printf("  %llu calls in %llu batches, %llu worker sleeps, %llu waiter wakeups\n",
+           (unsigned long long)cnt.calls, (unsigned long long)cnt.batches,
+           (unsigned long long)cnt.sleeps, (unsigned long long)cnt.wakeups);
+    return ok && cnt.calls == (uint64_t)NUM_PRODUCERS * CALLS_PER_PRODUCER;
+}
+
+static atomic_uint notified;
+
+static void on_done(bignum_sub_completion_t *c) {
+    if (c->status == BIGNUM_SUB_SUCCESS && c->user == (void *)c) atomic_fetch_add(&notified, 1);
+}
+
+int test_async_notify_and_drain() {
+    enum { N = 512 };
+    static bignum_t a[N], b[N], r[N];
+    static bignum_sub_completion_t c[N];
+    bignum_sub_async_config_t cfg = { .workers = 1, .ring_size = 1024, .batch = 0, .spin = 0, .cpus = NULL };
+    bignum_sub_async_t *svc = bignum_sub_async_create(&cfg);
+    if (!svc) return 0;
+    for (unsigned i = 0; i < N; ++i) {
+        bignum_set(&a[i], 1 + i % BIGNUM_CAPACITY, i);
+        bignum_set(&b[i], 1, i);
+        b[i].words[0] = 1;
+        c[i].notify = on_done;
+        c[i].user = &c[i];
+        if (bignum_sub_async_submit(svc, &r[i], &a[i], &b[i], &c[i]) != 0) {
+            bignum_sub_async_destroy(svc);
+            return 0;
+        }
+    }
+    // Уничтожение сразу после постановки: все заявки выполнены, notify вызван для каждой
+    bignum_sub_async_destroy(svc);
+    if (atomic_load(&notified) != N) return 0;
+    for (unsigned i = 0; i < N; ++i) {
+        if (!same_as_direct(&r[i], &a[i], &b[i], c[i].status)) return 0;
+    }
+    return 1;
+}
+
+static pthread_mutex_t gate_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int worker_held;
+
+/** notify, задерживающий рабочий поток, пока тест не отпустит gate_lock. */
+static void hold_worker(bignum_sub_completion_t *c) {
+    (void)c;
+    atomic_store(&worker_held, 1);
+    pthread_mutex_lock(&gate_lock);
+    pthread_mutex_unlock(&gate_lock);
+}
+
+int test_async_ring_full() {
+    enum { RING = 8 };
+    bignum_sub_async_config_t cfg = { .workers = 1, .ring_size = RING, .batch = 1, .spin = 0, .cpus = NULL };
+    bignum_sub_async_t *svc = bignum_sub_async_create(&cfg);
+    if (!svc) return 0;
+    static bignum_t a, b, r[RING + 2];
+    static bignum_sub_completion_t c[RING + 2];
+    bignum_set(&a, 4, 1);
+    bignum_set(&b, 2, 2);
+    pthread_mutex_lock(&gate_lock);
+    c[0].notify = hold_worker;
+    int ok = bignum_sub_async_submit(svc, &r[0], &a, &b, &c[0]) == 0;
+    // Рабочий поток стоит в notify первой заявки (её запись уже освобождена): кольцо пусто и не разбирается
+    while (ok && !atomic_load(&worker_held)) sched_yield();
+    for (unsigned i = 1; i <= RING && ok; ++i) ok = bignum_sub_async_submit(svc, &r[i], &a, &b, &c[i]) == 0;
+    ok = ok && bignum_sub_async_submit(svc, &r[RING + 1], &a, &b, &c[RING + 1]) == -1;
+    pthread_mutex_unlock(&gate_lock);
+    for (unsigned i = 1; i <= RING && ok; ++i) ok = bignum_sub_async_wait(&c[i], 0) == BIGNUM_SUB_SUCCESS;
+    ok = ok && bignum_sub_async_submit(svc, &r[RING + 1], &a, &b, &c[RING + 1]) == 0;
+    ok = ok && bignum_sub_async_wait(&c[RING + 1], 0) == BIGNUM_SUB_SUCCESS;
+    bignum_sub_async_destroy(svc);
+    return ok;
+}
+
+int main() {
+    printf("\n--- Launching Async Service Tests for bignum_sub  ---\n");
+
+    RUN_TEST(test_async_single);
+    RUN_TEST(test_async_producers);
+    RUN_TEST(test_async_notify_and_drain);
+    RUN_TEST(test_async_ring_full);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file    test_bignum_sub_constexpr.cpp
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты constexpr-реализации bignum_sub (bignum_sub_constexpr.hpp).
+ *
+ * @details
+ *   Часть проверок — static_assert: константы, коды возврата и
+ *   нормализация вычисляются компилятором. Во время выполнения
+ *   bn::constexpr_sub() сверяется с ассемблерным ядром на случайных и
+ *   граничных входах (включая ненормализованные операнды, len = 0 и
+ *   len > BIGNUM_CAPACITY, перекрытие буферов): код возврата и весь
+ *   результат, в том числе неизменность при ошибке, должны совпадать.
+ *   Успешный результат дополнительно проверяется независимо от ядра:
+ *   r + b == a (mod 2^(64 * a.len)) пословным сложением. Константы, посчитанные при
+ *   компиляции, сверяются с вызовом ядра.
+ *
+ * @note    Для сборки требуется `-std=c++20`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Проверка r + b == a, не зависящая от ядра.
+ */
+
+#include "bignum_sub_constexpr.hpp"
+#include <cstdio>
+#include <cstring>
+
+#define NUM_ITERATIONS 50000
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+/* --- Проверки времени компиляции --- */
+
+// 2^256 - 1: заём проходит через все четыре слова
+constexpr bignum_t kTwo256 = bn::make_bignum({0, 0, 0, 0, 1});
+constexpr bignum_t kOne = bn::make_bignum({1});
+constexpr bignum_t kMax256 = bn::const_sub(kTwo256, kOne);
+static_assert(kMax256.len == 4 && kMax256.words[0] == ~0ull && kMax256.words[3] == ~0ull && kMax256.words[4] == 0);
+
+// Нормализация и ноль
+static_assert(bn::make_bignum({5, 0, 0}).len == 1);
+static_assert(bn::make_bignum({}).len == 1 && bn::make_bignum({}).words[0] == 0);
+static_assert(bn::const_sub(kTwo256, kTwo256).len == 1 && bn::const_sub(kTwo256, kTwo256).words[0] == 0);
+
+/** Код возврата bn::sub в константном вычислении. */
+constexpr bignum_sub_status_t status_of(bignum_t a, bignum_t b) {
+    bignum_t r{};
+    return bn::sub(&r, &a, &b);
+}
+
+constexpr bignum_sub_status_t status_aliased() {
+    bignum_t a = bn::make_bignum({3});
+    bignum_t b = bn::make_bignum({1});
+    return bn::sub(&a, &a, &b);
+}
+
+constexpr bignum_sub_status_t status_null() {
+    bignum_t r{};
+    const bignum_t a = bn::make_bignum({3});
+    return bn::sub(&r, &a, nullptr);
+}
+
+constexpr bignum_t with_len(bignum_t x, std::size_t len) {
+    x.len = len;
+    return x;
+}
+
+static_assert(status_of(kTwo256, kOne) == BIGNUM_SUB_SUCCESS);
+static_assert(status_of(kOne, kTwo256) == BIGNUM_SUB_ERROR_NEGATIVE_RESULT);
+static_assert(status_of(with_len(kOne, 0), bn::make_bignum({})) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED);
+static_assert(status_of(kTwo256, with_len(kOne, BIGNUM_CAPACITY + 1)) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED);
+static_assert(status_aliased() == BIGNUM_SUB_ERROR_BUFFER_OVERLAP);
+static_assert(status_null() == BIGNUM_SUB_ERROR_NULL_PTR);
+// b->len = 0 допустимо
+static_assert(status_of(kOne, with_len(kOne, 0)) == BIGNUM_SUB_SUCCESS);
+
+/** Константа, которую компилятор обязан посчитать сам (constinit): 2^64 * 7 - 5. */
+constinit bignum_t kFolded = bn::const_sub(bn::make_bignum({0, 7}), bn::make_bignum({5}));
+
+/* --- Сверка с ядром во время выполнения --- */
+
+static uint64_t rng_state = 0x6A09E667F3BCC909ull;
+
+static uint64_t rng_next() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/** Операнд со случайной длиной и словами; иногда ненормализованный или с длиной вне контракта. */
+static void random_operand(bignum_t *x, size_t len) {
+    for (size_t i = 0; i < BIGNUM_CAPACITY; ++i) x->words[i] = rng_next();
+    switch (rng_next() % 8) {
+    case 0: if (len > 0) x->words[len - 1] = 0; break;      // ведущий ноль
+    case 1: for (size_t i = 0; i < len; ++i) x->words[i] = ~0ull; break;
+    case 2: for (size_t i = 0; i < len; ++i) x->words[i] = 0; break;
+    default: break;
+    }
+    x->len = len;
+}
+
+/**
+ * r + b == a (mod 2^(64 * a.len)) пословным сложением: проверка результата
+ * без ядра. Модуль нужен для ненормализованного a: правило длины
+ * bignum_cmp пропускает a < b, если у a ведущие нули, и заём уходит за
+ * старшее слово. Слова результата выше a.len — нули.
+ */
+static bool adds_back(const bignum_t &r, const bignum_t &b, const bignum_t &a) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < BIGNUM_CAPACITY; ++i) {
+        if (i >= a.len) {
+            if (r.words[i] != 0) return false;
+            continue;
+        }
+        uint64_t x = i < r.len ? r.words[i] : 0, y = i < b.len ? b.words[i] : 0;
+        uint64_t s = x + y, c = s < x;
+        s += carry;
+        carry = c | (s < carry);
+        if (s != a.words[i]) return false;
+    }
+    return r.len >= 1 && r.len <= a.len;
+}
+
+/**
+ * Одинаковые входы и "отравленный" результат для обеих реализаций;
+ * совпадают код и все байты, а успешный результат проходит adds_back().
+ */
+static bool agree(const bignum_t &a, const bignum_t &b) {
+    bignum_t r_asm, r_ce;
+    memset(&r_asm, 0xA5, sizeof(r_asm));
+    memset(&r_ce, 0xA5, sizeof(r_ce));
+    bignum_sub_status_t st_asm = bignum_sub(&r_asm, &a, &b);
+    bignum_sub_status_t st_ce = bn::constexpr_sub(&r_ce, &a, &b);
+    if (st_ce == BIGNUM_SUB_SUCCESS && !adds_back(r_ce, b, a)) return false;
+    return st_asm == st_ce && memcmp(&r_asm, &r_ce, sizeof(r_asm)) == 0;
+}
+
+int test_constexpr_random() {
+    static bignum_t a, b;
+    unsigned seen[5] = { 0 };
+    for (unsigned it = 0; it < NUM_ITERATIONS; ++it) {
+        size_t la = rng_next() % (BIGNUM_CAPACITY + 2);
+        size_t lb = (it & 1) ? la : rng_next() % (BIGNUM_CAPACITY + 2);
+        random_operand(&a, la);
+        random_operand(&b, lb);
+        // Близкие значения: общий старший префикс
+        if (it % 4 == 0 && la == lb && la > 0 && la <= BIGNUM_CAPACITY) {
+            size_t keep = rng_next() % la;
+            for (size_t i = la - 1; i > keep; --i) b.words[i] = a.words[i];
+        }
+        if (!agree(a, b)) {
+            printf("  mismatch: a->len %zu, b->len %zu\n", la, lb);
+            return 0;
+        }
+        bignum_t r;
+        seen[-bn::constexpr_sub(&r, &a, &b)]++;
+    }
+    printf("  statuses: ok %u, negative %u, capacity %u\n", seen[0], seen[2], seen[3]);
+    return seen[0] > 0 && seen[2] > 0 && seen[3] > 0;
+}
+
+int test_constexpr_pointers() {
+    static bignum_t buf[3];
+    buf[0] = bn::make_bignum({9, 9});
+    buf[1] = bn::make_bignum({4});
+    bignum_t r = buf[2];
+    bool ok = bn::constexpr_sub(nullptr, &buf[0], &buf[1]) == bignum_sub(nullptr, &buf[0], &buf[1]);
+    ok = ok && bn::constexpr_sub(&r, nullptr, &buf[1]) == BIGNUM_SUB_ERROR_NULL_PTR;
+    // Перекрытие: совпадающие адреса и частичное пересечение слов; соседние элементы массива не пересекаются
+    ok = ok && bn::constexpr_sub(&buf[0], &buf[0], &buf[1]) == bignum_sub(&buf[0], &buf[0], &buf[1]);
+    ok = ok && bn::constexpr_sub(&buf[0], &buf[0], &buf[1]) == BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
+    ok = ok && bn::constexpr_sub(&buf[2], &buf[0], &buf[1]) == BIGNUM_SUB_SUCCESS;
+    static union {
+        bignum_t      x;
+        unsigned char bytes[2 * sizeof(bignum_t)];
+    } arena;
+    arena.x = buf[0];
+    bignum_t *shifted = reinterpret_cast<bignum_t *>(arena.bytes + 8 * 8);
+    ok = ok && bn::constexpr_sub(shifted, &arena.x, &buf[1]) == bignum_sub(shifted, &arena.x, &buf[1]);
+    ok = ok && bn::constexpr_sub(shifted, &arena.x, &buf[1]) == BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
+    // bn::sub во время выполнения — ядро
+    ok = ok && bn::sub(&r, &buf[0], &buf[1]) == BIGNUM_SUB_SUCCESS && r.len == 2 && r.words[0] == 5;
+    return ok;
+}
+
+int test_constexpr_folded() {
+    // Те же константы через ядро во время выполнения
+    bignum_t a = bn::make_bignum({0, 7}), b = bn::make_bignum({5}), r;
+    bool ok = bignum_sub(&r, &a, &b) == BIGNUM_SUB_SUCCESS && memcmp(&r, &kFolded, sizeof(r)) == 0;
+    a = kTwo256;
+    b = kOne;
+    ok = ok && bignum_sub(&r, &a, &b) == BIGNUM_SUB_SUCCESS && memcmp(&r, &kMax256, sizeof(r)) == 0;
+    return ok;
+}
+
+int main() {
+    printf("\n--- Launching constexpr Implementation Tests for bignum_sub  ---\n");
+
+    RUN_TEST(test_constexpr_random);
+    RUN_TEST(test_constexpr_pointers);
+    RUN_TEST(test_constexpr_folded);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file    test_bignum_sub_expr.cpp
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты шаблонов выражений bn::num (bignum_sub_expr.hpp).
+ *
+ * @details
+ *   Слитое вычисление цепочек вычитаний сравнивается с цепочкой вызовов
+ *   bignum_sub: результат, длина, хвост и код возврата должны совпадать.
+ *   Смешанные выражения с `+` сравниваются с эталонным сложением и той же
+ *   цепочкой. Проверяются коды ошибок, неизменность приёмника при ошибке,
+ *   исключение sub_error, скобки и совпадение приёмника с операндом.
+ *
+ * @note    Для сборки требуется `-std=c++20`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#include "bignum_sub_expr.hpp"
+#include <cstdio>
+#include <cstring>
+
+#define NUM_ITERATIONS 20000
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static uint64_t rng_state = 0x243F6A8885A308D3ull;
+
+static uint64_t rng_next() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/** Случайное нормализованное число длины len; со старшим словом не больше top. */
+static void random_num(bn::num &x, size_t len, uint64_t top) {
+    memset(&x.v, 0, sizeof(x.v));
+    for (size_t i = 0; i < len; ++i) x.v.words[i] = rng_next();
+    if (len > 0) x.v.words[len - 1] = 1 + rng_next() % top;
+    x.v.len = len;
+}
+
+/** Эталонное сложение в r (длины < BIGNUM_CAPACITY, перенос помещается). */
+static void ref_add(bignum_t *r, const bignum_t *a, const bignum_t *b) {
+    size_t len = a->len > b->len ? a->len : b->len;
+    unsigned carry = 0;
+    memset(r, 0, sizeof(*r));
+    for (size_t i = 0; i < len; ++i) {
+        uint64_t x = i < a->len ? a->words[i] : 0, y = i < b->len ? b->words[i] : 0;
+        uint64_t s = x + y;
+        unsigned c1 = s < x;
+        r->words[i] = s + carry;
+        carry = c1 | (r->words[i] < s);
+    }
+    r->words[len] = carry;
+    r->len = len + carry;
+}
+
+/** Цепочка вызовов bignum_sub: x0 - x1 - ... ; первый код ошибки прерывает цепочку. */
+static bignum_sub_status_t chain_sub(bignum_t *r, const bignum_t *const *xs, size_t n) {
+    bignum_t acc = *xs[0], t;
+    for (size_t j = 1; j < n; ++j) {
+        bignum_sub_status_t st = bignum_sub(&t, &acc, xs[j]);
+        if (st != BIGNUM_SUB_SUCCESS) return st;
+        acc = t;
+    }
+    *r = acc;
+    return BIGNUM_SUB_SUCCESS;
+}
+
+static bool same(const bignum_t &x, const bignum_t &y) {
+    return memcmp(&x, &y, sizeof(x)) == 0;
+}
+
+int test_expr_chains() {
+    bn::num x[5], r;
+    const bignum_t *xs[5] = { &x[0].v, &x[1].v, &x[2].v, &x[3].v, &x[4].v };
+    bool ok = true;
+    unsigned negative = 0;
+    for (unsigned it = 0; it < NUM_ITERATIONS && ok; ++it) {
+        size_t la = 1 + rng_next() % BIGNUM_CAPACITY;
+        random_num(x[0], la, ~0ull >> (rng_next() % 4));
+        for (unsigned j = 1; j < 5; ++j) {
+            // Каждое вычитаемое не больше уменьшаемого, сумма нескольких — бывает больше
+            size_t lb = (rng_next() % 3 == 0) ? la : rng_next() % (la + 1);
+            random_num(x[j], lb, (lb == la) ? 1 + x[0].v.words[la - 1] / 2 : ~0ull);
+        }
+        bignum_t want{};
+        unsigned n = 2 + it % 4;
+        bignum_sub_status_t st_want = chain_sub(&want, xs, n);
+        bignum_sub_status_t st = BIGNUM_SUB_SUCCESS;
+        switch (n) {
+        case 2: st = r.assign(x[0] - x[1]); break;
+        case 3: st = r.assign(x[0] - x[1] - x[2]); break;
+        case 4: st = r.assign(x[0] - x[1] - x[2] - x[3]); break;
+        default: st = r.assign(x[0] - x[1] - x[2] - x[3] - x[4]); break;
+        }
+        // Все вычитаемые неотрицательны: промежуточный минус означает минус в итоге
+        ok = st == st_want && (st != BIGNUM_SUB_SUCCESS || same(r.v, want));
+        negative += st == BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    }
+    printf("  %u negative chains of %u\n", negative, NUM_ITERATIONS);
+    return ok && negative > 0 && negative < NUM_ITERATIONS;
+}
+
+int test_expr_mixed() {
+    bn::num a, b, c, d, r;
+    bool ok = true;
+    for (unsigned it = 0; it < NUM_ITERATIONS && ok; ++it) {
+        size_t len = 1 + rng_next() % (BIGNUM_CAPACITY - 1);
+        random_num(a, len, ~0ull);
+        random_num(b, 1 + rng_next() % len, ~0ull);
+        random_num(c, rng_next() % (len + 1), ~0ull);
+        random_num(d, 1 + rng_next() % len, ~0ull);
+        // a - b - c + d == (a + d) - b - c; знак проверяется только у итога
+        bignum_t ad, want{};
+        ref_add(&ad, &a.v, &d.v);
+        const bignum_t *xs[3] = { &ad, &b.v, &c.v };
+        bignum_sub_status_t st_want = chain_sub(&want, xs, 3);
+        bignum_sub_status_t st = r.assign(a - b - c + d);
+        ok = st == st_want && (st != BIGNUM_SUB_SUCCESS || same(r.v, want));
+        // Скобки меняют знаки поддерева
+        bn::num p;
+        ok = ok && p.assign(a + d - (b + c)) == st && (st != BIGNUM_SUB_SUCCESS || same(p.v, want));
+    }
+    return ok;
+}
+
+int test_expr_statuses() {
+    bn::num a, b, c, r;
+    random_num(a, 3, 5);
+    random_num(b, 4, 5);
+    random_num(c, 4, ~0ull);
+    c.v.words[3] = b.v.words[3] + 1;
+    random_num(r, 2, 7);
+    const bn::num saved = r;
+    bool ok = r.assign(a - b) == BIGNUM_SUB_ERROR_NEGATIVE_RESULT && same(r.v, saved.v);
+    // a < b, но итог a - b + c неотрицателен
+    ok = ok && r.assign(a - b + c) == BIGNUM_SUB_SUCCESS && r.v.len >= 1;
+    ok = ok && r.assign(a - a) == BIGNUM_SUB_SUCCESS && r.v.len == 1 && r.v.words[0] == 0;
+
+    bn::num big;
+    for (size_t i = 0; i < BIGNUM_CAPACITY; ++i) big.v.words[i] = ~0ull;
+    big.v.len = BIGNUM_CAPACITY;
+    bn::num one;
+    one.v.words[0] = 1;
+    r = saved;
+    ok = ok && r.assign(big + one) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED && same(r.v, saved.v);
+    ok = ok && r.assign(big + one - one) == BIGNUM_SUB_SUCCESS && same(r.v, big.v);
+    bn::num bad = a;
+    bad.v.len = BIGNUM_CAPACITY + 1;
+    ok = ok && r.assign(a - bad) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    bad.v.len = 0;
+    ok = ok && r.assign(bad - one) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED && r.assign(a - bad) == BIGNUM_SUB_SUCCESS;
+
+    // Оператор = сообщает ошибку исключением и не меняет приёмник
+    bool thrown = false;
+    r = saved;
+    try {
+        r = a - b;
+    } catch (const bn::sub_error &e) {
+        thrown = e.status() == BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    }
+    return ok && thrown && same(r.v, saved.v);
+}
+
+int test_expr_aliasing() {
+    bn::num x, y, z;
+    bool ok = true;
+    for (unsigned it = 0; it < 1000 && ok; ++it) {
+        random_num(x, BIGNUM_CAPACITY, ~0ull);
+        random_num(y, 1 + rng_next() % (BIGNUM_CAPACITY - 1), ~0ull);
+        random_num(z, 1 + rng_next() % (BIGNUM_CAPACITY - 1), ~0ull);
+        bignum_t want{};
+        const bignum_t *xs[3] = { &x.v, &y.v, &z.v };
+        ok = chain_sub(&want, xs, 3) == BIGNUM_SUB_SUCCESS;
+        x = x - y - z;
+        ok = ok && same(x.v, want);
+        bn::num w = x;
+        w -= y;
+        w += y;
+        ok = ok && same(w.v, want);
+        // Сырой bignum_t как операнд и конструктор из выражения
+        bn::num s = bn::ref(want) - y + y;
+        ok = ok && same(s.v, want);
+    }
+    return ok;
+}
+
+int main() {
+    printf("\n--- Launching Expression Template Tests for bignum_sub  ---\n");
+
+    RUN_TEST(test_expr_chains);
+    RUN_TEST(test_expr_mixed);
+    RUN_TEST(test_expr_statuses);
+    RUN_TEST(test_expr_aliasing);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
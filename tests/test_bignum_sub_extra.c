@@ -21,15 +21,24 @@
  *                         содержит статический массив, а не указатель, что делает
  *                         невозможным симуляцию перекрытия входных буферов
  *                         в рамках простого юнит-теста без изменения архитектуры.
+ *   - rev. 6 (17.10.2026): Дифференциальные тесты всех зарегистрированных ядер
+ *                         против эталона на C: полный перебор малых длин,
+ *                         граничные слова, все коды возврата, раскладки
+ *                         указателей, фаззинг с воспроизводимым seed и точка
+ *                         входа libFuzzer (-DBIGNUM_SUB_FUZZER, make fuzz).
+ *   - rev. 7 (17.10.2026): Регрессия заёма через нулевые слова a
+ *                         (a = [0, 0, 1], b = [1, 1]).
  */
 
 #include "bignum_sub.h"
 #include <bignum_cmp.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include "../benchmarks/bench_ref_kernels.h"
 
 /*
 // Вспомогательная функция для определения нуля для bignum_t
@@ -81,8 +90,10 @@ void bignum_from_array(bignum_t *num, const uint64_t *arr, size_t len) {
 
 #define FUZZ_ITERATIONS 10000
 
+#ifndef BIGNUM_SUB_FUZZER
 static int tests_passed = 0;
 static int tests_failed = 0;
+#endif
 
 // --- Тесты на робастность ---
 
@@ -131,6 +142,19 @@ int test_overlap_result_b() {
     return bignum_sub(&b, &a, &b) == BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
 }
 
+// --- Регрессии ---
+
+// Заём через нулевые слова a: a[i] == 0 при заёме 1 вычитал заём дважды
+// (sub + sbb), и результат был [FF..FF, FF..FD, 1] с len 3.
+int test_regression_borrow_through_zero_limbs() {
+    bignum_t a, b, result;
+    bignum_from_array(&a, (uint64_t[]){0, 0, 1}, 3);
+    bignum_from_array(&b, (uint64_t[]){1, 1}, 2);
+    return bignum_sub(&result, &a, &b) == BIGNUM_SUB_SUCCESS && result.len == 2 &&
+           result.words[0] == 0xFFFFFFFFFFFFFFFFull && result.words[1] == 0xFFFFFFFFFFFFFFFEull &&
+           result.words[2] == 0;
+}
+
 // --- Фаззинг-тест ---
 
 int test_fuzzing_robustness() {
@@ -165,6 +189,372 @@ int test_fuzzing_robustness() {
     return 1;
 }
 
+// --- Дифференциальные тесты: каждое ядро против эталона на C ---
+
+typedef bignum_sub_status_t (*kernel_fn_t)(bignum_t *, const bignum_t *, const bignum_t *);
+
+typedef struct {
+    const char  *name;
+    kernel_fn_t  fn;
+} kernel_t;
+
+/**
+ * Ядра, которые должны совпадать с эталоном побайтно. Новый вариант
+ * (SIMD, специализированный, без проверок и т.п.) включается только после
+ * регистрации здесь и прохождения всех дифференциальных тестов.
+ */
+static const kernel_t kernels[] = {
+    { "bignum_sub", bignum_sub },
+    BENCH_REF_KERNELS
+};
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+#define DIFF_SLOTS 4
+#define DIFF_NULL ((ptrdiff_t)-1)
+#define DIFF_SMALL_LEN 4
+#define DIFF_FUZZ_ITERATIONS 20000
+
+/** Граничные значения слова. */
+static const uint64_t boundary_limbs[] = { 0, 1, 0x8000000000000000ull, 0xFFFFFFFFFFFFFFFFull };
+#define NUM_BOUNDARY_LIMBS (sizeof(boundary_limbs) / sizeof(boundary_limbs[0]))
+
+/** Память вызова: result, a и b — смещения в ней, поэтому сравнивается всё сразу. */
+typedef struct {
+    _Alignas(64) unsigned char bytes[DIFF_SLOTS * sizeof(bignum_t)];
+} diff_arena_t;
+
+/** Смещения result, a, b (DIFF_NULL — NULL). */
+typedef struct {
+    ptrdiff_t r, a, b;
+} diff_layout_t;
+
+/** Обычная раскладка: result сразу за a (как в массиве bignum_t), b через слот. */
+static const diff_layout_t layout_plain = { sizeof(bignum_t), 0, 2 * sizeof(bignum_t) };
+
+static diff_arena_t diff_init, diff_want, diff_got;
+static unsigned long long diff_status_seen[5];
+
+static bignum_t *slot(diff_arena_t *m, ptrdiff_t off) {
+    return off == DIFF_NULL ? NULL : (bignum_t *)(void *)(m->bytes + off);
+}
+
+/** Пересекаются ли слова [p, p + 256) и [q, q + 256). */
+static int ref_overlap(const void *p, const void *q) {
+    const char *x = p, *y = q;
+    const size_t n = sizeof(((bignum_t *)0)->words);
+    return x < y + n && y < x + n;
+}
+
+/**
+ * Эталон: контракт bignum_sub словами школьного вычитания.
+ * Порядок проверок: NULL, ёмкость, перекрытие, знак (bignum_cmp).
+ * При ошибке память не меняется; при успехе все слова результата
+ * перезаписаны, хвост за len нулевой, len нормализована (ноль — len 1).
+ */
+static bignum_sub_status_t ref_sub(bignum_t *r, const bignum_t *a, const bignum_t *b) {
+    if (!r || !a || !b) return BIGNUM_SUB_ERROR_NULL_PTR;
+    if (a->len < 1 || a->len > BIGNUM_CAPACITY || b->len > BIGNUM_CAPACITY) {
+        return BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    }
+    if (ref_overlap(r, a) || ref_overlap(r, b)) return BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
+    if (bignum_cmp(a, b) < 0) return BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    uint64_t w[BIGNUM_CAPACITY] = { 0 };
+    unsigned borrow = 0;
+    for (size_t i = 0; i < a->len; ++i) {
+        uint64_t x = a->words[i], y = i < b->len ? b->words[i] : 0;
+        w[i] = x - y - borrow;
+        borrow = x < y || (x == y && borrow);
+    }
+    size_t len = a->len;
+    while (len > 1 && w[len - 1] == 0) len--;
+    memcpy(r->words, w, sizeof(w));
+    r->len = len;
+    return BIGNUM_SUB_SUCCESS;
+}
+
+/** Результат успешного вызова соблюдает контракт длины и хвоста. */
+static int result_well_formed(const bignum_t *r) {
+    if (r->len < 1 || r->len > BIGNUM_CAPACITY) return 0;
+    if (r->len > 1 && r->words[r->len - 1] == 0) return 0;
+    for (size_t i = r->len; i < BIGNUM_CAPACITY; ++i) {
+        if (r->words[i] != 0) return 0;
+    }
+    return 1;
+}
+
+/** Заполняет память вызова "ядом", чтобы незаписанные слова были видны. */
+static void diff_poison(void) {
+    for (size_t i = 0; i < sizeof(diff_init.bytes); ++i) diff_init.bytes[i] = (unsigned char)(0xA5 ^ i);
+}
+
+static void diff_put(ptrdiff_t off, const bignum_t *x) {
+    memcpy(diff_init.bytes + off, x, sizeof(*x));
+}
+
+/**
+ * Вызывает эталон и все ядра на копиях diff_init с раскладкой `lay`.
+ * Совпасть должны код возврата и вся память (результат, len, хвост,
+ * неизменные операнды). Возвращает 1, если все ядра совпали.
+ */
+static int diff_case(const diff_layout_t *lay, const char *what) {
+    diff_want = diff_init;
+    bignum_sub_status_t want = ref_sub(slot(&diff_want, lay->r), slot(&diff_want, lay->a), slot(&diff_want, lay->b));
+    if (want == BIGNUM_SUB_SUCCESS && !result_well_formed(slot(&diff_want, lay->r))) {
+        fprintf(stderr, "Reference produced a malformed result (%s)\n", what);
+        return 0;
+    }
+    diff_status_seen[-(int)want]++;
+    int ok = 1;
+    for (size_t k = 0; k < NUM_KERNELS; ++k) {
+        diff_got = diff_init;
+        bignum_sub_status_t got = kernels[k].fn(slot(&diff_got, lay->r), slot(&diff_got, lay->a), slot(&diff_got, lay->b));
+        if (got != want || memcmp(&diff_got, &diff_want, sizeof(diff_got)) != 0) {
+            const bignum_t *a = slot(&diff_init, lay->a), *b = slot(&diff_init, lay->b);
+            fprintf(stderr, "%s differs from reference (%s): status %d, want %d, len_a %zu, len_b %zu\n",
+                    kernels[k].name, what, (int)got, (int)want, a ? a->len : 0, b ? b->len : 0);
+            ok = 0;
+        }
+    }
+    return ok;
+}
+
+/** Операнд длины len из слов индексов idx в boundary_limbs. */
+static void bignum_from_limbs(bignum_t *x, const unsigned *idx, size_t len) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) x->words[i] = boundary_limbs[idx[i]];
+    x->len = len;
+}
+
+/** Следующее нормализованное число длины len (старшее слово не 0); 0 — перебор окончен. */
+static int next_limbs(unsigned *idx, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (++idx[i] < NUM_BOUNDARY_LIMBS) {
+            if (i == len - 1 && len > 1 && boundary_limbs[idx[i]] == 0) continue;
+            return 1;
+        }
+        idx[i] = (i == len - 1 && len > 1) ? 1 : 0;
+    }
+    return 0;
+}
+
+static void first_limbs(unsigned *idx, size_t len) {
+    for (size_t i = 0; i < len; ++i) idx[i] = 0;
+    if (len > 1) idx[len - 1] = 1;   // boundary_limbs[1] != 0
+}
+
+int test_diff_exhaustive_small() {
+    unsigned ia[DIFF_SMALL_LEN], ib[DIFF_SMALL_LEN];
+    bignum_t a, b;
+    unsigned long long cases = 0;
+    int ok = 1;
+    for (size_t la = 1; la <= DIFF_SMALL_LEN && ok; ++la) {
+        first_limbs(ia, la);
+        do {
+            bignum_from_limbs(&a, ia, la);
+            for (size_t lb = 0; lb <= DIFF_SMALL_LEN && ok; ++lb) {
+                first_limbs(ib, lb);
+                do {
+                    bignum_from_limbs(&b, ib, lb);
+                    diff_poison();
+                    diff_put(layout_plain.a, &a);
+                    diff_put(layout_plain.b, &b);
+                    ok = diff_case(&layout_plain, "exhaustive");
+                    cases++;
+                } while (ok && lb > 0 && next_limbs(ib, lb));
+            }
+        } while (ok && next_limbs(ia, la));
+    }
+    printf("  %llu operand pairs x %zu kernel(s)\n", cases, NUM_KERNELS);
+    return ok;
+}
+
+/** Заполняет x длины len словами по шаблону p (граничные значения и их смеси). */
+static void bignum_pattern(bignum_t *x, size_t len, unsigned p) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) {
+        switch (p) {
+            case 0: x->words[i] = 0xFFFFFFFFFFFFFFFFull; break;
+            case 1: x->words[i] = i == len - 1 ? 1 : 0; break;                     // 2^(64(len-1))
+            case 2: x->words[i] = 0x8000000000000000ull; break;
+            case 3: x->words[i] = i == 0 ? 1 : 0; break;                           // 1 (len 1)
+            case 4: x->words[i] = (i & 1) ? 0x8000000000000000ull : 0xFFFFFFFFFFFFFFFFull; break;
+            default: x->words[i] = i == len - 1 ? 0x8000000000000000ull : 0; break;
+        }
+    }
+    x->len = len;
+    while (x->len > 1 && x->words[x->len - 1] == 0) x->len--;
+}
+
+int test_diff_boundary_limbs() {
+    static const size_t lens[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32 };
+    const size_t nlens = sizeof(lens) / sizeof(lens[0]);
+    bignum_t a, b;
+    for (size_t i = 0; i < nlens; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            for (unsigned pa = 0; pa < 6; ++pa) {
+                for (unsigned pb = 0; pb < 6; ++pb) {
+                    bignum_pattern(&a, lens[i], pa);
+                    bignum_pattern(&b, lens[j], pb);
+                    diff_poison();
+                    diff_put(layout_plain.a, &a);
+                    diff_put(layout_plain.b, &b);
+                    if (!diff_case(&layout_plain, "boundary")) return 0;
+                    // a - a: нулевой результат, len = 1
+                    diff_put(layout_plain.b, &a);
+                    if (!diff_case(&layout_plain, "boundary a-a")) return 0;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+int test_diff_statuses() {
+    const ptrdiff_t S = sizeof(bignum_t), W = sizeof(uint64_t);
+    bignum_t a, b;
+    bignum_pattern(&a, 6, 4);
+    bignum_pattern(&b, 3, 2);
+    const diff_layout_t layouts[] = {
+        { DIFF_NULL, 0, 2 * S }, { S, DIFF_NULL, 2 * S }, { S, 0, DIFF_NULL },
+        { DIFF_NULL, DIFF_NULL, DIFF_NULL },
+        { 0, 0, 2 * S },                                    // result == a
+        { 2 * S, 0, 2 * S },                                // result == b, a далеко
+        { W, 0, 2 * S }, { 2 * S - 31 * W, 0, 2 * S },      // частичное перекрытие с a и b
+        { 2 * S + 31 * W, 0, 2 * S },                       // последнее слово b
+        { S, 0, 2 * S }, { 3 * S, 0, S },                   // соседние слоты — не перекрытие
+    };
+    for (size_t i = 0; i < sizeof(layouts) / sizeof(layouts[0]); ++i) {
+        diff_poison();
+        if (layouts[i].a != DIFF_NULL) diff_put(layouts[i].a, &a);
+        if (layouts[i].b != DIFF_NULL) diff_put(layouts[i].b, &b);
+        if (!diff_case(&layouts[i], "layout")) return 0;
+    }
+    // Длины вне диапазона и отрицательный результат
+    const size_t bad_len[] = { 0, BIGNUM_CAPACITY + 1, BIGNUM_CAPACITY + 100, (size_t)-1 };
+    for (size_t i = 0; i < sizeof(bad_len) / sizeof(bad_len[0]); ++i) {
+        diff_poison();
+        diff_put(layout_plain.a, &a);
+        diff_put(layout_plain.b, &b);
+        slot(&diff_init, layout_plain.a)->len = bad_len[i];
+        if (!diff_case(&layout_plain, "bad len_a")) return 0;
+        diff_put(layout_plain.a, &a);
+        if (bad_len[i] != 0) {
+            slot(&diff_init, layout_plain.b)->len = bad_len[i];
+            if (!diff_case(&layout_plain, "bad len_b")) return 0;
+        }
+    }
+    diff_poison();
+    diff_put(layout_plain.a, &b);
+    diff_put(layout_plain.b, &a);
+    if (!diff_case(&layout_plain, "negative")) return 0;
+    for (int s = 0; s < 5; ++s) {
+        if (diff_status_seen[s] == 0) {
+            fprintf(stderr, "Status %d never produced\n", -s);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint64_t fuzz_state;
+
+static uint64_t fuzz_next(void) {
+    fuzz_state ^= fuzz_state << 13;
+    fuzz_state ^= fuzz_state >> 7;
+    fuzz_state ^= fuzz_state << 17;
+    return fuzz_state;
+}
+
+/** Слово: граничное, малое или случайное. */
+static uint64_t fuzz_limb(void) {
+    uint64_t r = fuzz_next();
+    switch (r & 3) {
+        case 0: return boundary_limbs[(r >> 2) % NUM_BOUNDARY_LIMBS];
+        case 1: return (r >> 2) & 0xF;
+        default: return fuzz_next();
+    }
+}
+
+static void fuzz_bignum(bignum_t *x, size_t len) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) x->words[i] = fuzz_limb();
+    x->len = len;
+    while (x->len > 1 && x->words[x->len - 1] == 0) x->len--;
+}
+
+int test_diff_fuzz() {
+    const char *env = getenv("BIGNUM_SUB_FUZZ_SEED");
+    uint64_t seed = env ? strtoull(env, NULL, 0) : ((uint64_t)time(NULL) << 20) ^ (uint64_t)getpid();
+    fuzz_state = seed | 1;
+    printf("Differential fuzzing with seed: %llu (BIGNUM_SUB_FUZZ_SEED)\n", (unsigned long long)seed);
+    bignum_t a, b;
+    for (int i = 0; i < DIFF_FUZZ_ITERATIONS; ++i) {
+        size_t la = 1 + fuzz_next() % BIGNUM_CAPACITY;
+        size_t lb = fuzz_next() % (la + 1);
+        fuzz_bignum(&a, la);
+        fuzz_bignum(&b, lb);
+        // Чаще a >= b; иногда b — префикс a с изменённым младшим словом (длинные цепочки)
+        if ((fuzz_next() & 3) == 0) {
+            b = a;
+            b.words[0] = fuzz_limb();
+            while (b.len > 1 && b.words[b.len - 1] == 0) b.len--;
+        }
+        if ((fuzz_next() & 3) != 0 && bignum_cmp(&a, &b) < 0) {
+            bignum_t t = a;
+            a = b;
+            b = t;
+            if (a.len == 0) continue;
+        }
+        diff_poison();
+        diff_put(layout_plain.a, &a);
+        diff_put(layout_plain.b, &b);
+        if (!diff_case(&layout_plain, "fuzz")) {
+            fprintf(stderr, "Reproduce with BIGNUM_SUB_FUZZ_SEED=%llu (iteration %d)\n", (unsigned long long)seed, i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#ifdef BIGNUM_SUB_FUZZER
+/**
+ * Точка входа libFuzzer (make fuzz): байт 0 — a->len, байт 1 — b->len
+ * (оба по модулю BIGNUM_CAPACITY + 3, т.е. с недопустимыми), байт 2 —
+ * раскладка указателей, дальше — слова a, затем b. Операнды допустимой
+ * длины нормализуются. Любое расхождение с эталоном — abort().
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    const ptrdiff_t S = sizeof(bignum_t), W = sizeof(uint64_t);
+    const diff_layout_t layouts[] = {
+        { S, 0, 2 * S }, { 0, 0, 2 * S }, { 2 * S, 0, 2 * S }, { W, 0, 2 * S },
+        { DIFF_NULL, 0, 2 * S }, { S, DIFF_NULL, 2 * S }, { 3 * S, 0, S },
+    };
+    if (size < 3) return 0;
+    bignum_t x[2];
+    size_t pos = 3;
+    memset(x, 0, sizeof(x));
+    for (int k = 0; k < 2; ++k) {
+        size_t len = data[k] % (BIGNUM_CAPACITY + 3);
+        for (size_t i = 0; i < len && i < BIGNUM_CAPACITY; ++i) {
+            size_t n = size - pos < sizeof(uint64_t) ? size - pos : sizeof(uint64_t);
+            memcpy(&x[k].words[i], data + pos, n);
+            pos += n;
+        }
+        x[k].len = len;
+        if (len <= BIGNUM_CAPACITY) {
+            while (x[k].len > 1 && x[k].words[x[k].len - 1] == 0) x[k].len--;
+        }
+    }
+    const diff_layout_t *lay = &layouts[data[2] % (sizeof(layouts) / sizeof(layouts[0]))];
+    diff_poison();
+    if (lay->a != DIFF_NULL) diff_put(lay->a, &x[0]);
+    if (lay->b != DIFF_NULL) diff_put(lay->b, &x[1]);
+    if (!diff_case(lay, "libFuzzer")) abort();
+    return 0;
+}
+#else
 
 int main() {
     printf("\n--- Launching Extra Tests for bignum_sub  ---\n");
@@ -178,13 +568,23 @@ int main() {
     RUN_TEST(test_overlap_result_a);
     RUN_TEST(test_overlap_result_b);
 
+    printf("\n--- Running Regression Tests ---\n");
+    RUN_TEST(test_regression_borrow_through_zero_limbs);
+
     printf("\n--- Running Fuzzing Test ---\n");
     RUN_TEST(test_fuzzing_robustness);
 
+    printf("\n--- Running Differential Tests (%zu kernel(s) vs C reference) ---\n", NUM_KERNELS);
+    RUN_TEST(test_diff_exhaustive_small);
+    RUN_TEST(test_diff_boundary_limbs);
+    RUN_TEST(test_diff_statuses);
+    RUN_TEST(test_diff_fuzz);
+
     printf("\n--- Test Summary ---\n");
     printf("Passed: %d\n", tests_passed);
     printf("Failed: %d\n", tests_failed);
     printf("\n----------------------\n");
 
     return tests_failed > 0 ? 1 : 0;
-}
\ No newline at end of file
+}
+#endif /* BIGNUM_SUB_FUZZER */
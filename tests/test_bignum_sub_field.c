@@ -0,0 +1,243 @@
+/**
+ * @file    test_bignum_sub_field.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты вычитания в простых полях (bignum_sub_field.h).
+ *
+ * @details
+ *   Для P-256, P-384, 2^255 - 19 и secp256k1 ядро bn_<поле>_sub сверяется
+ *   с независимым пословным эталоном: a - b с заёмом, при заёме + p.
+ *   Операнды — случайные приведённые значения и граничные (0, 1, p - 1,
+ *   равные). Проверяются совпадение r с a или b и преобразования из/в
+ *   bignum_t: p и большие значения отвергаются, p - 1 проходит без потерь.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Эталон — пословный цикл вместо bignum_sub.
+ */
+
+#include "bignum_sub_field.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_ITERATIONS 20000
+#define FIELD_MAX_WORDS BN384_WORDS
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static uint64_t rng_state = 0x13198A2E03707344ull;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/** Поле: модуль по стандарту и ядро с преобразованиями над массивами слов. */
+typedef struct {
+    const char *name;
+    size_t words;
+    uint64_t p[FIELD_MAX_WORDS];
+    void (*sub)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+    bignum_sub_status_t (*from_bignum)(uint64_t *r, const bignum_t *x);
+    bignum_sub_status_t (*to_bignum)(bignum_t *x, const uint64_t *a);
+} field_t;
+
+#define FIELD_OPS(field, type)                                                       \
+    static void sub_##field(uint64_t *r, const uint64_t *a, const uint64_t *b) {     \
+        bn_##field##_sub((type *)r, (const type *)a, (const type *)b);               \
+    }                                                                                \
+    static bignum_sub_status_t from_##field(uint64_t *r, const bignum_t *x) {        \
+        return bn_##field##_from_bignum((type *)r, x);                               \
+    }                                                                                \
+    static bignum_sub_status_t to_##field(bignum_t *x, const uint64_t *a) {          \
+        return bn_##field##_to_bignum(x, (const type *)a);                           \
+    }
+
+FIELD_OPS(p256, bn256_t)
+FIELD_OPS(p384, bn384_t)
+FIELD_OPS(p25519, bn256_t)
+FIELD_OPS(secp256k1, bn256_t)
+
+static const field_t fields[] = {
+    { "P-256", 4, { 0xFFFFFFFFFFFFFFFFull, 0x00000000FFFFFFFFull, 0, 0xFFFFFFFF00000001ull },
+      sub_p256, from_p256, to_p256 },
+    { "P-384", 6, { 0x00000000FFFFFFFFull, 0xFFFFFFFF00000000ull, 0xFFFFFFFFFFFFFFFEull,
+                    0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull },
+      sub_p384, from_p384, to_p384 },
+    { "2^255-19", 4, { 0xFFFFFFFFFFFFFFEDull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0x7FFFFFFFFFFFFFFFull },
+      sub_p25519, from_p25519, to_p25519 },
+    { "secp256k1", 4, { 0xFFFFFFFEFFFFFC2Full, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull },
+      sub_secp256k1, from_secp256k1, to_secp256k1 },
+};
+#define FIELD_COUNT (sizeof(fields) / sizeof(fields[0]))
+
+static int less_than(const uint64_t *x, const uint64_t *y, size_t n) {
+    for (size_t i = n; i-- > 0;) {
+        if (x[i] != y[i]) return x[i] < y[i];
+    }
+    return 0;
+}
+
+/** Случайный приведённый элемент: 0, 1, p - 1, p - 1 - small или случайный < p. */
+static void random_element(uint64_t *w, const field_t *f) {
+    switch (rng_next() % 8) {
+    case 0:
+        memset(w, 0, f->words * sizeof(uint64_t));
+        w[0] = rng_next() % 2;
+        return;
+    case 1:
+        memcpy(w, f->p, f->words * sizeof(uint64_t));
+        w[0] -= 1 + rng_next() % 16;
+        return;
+    default:
+        do {
+            for (size_t i = 0; i < f->words; ++i) w[i] = rng_next();
+            w[f->words - 1] >>= rng_next() % 2;
+        } while (!less_than(w, f->p, f->words));
+        return;
+    }
+}
+
+/** Эталон пословным циклом, без ядер библиотеки: a - b с заёмом, при заёме + p. */
+static void ref_field_sub(uint64_t *r, const uint64_t *a, const uint64_t *b, const field_t *f) {
+    uint64_t borrow = 0, carry = 0;
+    for (size_t i = 0; i < f->words; ++i) {
+        uint64_t d = a[i] - b[i] - borrow;
+        borrow = (a[i] < b[i] || (a[i] == b[i] && borrow)) ? 1 : 0;
+        r[i] = d;
+    }
+    if (!borrow) return;
+    for (size_t i = 0; i < f->words; ++i) {
+        uint64_t s = r[i] + f->p[i] + carry;
+        carry = (s < r[i] || (s == r[i] && carry)) ? 1 : 0;
+        r[i] = s;
+    }
+}
+
+int test_field_sub() {
+    uint64_t a[FIELD_MAX_WORDS], b[FIELD_MAX_WORDS], r[FIELD_MAX_WORDS], want[FIELD_MAX_WORDS];
+    int ok = 1;
+    for (unsigned it = 0; it < NUM_ITERATIONS && ok; ++it) {
+        const field_t *f = &fields[it % FIELD_COUNT];
+        random_element(a, f);
+        if (rng_next() % 8 == 0) memcpy(b, a, sizeof(b));
+        else random_element(b, f);
+        ref_field_sub(want, a, b, f);
+        f->sub(r, a, b);
+        ok = memcmp(r, want, f->words * sizeof(uint64_t)) == 0 && less_than(r, f->p, f->words);
+        if (!ok) printf("  %s mismatch at iteration %u\n", f->name, it);
+    }
+    return ok;
+}
+
+int test_field_edges() {
+    uint64_t zero[FIELD_MAX_WORDS] = { 0 }, one[FIELD_MAX_WORDS] = { 1 }, pm1[FIELD_MAX_WORDS], r[FIELD_MAX_WORDS];
+    int ok = 1;
+    for (size_t k = 0; k < FIELD_COUNT && ok; ++k) {
+        const field_t *f = &fields[k];
+        size_t bytes = f->words * sizeof(uint64_t);
+        memcpy(pm1, f->p, sizeof(pm1));
+        pm1[0] -= 1;
+        // 0 - 1 = p - 1: модуль в ядре совпадает со стандартом
+        f->sub(r, zero, one);
+        ok = memcmp(r, pm1, bytes) == 0;
+        // 0 - (p - 1) = 1, (p - 1) - 0 = p - 1, x - x = 0
+        f->sub(r, zero, pm1);
+        ok = ok && memcmp(r, one, bytes) == 0;
+        f->sub(r, pm1, zero);
+        ok = ok && memcmp(r, pm1, bytes) == 0;
+        f->sub(r, pm1, pm1);
+        ok = ok && memcmp(r, zero, bytes) == 0;
+        if (!ok) printf("  %s edge case failed\n", f->name);
+    }
+    return ok;
+}
+
+int test_field_aliasing() {
+    uint64_t a[FIELD_MAX_WORDS], b[FIELD_MAX_WORDS], x[FIELD_MAX_WORDS], want[FIELD_MAX_WORDS];
+    int ok = 1;
+    for (unsigned it = 0; it < 1000 && ok; ++it) {
+        const field_t *f = &fields[it % FIELD_COUNT];
+        size_t bytes = f->words * sizeof(uint64_t);
+        random_element(a, f);
+        random_element(b, f);
+        f->sub(want, a, b);
+        memcpy(x, a, sizeof(x));
+        f->sub(x, x, b);
+        ok = memcmp(x, want, bytes) == 0;
+        memcpy(x, b, sizeof(x));
+        f->sub(x, a, x);
+        ok = ok && memcmp(x, want, bytes) == 0;
+    }
+    return ok;
+}
+
+int test_field_convert() {
+    uint64_t w[FIELD_MAX_WORDS], back[FIELD_MAX_WORDS], saved[FIELD_MAX_WORDS];
+    bignum_t x;
+    int ok = 1;
+    for (size_t k = 0; k < FIELD_COUNT && ok; ++k) {
+        const field_t *f = &fields[k];
+        size_t bytes = f->words * sizeof(uint64_t);
+        // p - 1 туда и обратно без потерь
+        memcpy(w, f->p, sizeof(w));
+        w[0] -= 1;
+        ok = f->to_bignum(&x, w) == BIGNUM_SUB_SUCCESS && x.len == f->words;
+        ok = ok && f->from_bignum(back, &x) == BIGNUM_SUB_SUCCESS && memcmp(back, w, bytes) == 0;
+        // p и значения шире поля отвергаются, приёмник не меняется
+        memcpy(saved, back, sizeof(saved));
+        x.words[0] += 1;
+        ok = ok && f->from_bignum(back, &x) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+        x.words[0] = 0;
+        x.words[f->words] = 1;
+        x.len = f->words + 1;
+        ok = ok && f->from_bignum(back, &x) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+        ok = ok && memcmp(back, saved, sizeof(saved)) == 0;
+        // Ноль и ненормализованный вход
+        memset(&x, 0, sizeof(x));
+        x.len = 3;
+        ok = ok && f->from_bignum(back, &x) == BIGNUM_SUB_SUCCESS && back[0] == 0 && back[f->words - 1] == 0;
+        ok = ok && f->to_bignum(&x, back) == BIGNUM_SUB_SUCCESS && x.len == 1;
+        ok = ok && f->from_bignum(NULL, &x) == BIGNUM_SUB_ERROR_NULL_PTR;
+        for (unsigned it = 0; it < 1000 && ok; ++it) {
+            random_element(w, f);
+            ok = f->to_bignum(&x, w) == BIGNUM_SUB_SUCCESS && f->from_bignum(back, &x) == BIGNUM_SUB_SUCCESS
+                 && memcmp(back, w, bytes) == 0;
+        }
+        if (!ok) printf("  %s conversion failed\n", f->name);
+    }
+    return ok;
+}
+
+int main() {
+    printf("\n--- Launching Prime-Field Kernel Tests for bignum_sub  ---\n");
+
+    RUN_TEST(test_field_sub);
+    RUN_TEST(test_field_edges);
+    RUN_TEST(test_field_aliasing);
+    RUN_TEST(test_field_convert);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
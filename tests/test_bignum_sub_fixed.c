@@ -0,0 +1,318 @@
+/**
+ * @file    test_bignum_sub_fixed.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты ядер фиксированной ширины bn256..bn2048 (bignum_sub_fixed.h).
+ *
+ * @details
+ *   Для каждой ширины ядра сверяются с независимым пословным эталоном
+ *   (результат по модулю 2^N и заём) и с bignum_sub на тех же значениях:
+ *   bnN_sub_mod (при заёме r + b == a mod 2^N), bnN_borrow, bnN_sub (коды
+ *   возврата, неизменность результата при a < b). Граничные слова 0, 1,
+ *   2^63, 2^64 - 1: для bn256 перебираются все пары операндов. Проверяются совпадение r с a или b и преобразования из/в
+ *   bignum_t, включая ненормализованные входы и значения шире типа.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Независимый пословный эталон и граничные слова.
+ */
+
+#include "bignum_sub_fixed.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_ITERATIONS 20000
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static uint64_t rng_state = 0xB7E151628AED2A6Bull;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/** Ядра одной ширины через общий интерфейс над словами. */
+typedef struct {
+    const char *name;
+    size_t words;
+    uint64_t (*sub_mod)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+    uint64_t (*borrow)(const uint64_t *a, const uint64_t *b);
+    bignum_sub_status_t (*sub)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+} fixed_ops_t;
+
+#define FIXED_OPS(bits)                                                                          \
+    static uint64_t sub_mod_##bits(uint64_t *r, const uint64_t *a, const uint64_t *b) {          \
+        return bn##bits##_sub_mod((bn##bits##_t *)r, (const bn##bits##_t *)a, (const bn##bits##_t *)b); \
+    }                                                                                            \
+    static uint64_t borrow_##bits(const uint64_t *a, const uint64_t *b) {                        \
+        return bn##bits##_borrow((const bn##bits##_t *)a, (const bn##bits##_t *)b);             \
+    }                                                                                            \
+    static bignum_sub_status_t sub_##bits(uint64_t *r, const uint64_t *a, const uint64_t *b) {   \
+        return bn##bits##_sub((bn##bits##_t *)r, (const bn##bits##_t *)a, (const bn##bits##_t *)b); \
+    }
+
+FIXED_OPS(256)
+FIXED_OPS(512)
+FIXED_OPS(1024)
+FIXED_OPS(2048)
+
+static const fixed_ops_t fixed_ops[] = {
+    { "bn256", BN256_WORDS, sub_mod_256, borrow_256, sub_256 },
+    { "bn512", BN512_WORDS, sub_mod_512, borrow_512, sub_512 },
+    { "bn1024", BN1024_WORDS, sub_mod_1024, borrow_1024, sub_1024 },
+    { "bn2048", BN2048_WORDS, sub_mod_2048, borrow_2048, sub_2048 },
+};
+#define FIXED_COUNT (sizeof(fixed_ops) / sizeof(fixed_ops[0]))
+
+static const uint64_t boundary_limbs[] = { 0, 1, 0x8000000000000000ull, 0xFFFFFFFFFFFFFFFFull };
+#define NUM_BOUNDARY_LIMBS (sizeof(boundary_limbs) / sizeof(boundary_limbs[0]))
+
+/** Случайное значение ширины n: обычные и граничные слова, крайние значения, общий старший префикс с ref. */
+static void random_words(uint64_t *w, size_t n, const uint64_t *ref) {
+    unsigned mode = (unsigned)(rng_next() % 7);
+    size_t keep = (size_t)(rng_next() % n);
+    for (size_t i = 0; i < n; ++i) {
+        switch (mode) {
+        case 0: w[i] = 0; break;
+        case 1: w[i] = ~0ull; break;
+        case 2: w[i] = (ref && i > keep) ? ref[i] : rng_next(); break;
+        case 3: w[i] = i == 0 ? rng_next() % 4 : 0; break;
+        case 4: w[i] = boundary_limbs[rng_next() % NUM_BOUNDARY_LIMBS]; break;
+        default: w[i] = rng_next(); break;
+        }
+    }
+}
+
+/** Независимый эталон пословным циклом: r = (a - b) mod 2^(64n), возвращает заём. */
+static uint64_t ref_sub_words(uint64_t *r, const uint64_t *a, const uint64_t *b, size_t n) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t d = a[i] - b[i] - borrow;
+        borrow = (a[i] < b[i] || (a[i] == b[i] && borrow)) ? 1 : 0;
+        r[i] = d;
+    }
+    return borrow;
+}
+
+/** Эталон через bignum_sub: статус и результат в words (при успехе). */
+static bignum_sub_status_t ref_sub(uint64_t *r, const uint64_t *a, const uint64_t *b, size_t n) {
+    bignum_t x, y, z;
+    bignum_sub_fixed_store(&x, a, n);
+    bignum_sub_fixed_store(&y, b, n);
+    bignum_sub_status_t st = bignum_sub(&z, &x, &y);
+    if (st == BIGNUM_SUB_SUCCESS) bignum_sub_fixed_load(r, n, &z);
+    return st;
+}
+
+/** (r + b) mod 2^(64n) == a. */
+static int wraps_back(const uint64_t *r, const uint64_t *b, const uint64_t *a, size_t n) {
+    unsigned carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t s = r[i] + b[i];
+        unsigned c1 = s < r[i];
+        uint64_t t = s + carry;
+        carry = c1 | (t < s);
+        if (t != a[i]) return 0;
+    }
+    return 1;
+}
+
+int test_fixed_sub_mod() {
+    static uint64_t a[BN2048_WORDS], b[BN2048_WORDS], r[BN2048_WORDS], want[BN2048_WORDS], words[BN2048_WORDS];
+    int ok = 1;
+    unsigned borrows = 0;
+    for (unsigned it = 0; it < NUM_ITERATIONS && ok; ++it) {
+        const fixed_ops_t *op = &fixed_ops[it % FIXED_COUNT];
+        size_t n = op->words;
+        random_words(a, n, NULL);
+        random_words(b, n, a);
+        bignum_sub_status_t st = ref_sub(want, a, b, n);
+        uint64_t borrow_want = ref_sub_words(words, a, b, n);
+        uint64_t borrow = op->sub_mod(r, a, b);
+        if (st == BIGNUM_SUB_SUCCESS) {
+            ok = borrow == 0 && memcmp(r, want, n * sizeof(uint64_t)) == 0;
+        } else {
+            ok = st == BIGNUM_SUB_ERROR_NEGATIVE_RESULT && borrow == 1 && wraps_back(r, b, a, n);
+            borrows++;
+        }
+        ok = ok && borrow == borrow_want && memcmp(r, words, n * sizeof(uint64_t)) == 0;
+        ok = ok && op->borrow(a, b) == borrow;
+        if (!ok) printf("  %s mismatch at iteration %u\n", op->name, it);
+    }
+    printf("  %u borrows of %u\n", borrows, NUM_ITERATIONS);
+    return ok && borrows > 0 && borrows < NUM_ITERATIONS;
+}
+
+int test_fixed_sub_checked() {
+    static uint64_t a[BN2048_WORDS], b[BN2048_WORDS], r[BN2048_WORDS], want[BN2048_WORDS], saved[BN2048_WORDS];
+    static uint64_t words[BN2048_WORDS];
+    int ok = 1;
+    for (unsigned it = 0; it < NUM_ITERATIONS && ok; ++it) {
+        const fixed_ops_t *op = &fixed_ops[it % FIXED_COUNT];
+        size_t n = op->words;
+        random_words(a, n, NULL);
+        random_words(b, n, a);
+        random_words(r, n, NULL);
+        memcpy(saved, r, sizeof(saved));
+        bignum_sub_status_t st_want = ref_sub(want, a, b, n);
+        uint64_t borrow_want = ref_sub_words(words, a, b, n);
+        bignum_sub_status_t st = op->sub(r, a, b);
+        ok = st == st_want && (st == BIGNUM_SUB_SUCCESS) == (borrow_want == 0);
+        if (st == BIGNUM_SUB_SUCCESS) ok = ok && memcmp(r, want, n * sizeof(uint64_t)) == 0 &&
+                                          memcmp(r, words, n * sizeof(uint64_t)) == 0;
+        else ok = ok && memcmp(r, saved, sizeof(saved)) == 0;
+        if (!ok) printf("  %s mismatch at iteration %u\n", op->name, it);
+    }
+    return ok;
+}
+
+/** Проверка ядер одной ширины на a, b по независимому эталону. */
+static int check_words(const fixed_ops_t *op, const uint64_t *a, const uint64_t *b) {
+    static uint64_t r[BN2048_WORDS], want[BN2048_WORDS], saved[BN2048_WORDS];
+    size_t n = op->words;
+    uint64_t borrow_want = ref_sub_words(want, a, b, n);
+    int ok = op->sub_mod(r, a, b) == borrow_want && memcmp(r, want, n * sizeof(uint64_t)) == 0;
+    ok = ok && op->borrow(a, b) == borrow_want;
+    memset(r, 0x5A, sizeof(r));
+    memcpy(saved, r, sizeof(saved));
+    bignum_sub_status_t st = op->sub(r, a, b);
+    if (borrow_want) return ok && st == BIGNUM_SUB_ERROR_NEGATIVE_RESULT && memcmp(r, saved, sizeof(saved)) == 0;
+    return ok && st == BIGNUM_SUB_SUCCESS && memcmp(r, want, n * sizeof(uint64_t)) == 0;
+}
+
+/**
+ * Слова из boundary_limbs (0, 1, 2^63, 2^64 - 1): для bn256 — все пары
+ * операндов, для остальных ширин — случайные сочетания.
+ */
+int test_fixed_boundary_limbs() {
+    static uint64_t a[BN2048_WORDS], b[BN2048_WORDS];
+    unsigned long long cases = 0;
+    int ok = 1;
+    const fixed_ops_t *op = &fixed_ops[0];
+    size_t n = op->words;
+    unsigned long combos = 1;
+    for (size_t i = 0; i < n; ++i) combos *= NUM_BOUNDARY_LIMBS;
+    for (unsigned long ia = 0; ia < combos && ok; ++ia) {
+        for (unsigned long ib = 0; ib < combos && ok; ++ib) {
+            unsigned long xa = ia, xb = ib;
+            for (size_t i = 0; i < n; ++i, xa /= NUM_BOUNDARY_LIMBS, xb /= NUM_BOUNDARY_LIMBS) {
+                a[i] = boundary_limbs[xa % NUM_BOUNDARY_LIMBS];
+                b[i] = boundary_limbs[xb % NUM_BOUNDARY_LIMBS];
+            }
+            ok = check_words(op, a, b);
+            if (!ok) printf("  %s boundary mismatch: a #%lu, b #%lu\n", op->name, ia, ib);
+            cases++;
+        }
+    }
+    for (unsigned it = 0; it < NUM_ITERATIONS && ok; ++it) {
+        op = &fixed_ops[1 + it % (FIXED_COUNT - 1)];
+        n = op->words;
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = boundary_limbs[rng_next() % NUM_BOUNDARY_LIMBS];
+            b[i] = boundary_limbs[rng_next() % NUM_BOUNDARY_LIMBS];
+        }
+        // Равные старшие слова: заём решается в младших
+        if (it & 1) memcpy(b + n / 2, a + n / 2, (n - n / 2) * sizeof(uint64_t));
+        ok = check_words(op, a, b);
+        if (!ok) printf("  %s boundary mismatch at iteration %u\n", op->name, it);
+        cases++;
+    }
+    printf("  %llu cases\n", cases);
+    return ok;
+}
+
+int test_fixed_aliasing() {
+    static uint64_t a[BN2048_WORDS], b[BN2048_WORDS], x[BN2048_WORDS], want[BN2048_WORDS];
+    int ok = 1;
+    for (unsigned it = 0; it < 1000 && ok; ++it) {
+        const fixed_ops_t *op = &fixed_ops[it % FIXED_COUNT];
+        size_t n = op->words;
+        random_words(a, n, NULL);
+        random_words(b, n, a);
+        uint64_t borrow = op->sub_mod(want, a, b);
+        // r == a
+        memcpy(x, a, sizeof(x));
+        ok = op->sub_mod(x, x, b) == borrow && memcmp(x, want, n * sizeof(uint64_t)) == 0;
+        // r == b
+        memcpy(x, b, sizeof(x));
+        ok = ok && op->sub_mod(x, a, x) == borrow && memcmp(x, want, n * sizeof(uint64_t)) == 0;
+        // r == a == b: ноль без заёма
+        memcpy(x, a, sizeof(x));
+        ok = ok && op->sub(x, x, x) == BIGNUM_SUB_SUCCESS;
+        for (size_t i = 0; i < n; ++i) ok = ok && x[i] == 0;
+    }
+    return ok;
+}
+
+int test_fixed_convert() {
+    bignum_t x, y;
+    bn256_t v;
+    bn2048_t w;
+    memset(&x, 0, sizeof(x));
+    // Ненормализованный вход: старшие нули в пределах len допустимы
+    x.words[0] = 7;
+    x.words[2] = 9;
+    x.len = 8;
+    int ok = bn256_from_bignum(&v, &x) == BIGNUM_SUB_SUCCESS && v.words[0] == 7 && v.words[2] == 9
+             && v.words[1] == 0 && v.words[3] == 0;
+    ok = ok && bn256_to_bignum(&y, &v) == BIGNUM_SUB_SUCCESS && y.len == 3 && y.words[2] == 9;
+    for (size_t i = 3; i < BIGNUM_CAPACITY; ++i) ok = ok && y.words[i] == 0;
+    // Значение шире типа и длина вне контракта — ошибка без изменения приёмника
+    bn256_t saved = v;
+    x.words[5] = 1;
+    ok = ok && bn256_from_bignum(&v, &x) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED && memcmp(&v, &saved, sizeof(v)) == 0;
+    x.len = BIGNUM_CAPACITY + 1;
+    ok = ok && bn2048_from_bignum(&w, &x) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    // Слова за len не учитываются; len = 0 — ноль
+    x.len = 5;
+    ok = ok && bn256_from_bignum(&v, &x) == BIGNUM_SUB_SUCCESS;
+    x.len = 0;
+    ok = ok && bn256_from_bignum(&v, &x) == BIGNUM_SUB_SUCCESS && v.words[0] == 0 && v.words[2] == 0;
+    ok = ok && bn256_to_bignum(&y, &v) == BIGNUM_SUB_SUCCESS && y.len == 1 && y.words[0] == 0;
+    ok = ok && bn256_from_bignum(NULL, &x) == BIGNUM_SUB_ERROR_NULL_PTR;
+    ok = ok && bn512_to_bignum(NULL, NULL) == BIGNUM_SUB_ERROR_NULL_PTR;
+
+    // Круговое преобразование полной ширины без потерь
+    for (unsigned it = 0; it < 1000 && ok; ++it) {
+        random_words(w.words, BN2048_WORDS, NULL);
+        bn2048_t back;
+        ok = bn2048_to_bignum(&y, &w) == BIGNUM_SUB_SUCCESS && bn2048_from_bignum(&back, &y) == BIGNUM_SUB_SUCCESS
+             && memcmp(&w, &back, sizeof(w)) == 0;
+    }
+    return ok;
+}
+
+int main() {
+    printf("\n--- Launching Fixed-Width Kernel Tests for bignum_sub  ---\n");
+
+    RUN_TEST(test_fixed_sub_mod);
+    RUN_TEST(test_fixed_sub_checked);
+    RUN_TEST(test_fixed_boundary_limbs);
+    RUN_TEST(test_fixed_aliasing);
+    RUN_TEST(test_fixed_convert);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file    test_bignum_sub_flight.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты бортового самописца вызовов bignum_sub (bignum_sub_flight.h).
+ *
+ * @details
+ *   Собирается с -Wl,--wrap=bignum_sub и библиотекой инструментирования
+ *   (см. INSTR_TESTS в Makefile). Проверяется, что снимок содержит
+ *   аргументы, длины, коды возврата и хэши последних вызовов по порядку,
+ *   что кольцо хранит ровно BIGNUM_SUB_FLIGHT_DEPTH последних записей, что
+ *   у каждого потока своё кольцо, что текстовый дамп и аварийный хук
+ *   (в дочернем процессе с SIGSEGV) печатают записи и что после остановки
+ *   вызовы не записываются.
+ *
+ * @note    Для сборки требуется флаг `-pthread`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#define _GNU_SOURCE
+#include "bignum_sub.h"
+#include "bignum_sub_flight.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+#define CALLS_PER_THREAD (3 * BIGNUM_SUB_FLIGHT_DEPTH)
+#define MAX_RECS ((NUM_THREADS + 2) * BIGNUM_SUB_FLIGHT_DEPTH)
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static bignum_sub_flight_rec_t recs[MAX_RECS];
+static char dump_path[64];
+
+static void bignum_set(bignum_t *x, size_t len, uint64_t seed) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) x->words[i] = seed * 0x9E3779B97F4A7C15ull + i;
+    x->len = len;
+}
+
+/** Записи потока `tid` из снимка подряд в начало `recs`; возвращает их число. */
+static size_t own_records(int32_t tid) {
+    size_t n = bignum_sub_flight_snapshot(recs, MAX_RECS), k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (recs[i].tid == tid) recs[k++] = recs[i];
+    }
+    return k;
+}
+
+/** Читает файл дампа в статический буфер. */
+static const char *read_dump(void) {
+    static char text[1 << 20];
+    FILE *f = fopen(dump_path, "rb");
+    if (!f) return "";
+    size_t n = fread(text, 1, sizeof(text) - 1, f);
+    fclose(f);
+    text[n] = '\0';
+    return text;
+}
+
+int test_flight_records() {
+    bignum_t a, b, r;
+    bignum_set(&a, 5, 1);
+    bignum_set(&b, 3, 2);
+    int st[4];
+    st[0] = bignum_sub(&r, &a, &b);
+    st[1] = bignum_sub(&r, &b, &a);
+    st[2] = bignum_sub(&r, NULL, &b);
+    st[3] = bignum_sub(&a, &a, &b);
+
+    int32_t tid = (int32_t)syscall(SYS_gettid);
+    size_t n = own_records(tid);
+    if (n < 4) return 0;
+    const bignum_sub_flight_rec_t *x = &recs[n - 4];
+    const int want[4] = { BIGNUM_SUB_SUCCESS, BIGNUM_SUB_ERROR_NEGATIVE_RESULT,
+                          BIGNUM_SUB_ERROR_NULL_PTR, BIGNUM_SUB_ERROR_BUFFER_OVERLAP };
+    for (int i = 0; i < 4; ++i) {
+        if (x[i].status != st[i] || st[i] != want[i]) return 0;
+        if (i > 0 && (x[i].seq != x[i - 1].seq + 1 || x[i].tsc < x[i - 1].tsc)) return 0;
+    }
+    return x[0].result == &r && x[0].a == &a && x[0].b == &b && x[0].len_a == 5 && x[0].len_b == 3 &&
+           x[0].hash == bignum_sub_flight_hash(&a, &b) && x[0].hash != 0 &&
+           x[1].a == &b && x[1].hash == bignum_sub_flight_hash(&b, &a) && x[1].hash != x[0].hash &&
+           x[2].a == NULL && x[2].len_a == 0 && x[2].hash == 0 &&
+           x[3].result == &a;
+}
+
+int test_flight_wrap() {
+    bignum_t a, b, r;
+    int32_t tid = (int32_t)syscall(SYS_gettid);
+    for (int i = 0; i < BIGNUM_SUB_FLIGHT_DEPTH + 10; ++i) {
+        bignum_set(&a, (size_t)(i % BIGNUM_CAPACITY) + 1, (uint64_t)i);
+        bignum_set(&b, 1, 0);
+        bignum_sub(&r, &a, &b);
+    }
+    size_t n = own_records(tid);
+    if (n != BIGNUM_SUB_FLIGHT_DEPTH) return 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (recs[i].seq != recs[i - 1].seq + 1) return 0;
+    }
+    int last = BIGNUM_SUB_FLIGHT_DEPTH + 9;
+    return recs[n - 1].len_a == (uint32_t)(last % BIGNUM_CAPACITY) + 1 && recs[n - 1].hash == bignum_sub_flight_hash(&a, &b);
+}
+
+static pthread_barrier_t done_barrier, check_barrier;
+
+static void *thread_func(void *arg) {
+    size_t len = (size_t)(uintptr_t)arg;
+    bignum_t a, b, r;
+    bignum_set(&a, len, len);
+    bignum_set(&b, len - 1, len + 1);
+    for (int i = 0; i < CALLS_PER_THREAD; ++i) bignum_sub(&r, &a, &b);
+    // Потоки живы до проверки: иначе кольцо завершившегося потока займёт следующий
+    pthread_barrier_wait(&done_barrier);
+    pthread_barrier_wait(&check_barrier);
+    return NULL;
+}
+
+int test_flight_threads() {
+    pthread_t th[NUM_THREADS];
+    pthread_barrier_init(&done_barrier, NULL, NUM_THREADS + 1);
+    pthread_barrier_init(&check_barrier, NULL, NUM_THREADS + 1);
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        pthread_create(&th[t], NULL, thread_func, (void *)(uintptr_t)(t + 2));
+    }
+    pthread_barrier_wait(&done_barrier);
+
+    int32_t main_tid = (int32_t)syscall(SYS_gettid);
+    size_t n = bignum_sub_flight_snapshot(recs, MAX_RECS);
+    size_t per_len[NUM_THREADS + 2] = { 0 };
+    int32_t tid_of[NUM_THREADS + 2] = { 0 };
+    int ok = 1;
+    for (size_t i = 0; i < n && ok; ++i) {
+        uint32_t len = recs[i].len_a;
+        if (recs[i].tid == main_tid) continue;
+        if (len < 2 || len >= NUM_THREADS + 2 || recs[i].len_b != len - 1) {
+            ok = 0;
+            break;
+        }
+        if (tid_of[len] == 0) tid_of[len] = recs[i].tid;
+        ok = recs[i].tid == tid_of[len] && recs[i].status == BIGNUM_SUB_SUCCESS;
+        per_len[len]++;
+    }
+    pthread_barrier_wait(&check_barrier);
+    for (int t = 0; t < NUM_THREADS; ++t) pthread_join(th[t], NULL);
+    pthread_barrier_destroy(&done_barrier);
+    pthread_barrier_destroy(&check_barrier);
+
+    // Из чужого кольца самая старая запись отбрасывается: её мог переписывать писатель
+    for (int t = 0; t < NUM_THREADS && ok; ++t) {
+        ok = per_len[t + 2] >= BIGNUM_SUB_FLIGHT_DEPTH - 1 && per_len[t + 2] <= BIGNUM_SUB_FLIGHT_DEPTH;
+        for (int u = 0; u < t && ok; ++u) ok = tid_of[t + 2] != tid_of[u + 2];
+    }
+    return ok;
+}
+
+int test_flight_dump() {
+    bignum_t a, b, r;
+    bignum_set(&a, 2, 3);
+    bignum_set(&b, 7, 4);
+    if (bignum_sub(&r, &a, &b) != BIGNUM_SUB_ERROR_NEGATIVE_RESULT) return 0;
+    int fd = open(dump_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+    int rc = bignum_sub_flight_dump(fd);
+    close(fd);
+    const char *text = read_dump();
+    return rc == 0 && strstr(text, "bignum_sub flight recorder\n") == text &&
+           strstr(text, "status=-2 len_a=2 len_b=7") != NULL && strstr(text, "(exited)") != NULL;
+}
+
+int test_flight_crash() {
+    int fd = open(dump_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+    pid_t pid = fork();
+    if (pid == 0) {
+        bignum_t a, b, r;
+        bignum_set(&a, 3, 5);
+        bignum_set(&b, 3, 6);
+        b.len = BIGNUM_CAPACITY + 8;
+        if (bignum_sub_flight_install_crash_handler(fd) != 0) _exit(2);
+        bignum_sub(&r, &a, &b);
+        raise(SIGSEGV);
+        _exit(3);
+    }
+    close(fd);
+    int wst = 0;
+    if (pid < 0 || waitpid(pid, &wst, 0) != pid) return 0;
+    const char *text = read_dump();
+    return WIFSIGNALED(wst) && WTERMSIG(wst) == SIGSEGV &&
+           strstr(text, "fatal signal") != NULL &&
+           strstr(text, "status=-3 len_a=3 len_b=40") != NULL;
+}
+
+int test_flight_stop() {
+    bignum_t a, b, r;
+    int32_t tid = (int32_t)syscall(SYS_gettid);
+    bignum_set(&a, 4, 1);
+    bignum_set(&b, 2, 2);
+    if (bignum_sub_flight_start() != -1) return 0;   // повторный старт запрещён
+    if (bignum_sub_flight_stop() != 0) return 0;
+    size_t n0 = own_records(tid);
+    uint64_t seq0 = recs[n0 - 1].seq;
+    bignum_sub(&r, &a, &b);                           // после остановки не пишется
+    size_t n = own_records(tid);
+    return n == n0 && recs[n - 1].seq == seq0 && bignum_sub_flight_stop() == -1;
+}
+
+int main() {
+    snprintf(dump_path, sizeof(dump_path), "/tmp/bignum_sub_flight_%d.txt", (int)getpid());
+    printf("\n--- Launching Flight Recorder Tests for bignum_sub  ---\n");
+    if (bignum_sub_flight_start() != 0) {
+        printf("Failed to start the flight recorder\n");
+        return 1;
+    }
+
+    RUN_TEST(test_flight_records);
+    RUN_TEST(test_flight_wrap);
+    RUN_TEST(test_flight_threads);
+    RUN_TEST(test_flight_dump);
+    RUN_TEST(test_flight_crash);
+    RUN_TEST(test_flight_stop);
+
+    unlink(dump_path);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file    test_bignum_sub_shm.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты межпроцессного сервиса bignum_sub (bignum_sub_shm.h).
+ *
+ * @details
+ *   Демон запускается в процессе теста на временном сокете; клиенты —
+ *   сам тест и дочерние процессы (fork). Проверяется, что результаты и
+ *   коды возврата через демон совпадают с прямым вызовом, в том числе при
+ *   нескольких процессах с конвейером заявок; что указатель вне арены
+ *   отклоняется; что после остановки демона ожидание возвращает
+ *   BIGNUM_SUB_SHM_DISCONNECTED, а не зависает. Враждебный клиент: второй
+ *   поток меняет len операндов в арене, пока заявки выполняются (демон не
+ *   выходит за слоты и считает по своей копии), и подключение, которое
+ *   молчит, не задерживает других и отключается по сроку рукопожатия.
+ *
+ * @note    Для сборки требуется флаг `-pthread`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ *   - rev. 2 (17.10.2026): Гонка за len в арене и молчащее подключение.
+ */
+
+#define _GNU_SOURCE
+#include "bignum_sub.h"
+#include "bignum_sub_shm.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NUM_CLIENTS 3
+#define CALLS_PER_CLIENT 20000
+#define WINDOW 32
+#define RACE_CALLS 20000
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static char sock_path[64];
+static bignum_sub_shm_server_t *srv;
+
+static void bignum_set(bignum_t *x, size_t len, uint64_t seed) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) x->words[i] = seed * 0x9E3779B97F4A7C15ull + i;
+    if (len > 0 && x->words[len - 1] == 0) x->words[len - 1] = 1;
+    x->len = len;
+}
+
+/** Результат через демон совпадает с прямым вызовом на тех же операндах. */
+static int same_as_direct(const bignum_t *r, const bignum_t *a, const bignum_t *b, int st) {
+    bignum_t want;
+    memset(&want, 0, sizeof(want));
+    if ((int)bignum_sub(&want, a, b) != st) return 0;
+    return st != BIGNUM_SUB_SUCCESS || memcmp(r, &want, sizeof(want)) == 0;
+}
+
+int test_shm_call() {
+    bignum_sub_shm_client_t *c = bignum_sub_shm_connect(sock_path, 4);
+    if (!c) return 0;
+    size_t n;
+    bignum_t *x = bignum_sub_shm_arena(c, &n);
+    bignum_set(&x[0], 9, 1);
+    bignum_set(&x[1], 4, 2);
+    int ok = n == 4;
+    ok = ok && bignum_sub_shm_call(c, &x[2], &x[0], &x[1]) == BIGNUM_SUB_SUCCESS;
+    ok = ok && same_as_direct(&x[2], &x[0], &x[1], BIGNUM_SUB_SUCCESS);
+    ok = ok && bignum_sub_shm_call(c, &x[2], &x[1], &x[0]) == BIGNUM_SUB_ERROR_NEGATIVE_RESULT;
+    ok = ok && bignum_sub_shm_call(c, &x[2], NULL, &x[0]) == BIGNUM_SUB_ERROR_NULL_PTR;
+    ok = ok && bignum_sub_shm_call(c, &x[0], &x[0], &x[1]) == BIGNUM_SUB_ERROR_BUFFER_OVERLAP;
+    x[3] = x[0];
+    x[3].len = BIGNUM_CAPACITY + 1;
+    ok = ok && bignum_sub_shm_call(c, &x[2], &x[3], &x[1]) == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+    bignum_sub_shm_disconnect(c);
+    return ok;
+}
+
+int test_shm_bad_pointer() {
+    bignum_sub_shm_client_t *c = bignum_sub_shm_connect(sock_path, 2);
+    if (!c) return 0;
+    bignum_t *x = bignum_sub_shm_arena(c, NULL);
+    bignum_t local;
+    bignum_set(&local, 2, 3);
+    int ok = bignum_sub_shm_submit(c, &x[0], &local, &x[1]) == -1 && errno == EINVAL;
+    ok = ok && bignum_sub_shm_submit(c, &x[2], &x[0], &x[1]) == -1 && errno == EINVAL;
+    ok = ok && bignum_sub_shm_submit(c, (bignum_t *)((char *)x + 8), &x[0], &x[1]) == -1 && errno == EINVAL;
+    bignum_sub_shm_disconnect(c);
+    return ok;
+}
+
+/** Дочерний процесс: конвейер из WINDOW заявок, сверка каждой с прямым вызовом. */
+static int client_process(unsigned id) {
+    bignum_sub_shm_client_t *c = bignum_sub_shm_connect(sock_path, 3 * WINDOW);
+    if (!c) return 2;
+    bignum_t *x = bignum_sub_shm_arena(c, NULL);
+    bignum_t *a = x, *b = x + WINDOW, *r = x + 2 * WINDOW;
+    int64_t ticket[WINDOW];
+    for (unsigned i = 0; i < CALLS_PER_CLIENT + WINDOW; ++i) {
+        unsigned k = i % WINDOW;
+        if (i >= WINDOW) {
+            int st = bignum_sub_shm_wait(c, ticket[k], (i & 1) ? 64 : 0);
+            if (!same_as_direct(&r[k], &a[k], &b[k], st)) return 1;
+        }
+        if (i >= CALLS_PER_CLIENT) continue;
+        uint64_t seed = (uint64_t)id * CALLS_PER_CLIENT + i;
+        bignum_set(&a[k], 1 + seed % BIGNUM_CAPACITY, seed);
+        bignum_set(&b[k], seed % (a[k].len + 1), ~seed);
+        if (b[k].len == a[k].len && (seed & 7) != 0) b[k].words[b[k].len - 1] = a[k].words[a[k].len - 1] - 1;
+        ticket[k] = bignum_sub_shm_submit(c, &r[k], &a[k], &b[k]);
+        if (ticket[k] < 0) return 3;
+    }
+    bignum_sub_shm_disconnect(c);
+    return 0;
+}
+
+int test_shm_processes() {
+    bignum_sub_shm_server_counters_t before, after;
+    bignum_sub_shm_server_counters(srv, &before);
+    pid_t pid[NUM_CLIENTS];
+    for (unsigned i = 0; i < NUM_CLIENTS; ++i) {
+        fflush(stdout);
+        pid[i] = fork();
+        if (pid[i] == 0) _exit(client_process(i));
+    }
+    int ok = 1;
+    for (unsigned i = 0; i < NUM_CLIENTS; ++i) {
+        int wst = 0;
+        if (pid[i] < 0 || waitpid(pid[i], &wst, 0) != pid[i] || !WIFEXITED(wst) || WEXITSTATUS(wst) != 0) {
+            printf("  client %u failed (status 0x%x)\n", i, wst);
+            ok = 0;
+        }
+    }
+    bignum_sub_shm_server_counters(srv, &after);
+    printf("  %llu calls in %llu batches, %llu worker sleeps\n",
+           (unsigned long long)(after.calls - before.calls), (unsigned long long)(after.batches - before.batches),
+           (unsigned long long)(after.sleeps - before.sleeps));
+    return ok && after.clients - before.clients == NUM_CLIENTS &&
+           after.calls - before.calls == (uint64_t)NUM_CLIENTS * CALLS_PER_CLIENT;
+}
+
+/** Второй поток клиента: переключает len операндов между верной и огромной. */
+typedef struct {
+    bignum_t   *a, *b;
+    atomic_int  stop;
+    unsigned    flips;
+} flipper_t;
+
+static void *flipper_main(void *arg) {
+    flipper_t *f = arg;
+    volatile size_t *la = &f->a->len, *lb = &f->b->len;
+    while (!atomic_load_explicit(&f->stop, memory_order_relaxed)) {
+        *la = (size_t)1 << 24;
+        *lb = (size_t)1 << 20;
+        *la = 8;
+        *lb = 4;
+        f->flips++;
+    }
+    return NULL;
+}
+
+int test_shm_len_race() {
+    bignum_sub_shm_client_t *c = bignum_sub_shm_connect(sock_path, 8);
+    if (!c) return 0;
+    bignum_t *x = bignum_sub_shm_arena(c, NULL);
+    bignum_t a, b, want, guard;
+    bignum_set(&a, 8, 5);
+    bignum_set(&b, 4, 6);
+    memset(&want, 0, sizeof(want));
+    int ok = bignum_sub(&want, &a, &b) == BIGNUM_SUB_SUCCESS;
+    x[0] = a;
+    x[1] = b;
+    // Слоты за результатом — охрана от записи за пределы слота
+    memset(&guard, 0xA5, sizeof(guard));
+    for (unsigned i = 3; i < 8; ++i) x[i] = guard;
+    flipper_t f = { .a = &x[0], .b = &x[1], .flips = 0 };
+    atomic_init(&f.stop, 0);
+    pthread_t th;
+    if (pthread_create(&th, NULL, flipper_main, &f) != 0) {
+        bignum_sub_shm_disconnect(c);
+        return 0;
+    }
+    unsigned good = 0, rejected = 0;
+    for (unsigned i = 0; i < RACE_CALLS && ok; ++i) {
+        int64_t t = bignum_sub_shm_submit(c, &x[2], &x[0], &x[1]);
+        int st = t < 0 ? -1 : bignum_sub_shm_wait(c, t, 64);
+        if (st == BIGNUM_SUB_SUCCESS) {
+            ok = memcmp(&x[2], &want, sizeof(want)) == 0;
+            good++;
+        } else {
+            ok = st == BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED;
+            rejected++;
+        }
+        memset(&x[2], 0, sizeof(x[2]));
+    }
+    atomic_store(&f.stop, 1);
+    pthread_join(th, NULL);
+    for (unsigned i = 3; i < 8; ++i) ok = ok && memcmp(&x[i], &guard, sizeof(guard)) == 0;
+    printf("  %u ok, %u rejected, %u flips\n", good, rejected, f.flips);
+    // Демон жив и считает верно
+    x[0] = a;
+    x[1] = b;
+    ok = ok && bignum_sub_shm_call(c, &x[2], &x[0], &x[1]) == BIGNUM_SUB_SUCCESS;
+    ok = ok && memcmp(&x[2], &want, sizeof(want)) == 0;
+    bignum_sub_shm_disconnect(c);
+    return ok;
+}
+
+static double elapsed_ms(const struct timespec *t0) {
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return (double)(t1.tv_sec - t0->tv_sec) * 1e3 + (double)(t1.tv_nsec - t0->tv_nsec) / 1e6;
+}
+
+int test_shm_stalled_handshake() {
+    struct sockaddr_un sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    strcpy(sa.sun_path, sock_path);
+    int mute = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (mute < 0 || connect(mute, (struct sockaddr *)&sa, sizeof(sa)) != 0) return 0;
+    // Пока молчащее подключение ждёт, другие подключаются и отключаются без задержки
+    struct timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int ok = 1;
+    for (unsigned i = 0; i < 4 && ok; ++i) {
+        bignum_sub_shm_client_t *c = bignum_sub_shm_connect(sock_path, 3);
+        if (!c) {
+            ok = 0;
+            break;
+        }
+        bignum_t *x = bignum_sub_shm_arena(c, NULL);
+        bignum_set(&x[0], 3, i);
+        bignum_set(&x[1], 2, i + 1);
+        ok = bignum_sub_shm_call(c, &x[2], &x[0], &x[1]) == BIGNUM_SUB_SUCCESS;
+        bignum_sub_shm_disconnect(c);
+    }
+    double ms = elapsed_ms(&t0);
+    printf("  4 clients in %.1f ms behind a silent connection\n", ms);
+    ok = ok && ms < 500.0;
+    // Демон закрывает молчащее подключение по сроку рукопожатия
+    struct pollfd p = { mute, POLLIN, 0 };
+    char byte;
+    ok = ok && poll(&p, 1, 5000) == 1 && recv(mute, &byte, 1, 0) == 0;
+    close(mute);
+    return ok;
+}
+
+int test_shm_disconnect() {
+    bignum_sub_shm_client_t *c = bignum_sub_shm_connect(sock_path, 3);
+    if (!c) return 0;
+    bignum_t *x = bignum_sub_shm_arena(c, NULL);
+    bignum_set(&x[0], 3, 1);
+    bignum_set(&x[1], 2, 2);
+    int ok = bignum_sub_shm_call(c, &x[2], &x[0], &x[1]) == BIGNUM_SUB_SUCCESS;
+    bignum_sub_shm_server_stop(srv);
+    srv = NULL;
+    int64_t t = bignum_sub_shm_submit(c, &x[2], &x[0], &x[1]);
+    ok = ok && t >= 0 && bignum_sub_shm_wait(c, t, 0) == BIGNUM_SUB_SHM_DISCONNECTED;
+    bignum_sub_shm_disconnect(c);
+    // Сокет удалён: новое подключение невозможно
+    return ok && bignum_sub_shm_connect(sock_path, 1) == NULL;
+}
+
+int main() {
+    snprintf(sock_path, sizeof(sock_path), "/tmp/bignum_sub_shm_test_%d.sock", (int)getpid());
+    printf("\n--- Launching Shared-Memory Service Tests for bignum_sub  ---\n");
+    bignum_sub_shm_server_config_t cfg = { .path = sock_path, .workers = 2, .cpus = NULL, .batch = 16, .spin = 256 };
+    srv = bignum_sub_shm_server_start(&cfg);
+    if (!srv) {
+        perror("bignum_sub_shm_server_start");
+        return 1;
+    }
+
+    RUN_TEST(test_shm_call);
+    RUN_TEST(test_shm_bad_pointer);
+    RUN_TEST(test_shm_processes);
+    RUN_TEST(test_shm_len_race);
+    RUN_TEST(test_shm_stalled_handshake);
+    RUN_TEST(test_shm_disconnect);
+
+    bignum_sub_shm_server_stop(srv);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
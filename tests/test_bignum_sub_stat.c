@@ -0,0 +1,171 @@
+/**
+ * @file    test_bignum_sub_stat.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты счётчиков вызовов bignum_sub в разделяемой памяти (bignum_sub_stat.h).
+ *
+ * @details
+ *   Собирается с -Wl,--wrap=bignum_sub и библиотекой инструментирования
+ *   (см. INSTR_TESTS в Makefile; при сборке с STATS=0 тест пропускается).
+ *   Сегмент собственного процесса читается тем же
+ *   API, что и утилита bignum-sub-stat. Проверяются счётчики кодов
+ *   возврата и гистограммы длин и цепочек заимствования, раздельные слоты
+ *   потоков и то, что после остановки вызовы не считаются.
+ *
+ * @note    Для сборки требуется флаг `-pthread`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#include "bignum_sub.h"
+#include "bignum_sub_stat.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+#define CALLS_PER_THREAD 10000
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static bignum_sub_stat_reader_t rd;
+
+static void bignum_set(bignum_t *x, size_t len, uint64_t seed) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) x->words[i] = seed * 0x9E3779B97F4A7C15ull + i;
+    x->len = len;
+}
+
+static bignum_sub_stat_counts_t snapshot(void) {
+    bignum_sub_stat_counts_t c;
+    bignum_sub_stat_read(&rd, &c, NULL, NULL, 0);
+    return c;
+}
+
+int test_stat_counts() {
+    bignum_t a, b, r;
+    bignum_sub_stat_counts_t c0 = snapshot();
+
+    // Успех, цепочка заимствования 2: {0, 0, 1} - {1}
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    a.words[2] = 1;
+    a.len = 3;
+    b.words[0] = 1;
+    b.len = 1;
+    if (bignum_sub(&r, &a, &b) != BIGNUM_SUB_SUCCESS) return 0;
+    // Успех без заимствования
+    bignum_set(&a, 5, 3);
+    bignum_set(&b, 2, 0);
+    if (bignum_sub(&r, &a, &b) != BIGNUM_SUB_SUCCESS) return 0;
+    // Ошибки
+    if (bignum_sub(&r, NULL, &b) != BIGNUM_SUB_ERROR_NULL_PTR) return 0;
+    if (bignum_sub(&r, &b, &a) != BIGNUM_SUB_ERROR_NEGATIVE_RESULT) return 0;
+    a.len = BIGNUM_CAPACITY + 1;
+    if (bignum_sub(&r, &a, &b) != BIGNUM_SUB_ERROR_CAPACITY_EXCEEDED) return 0;
+    a.len = 5;
+    if (bignum_sub(&a, &a, &b) != BIGNUM_SUB_ERROR_BUFFER_OVERLAP) return 0;
+
+    bignum_sub_stat_counts_t c = snapshot();
+    if (c.calls - c0.calls != 6) return 0;
+    const uint64_t want_status[BIGNUM_SUB_STAT_STATUSES] = { 2, 1, 1, 1, 1 };
+    for (int i = 0; i < BIGNUM_SUB_STAT_STATUSES; ++i) {
+        if (c.status[i] - c0.status[i] != want_status[i]) return 0;
+    }
+    if (c.len[3] - c0.len[3] != 1 || c.len[5] - c0.len[5] != 2 || c.len[2] - c0.len[2] != 1 ||
+        c.len[BIGNUM_CAPACITY + 1] - c0.len[BIGNUM_CAPACITY + 1] != 1) {
+        return 0;
+    }
+    return c.borrow[2] - c0.borrow[2] == 1 && c.borrow[0] - c0.borrow[0] == 1;
+}
+
+static void *thread_func(void *arg) {
+    size_t len = (size_t)(uintptr_t)arg;
+    bignum_t a, b, r;
+    bignum_set(&a, len, len);
+    bignum_set(&b, len - 1, len + 1);
+    for (int i = 0; i < CALLS_PER_THREAD; ++i) bignum_sub(&r, &a, &b);
+    return NULL;
+}
+
+int test_stat_threads() {
+    static bignum_sub_stat_counts_t per[BIGNUM_SUB_STAT_MAX_THREADS];
+    pid_t tids[BIGNUM_SUB_STAT_MAX_THREADS];
+    pthread_t th[NUM_THREADS];
+    bignum_sub_stat_counts_t c0 = snapshot();
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        pthread_create(&th[t], NULL, thread_func, (void *)(uintptr_t)(t + 2));
+    }
+    for (int t = 0; t < NUM_THREADS; ++t) pthread_join(th[t], NULL);
+
+    bignum_sub_stat_counts_t c;
+    unsigned n = bignum_sub_stat_read(&rd, &c, per, tids, BIGNUM_SUB_STAT_MAX_THREADS);
+    if (n < 2 || n > NUM_THREADS + 1) return 0;   // main + потоки (слоты могли переиспользоваться)
+    if (c.calls - c0.calls != (uint64_t)NUM_THREADS * CALLS_PER_THREAD) return 0;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        if (c.len[t + 2] - c0.len[t + 2] != CALLS_PER_THREAD) return 0;
+    }
+    uint64_t sum = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        if (tids[i] <= 0) return 0;
+        sum += per[i].calls;
+    }
+    return sum == c.calls;
+}
+
+int test_stat_stop() {
+    bignum_t a, b, r;
+    bignum_set(&a, 4, 1);
+    bignum_set(&b, 2, 2);
+    if (bignum_sub_stat_start() != -1) return 0;   // повторный старт запрещён
+    bignum_sub_stat_counts_t c0 = snapshot();
+    if (bignum_sub_stat_stop() != 0) return 0;
+    bignum_sub(&r, &a, &b);                         // после остановки не считается
+    bignum_sub_stat_counts_t c = snapshot();
+    bignum_sub_stat_reader_t gone;
+    return c.calls == c0.calls && bignum_sub_stat_stop() == -1 &&
+           bignum_sub_stat_open(&gone, getpid()) == -1;   // имя сегмента удалено
+}
+
+int main() {
+    printf("\n--- Launching Stat Tests for bignum_sub  ---\n");
+#if !BIGNUM_SUB_STATS
+    printf("Call counters are compiled out (STATS=0), skipping\n");
+    return 0;
+#endif
+    if (bignum_sub_stat_start() != 0 || bignum_sub_stat_open(&rd, getpid()) != 0) {
+        printf("Failed to publish statistics\n");
+        return 1;
+    }
+
+    RUN_TEST(test_stat_counts);
+    RUN_TEST(test_stat_threads);
+    RUN_TEST(test_stat_stop);
+
+    bignum_sub_stat_close(&rd);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file    test_bignum_sub_trace.c
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @brief   Тесты захвата трассы вызовов bignum_sub (bignum_sub_trace.h).
+ *
+ * @details
+ *   Собирается с -Wl,--wrap=bignum_sub и библиотекой инструментирования
+ *   (см. INSTR_TESTS в Makefile). Проверяется, что записанная трасса
+ *   читается обратно с теми же длинами, кодами возврата, флагами и словами
+ *   операндов, что режим форм не пишет слова, что вызовы вне записи не
+ *   попадают в трассу и что записи всех потоков сохраняются.
+ *
+ * @note    Для сборки требуется флаг `-pthread`.
+ *
+ * @history
+ *   - rev. 1 (17.10.2026): Первоначальное создание.
+ */
+
+#include "bignum_sub.h"
+#include "bignum_sub_trace.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+// Больше, чем помещается в один буфер потока, чтобы проверить сброс
+#define CALLS_PER_THREAD 20000
+
+// Макрос для запуска тестов и подсчета результатов
+#define RUN_TEST(test_func) \
+    do { \
+        printf("Running %s...\n", #test_func); \
+        if (test_func()) { \
+            printf("  %s: PASSED\n", #test_func); \
+            tests_passed++; \
+        } else { \
+            printf("  %s: FAILED\n", #test_func); \
+            tests_failed++; \
+        } \
+    } while (0)
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static char trace_path[64];
+
+static void bignum_set(bignum_t *x, size_t len, uint64_t seed) {
+    memset(x, 0, sizeof(*x));
+    for (size_t i = 0; i < len; ++i) x->words[i] = seed * 0x9E3779B97F4A7C15ull + i;
+    x->len = len;
+}
+
+/** Ожидаемая запись и операнды одного вызова. */
+typedef struct {
+    bignum_t a;
+    bignum_t b;
+    int      status;
+    unsigned flags;
+} expected_t;
+
+/** Вызовы со всеми кодами возврата; ожидания записываются в `exp`. */
+static int make_calls(expected_t *exp) {
+    bignum_t a, b, r;
+    int n = 0;
+
+    bignum_set(&a, 4, 1);
+    bignum_set(&b, 2, 2);
+    exp[n] = (expected_t){ a, b, bignum_sub(&r, &a, &b), 0 };
+    n++;
+
+    bignum_set(&a, 1, 0);
+    a.words[0] = 1;
+    bignum_set(&b, 3, 5);
+    exp[n] = (expected_t){ a, b, bignum_sub(&r, &a, &b), 0 };
+    n++;
+
+    bignum_set(&a, 2, 7);
+    bignum_set(&b, 1, 8);
+    a.len = BIGNUM_CAPACITY + 1;
+    exp[n] = (expected_t){ a, b, bignum_sub(&r, &a, &b), 0 };
+    exp[n].a.len = BIGNUM_CAPACITY + 1;
+    n++;
+    a.len = 2;
+
+    exp[n] = (expected_t){ a, b, bignum_sub(&a, &a, &b), BIGNUM_SUB_TRACE_REC_ALIAS_A };
+    n++;
+
+    memset(&exp[n], 0, sizeof(exp[n]));
+    exp[n].b = b;
+    exp[n].status = bignum_sub(&r, NULL, &b);
+    exp[n].flags = BIGNUM_SUB_TRACE_REC_NULL_A;
+    n++;
+    return n;
+}
+
+static int check_trace(const expected_t *exp, int n, int with_operands) {
+    bignum_sub_trace_reader_t rd;
+    bignum_sub_trace_rec_t rec;
+    bignum_t a, b;
+    if (bignum_sub_trace_open(&rd, trace_path) != 0) return 0;
+    int ok = 1;
+    for (int i = 0; i < n && ok; ++i) {
+        if (bignum_sub_trace_next(&rd, &rec, &a, &b) != 1) {
+            ok = 0;
+            break;
+        }
+        unsigned want_flags = exp[i].flags | (with_operands ? BIGNUM_SUB_TRACE_REC_OPERANDS : 0);
+        ok = rec.status == exp[i].status && rec.flags == want_flags &&
+             rec.len_a == exp[i].a.len && rec.len_b == exp[i].b.len;
+        if (ok && with_operands) {
+            size_t wa = exp[i].a.len > BIGNUM_CAPACITY ? BIGNUM_CAPACITY : exp[i].a.len;
+            ok = memcmp(a.words, exp[i].a.words, wa * sizeof(uint64_t)) == 0 &&
+                 memcmp(b.words, exp[i].b.words, exp[i].b.len * sizeof(uint64_t)) == 0;
+        }
+        if (!ok) fprintf(stderr, "Record %d mismatch (status %d, flags %u)\n", i, rec.status, rec.flags);
+    }
+    if (ok && bignum_sub_trace_next(&rd, &rec, &a, &b) != 0) ok = 0;   // лишних записей нет
+    bignum_sub_trace_close(&rd);
+    return ok;
+}
+
+int test_trace_roundtrip() {
+    expected_t exp[8];
+    if (bignum_sub_trace_start(trace_path, 0) != 0) return 0;
+    int n = make_calls(exp);
+    if (bignum_sub_trace_stop() != 0) return 0;
+    return check_trace(exp, n, 1);
+}
+
+int test_trace_shapes_only() {
+    expected_t exp[8];
+    if (bignum_sub_trace_start(trace_path, BIGNUM_SUB_TRACE_SHAPES_ONLY) != 0) return 0;
+    int n = make_calls(exp);
+    if (bignum_sub_trace_stop() != 0) return 0;
+    return check_trace(exp, n, 0);
+}
+
+int test_trace_disabled() {
+    expected_t exp[8];
+    if (bignum_sub_trace_start(trace_path, 0) != 0) return 0;
+    if (bignum_sub_trace_start(trace_path, 0) != -1) return 0;   // повторный старт запрещён
+    if (bignum_sub_trace_stop() != 0) return 0;
+    make_calls(exp);                                             // вне записи
+    return check_trace(exp, 0, 1) && bignum_sub_trace_stop() == -1;
+}
+
+static void *thread_func(void *arg) {
+    size_t len = (size_t)(uintptr_t)arg;
+    bignum_t a, b, r;
+    bignum_set(&a, len, len);
+    bignum_set(&b, len - 1, len + 1);
+    for (int i = 0; i < CALLS_PER_THREAD; ++i) bignum_sub(&r, &a, &b);
+    return NULL;
+}
+
+int test_trace_threads() {
+    pthread_t th[NUM_THREADS];
+    if (bignum_sub_trace_start(trace_path, 0) != 0) return 0;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        pthread_create(&th[t], NULL, thread_func, (void *)(uintptr_t)(t + 2));
+    }
+    for (int t = 0; t < NUM_THREADS; ++t) pthread_join(th[t], NULL);
+    if (bignum_sub_trace_stop() != 0) return 0;
+
+    bignum_sub_trace_reader_t rd;
+    bignum_sub_trace_rec_t rec;
+    bignum_t a, b;
+    unsigned per_len[NUM_THREADS + 2] = { 0 };
+    int rc;
+    if (bignum_sub_trace_open(&rd, trace_path) != 0) return 0;
+    while ((rc = bignum_sub_trace_next(&rd, &rec, &a, &b)) == 1) {
+        if (rec.len_a < 2 || rec.len_a >= NUM_THREADS + 2 || rec.len_b != rec.len_a - 1 ||
+            rec.status != BIGNUM_SUB_SUCCESS || a.words[0] != rec.len_a * 0x9E3779B97F4A7C15ull) {
+            rc = -1;
+            break;
+        }
+        per_len[rec.len_a]++;
+    }
+    bignum_sub_trace_close(&rd);
+    if (rc != 0) return 0;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        if (per_len[t + 2] != CALLS_PER_THREAD) return 0;
+    }
+    return 1;
+}
+
+int main() {
+    snprintf(trace_path, sizeof(trace_path), "/tmp/bignum_sub_trace_%d.bin", (int)getpid());
+    printf("\n--- Launching Trace Tests for bignum_sub  ---\n");
+
+    RUN_TEST(test_trace_roundtrip);
+    RUN_TEST(test_trace_shapes_only);
+    RUN_TEST(test_trace_disabled);
+    RUN_TEST(test_trace_threads);
+
+    unlink(trace_path);
+
+    printf("\n--- Test Summary ---\n");
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+    printf("\n----------------------\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
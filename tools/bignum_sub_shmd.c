@@ -0,0 +1,128 @@
+/**
+ * @file    bignum_sub_shmd.c
+ * @brief   bignum-sub-shmd: демон межпроцессного сервиса bignum_sub.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Запускает bignum_sub_shm_server_start() (bignum_sub_shm.h) на сокете
+ *   --socket и обслуживает клиентов до SIGINT/SIGTERM. Рабочие потоки
+ *   закрепляются за CPU из --cpus (список через запятую, по одному на
+ *   поток; без --cpus — без закрепления). Раз в --interval секунд (0 —
+ *   никогда) печатает счётчики: клиентов, заявок в секунду, средний пакет.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *
+ * # Запуск
+ *  bin/bignum-sub-shmd --workers=2 --cpus=2,3 &
+ *  bin/bench_bignum_sub_shm --socket=/tmp/bignum_sub_shmd.sock
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bignum_sub_shm.h"
+
+typedef struct {
+    const char *path;
+    unsigned    workers;
+    unsigned    batch;
+    unsigned    spin;
+    double      interval;
+    int         cpus[BIGNUM_SUB_SHM_MAX_WORKERS];
+    unsigned    ncpus;
+} options_t;
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static int parse_cpus(const char *v, options_t *o) {
+    char *end;
+    for (o->ncpus = 0; *v; v = end + (*end == ',')) {
+        long cpu = strtol(v, &end, 10);
+        if (end == v || cpu < 0 || o->ncpus == BIGNUM_SUB_SHM_MAX_WORKERS) return -1;
+        o->cpus[o->ncpus++] = (int)cpu;
+    }
+    return o->ncpus > 0 ? 0 : -1;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .path = BIGNUM_SUB_SHM_SOCKET, .interval = 0.0 };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--socket="))) o->path = v;
+        else if ((v = arg_value(argv[i], "--workers="))) o->workers = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--batch="))) o->batch = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--spin="))) o->spin = (unsigned)strtoul(v, NULL, 10);
+        else if ((v = arg_value(argv[i], "--interval="))) o->interval = strtod(v, NULL);
+        else if ((v = arg_value(argv[i], "--cpus="))) {
+            if (parse_cpus(v, o) != 0) return -1;
+        } else return -1;
+    }
+    // Число потоков по умолчанию — по списку CPU
+    if (o->workers == 0) o->workers = o->ncpus ? o->ncpus : 1;
+    if (o->ncpus && o->ncpus != o->workers) return -1;
+    return o->workers <= BIGNUM_SUB_SHM_MAX_WORKERS && o->batch <= BIGNUM_SUB_SHM_MAX_BATCH &&
+           o->interval >= 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    if (parse_options(argc, argv, &opt) != 0) {
+        fprintf(stderr, "Usage: %s [--socket=PATH] [--workers=N] [--cpus=C0,C1,...] [--batch=N] [--spin=N] "
+                        "[--interval=SEC]\n", argv[0]);
+        return 1;
+    }
+
+    // Сигналы остановки принимаются только через sigwait: рабочие потоки наследуют маску
+    sigset_t stop;
+    sigemptyset(&stop);
+    sigaddset(&stop, SIGINT);
+    sigaddset(&stop, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    bignum_sub_shm_server_config_t cfg = { .path = opt.path, .workers = opt.workers,
+                                           .cpus = opt.ncpus ? opt.cpus : NULL,
+                                           .batch = opt.batch, .spin = opt.spin };
+    bignum_sub_shm_server_t *srv = bignum_sub_shm_server_start(&cfg);
+    if (!srv) {
+        fprintf(stderr, "Cannot start on %s: %s\n", opt.path, strerror(errno));
+        return 1;
+    }
+    printf("bignum-sub-shmd: %u worker(s) on %s\n", opt.workers, opt.path);
+    fflush(stdout);
+
+    bignum_sub_shm_server_counters_t cur, prev = { 0 };
+    struct timespec ts = { (time_t)opt.interval, (long)((opt.interval - (time_t)opt.interval) * 1e9) };
+    int sig = 0;
+    for (;;) {
+        if (opt.interval == 0) {
+            sigwait(&stop, &sig);
+            break;
+        }
+        if ((sig = sigtimedwait(&stop, NULL, &ts)) > 0) break;
+        bignum_sub_shm_server_counters(srv, &cur);
+        uint64_t calls = cur.calls - prev.calls, batches = cur.batches - prev.batches;
+        printf("%llu client(s), %.3f Mcalls/s, %.1f calls/batch, %llu worker sleeps\n",
+               (unsigned long long)cur.clients, (double)calls / opt.interval * 1e-6,
+               batches ? (double)calls / (double)batches : 0.0, (unsigned long long)(cur.sleeps - prev.sleeps));
+        fflush(stdout);
+        prev = cur;
+    }
+
+    bignum_sub_shm_server_counters(srv, &cur);
+    bignum_sub_shm_server_stop(srv);
+    printf("bignum-sub-shmd: stopped by signal %d after %llu calls from %llu client(s)\n", sig,
+           (unsigned long long)cur.calls, (unsigned long long)cur.clients);
+    return 0;
+}
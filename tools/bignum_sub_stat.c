@@ -0,0 +1,146 @@
+/**
+ * @file    bignum_sub_stat.c
+ * @brief   bignum-sub-stat: живой просмотр счётчиков bignum_sub другого процесса.
+ * @author  git@bayborodov.com
+ * @version 1.0.0
+ * @date    17.10.2026
+ *
+ * @details
+ *   Открывает сегмент `/bignum_sub_stat.<pid>` (bignum_sub_stat.h) только
+ *   для чтения и раз в --interval секунд печатает снимок: число вызовов и
+ *   вызовов в секунду, доли кодов возврата, гистограммы a->len и длины
+ *   цепочки заимствования (доли за интервал; для первого снимка — за всё
+ *   время), с --threads — строку на каждый поток. Наблюдаемый процесс
+ *   не блокируется и не замедляется: читатель только читает его страницы.
+ *   Работа заканчивается после --count снимков или когда процесс завершился.
+ *
+ * @history
+ *   - rev 1.0 (17.10.2026): Первоначальная версия.
+ *
+ * # Запуск
+ *  BIGNUM_SUB_STAT=1 ./app &
+ *  bin/bignum-sub-stat --interval=1 --threads $!
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bignum_sub_stat.h"
+
+static const char *const status_names[BIGNUM_SUB_STAT_STATUSES] = {
+    "ok", "null", "negative", "capacity", "overlap"
+};
+
+typedef struct {
+    double      interval;
+    unsigned    count;      // 0 — пока процесс жив
+    int         threads;
+    pid_t       pid;
+} options_t;
+
+static bignum_sub_stat_counts_t cur, prev, delta;
+static bignum_sub_stat_counts_t thr[BIGNUM_SUB_STAT_MAX_THREADS], thr_prev[BIGNUM_SUB_STAT_MAX_THREADS];
+static pid_t tids[BIGNUM_SUB_STAT_MAX_THREADS], tids_prev[BIGNUM_SUB_STAT_MAX_THREADS];
+
+static void counts_sub(bignum_sub_stat_counts_t *d, const bignum_sub_stat_counts_t *x,
+                       const bignum_sub_stat_counts_t *y) {
+    d->calls = x->calls - y->calls;
+    for (unsigned i = 0; i < BIGNUM_SUB_STAT_STATUSES; ++i) d->status[i] = x->status[i] - y->status[i];
+    for (unsigned i = 0; i < BIGNUM_SUB_STAT_LEN_BINS; ++i) d->len[i] = x->len[i] - y->len[i];
+    for (unsigned i = 0; i < BIGNUM_SUB_STAT_BORROW_BINS; ++i) d->borrow[i] = x->borrow[i] - y->borrow[i];
+}
+
+/** Ненулевые корзины гистограммы как "bin:доля%". */
+static void print_hist(const char *name, const uint64_t *bins, unsigned n, const char *last_name) {
+    uint64_t total = 0;
+    for (unsigned i = 0; i < n; ++i) total += bins[i];
+    printf("  %-8s", name);
+    if (total == 0) printf(" -");
+    for (unsigned i = 0; i < n; ++i) {
+        if (bins[i] == 0) continue;
+        if (last_name && i == n - 1) printf(" %s:%.1f%%", last_name, 100.0 * (double)bins[i] / (double)total);
+        else printf(" %u:%.1f%%", i, 100.0 * (double)bins[i] / (double)total);
+    }
+    printf("\n");
+}
+
+static void print_snapshot(const options_t *o, unsigned nthr, double dt, int first) {
+    const bignum_sub_stat_counts_t *c = first ? &cur : &delta;
+    time_t now = time(NULL);
+    char ts[16];
+    strftime(ts, sizeof(ts), "%H:%M:%S", localtime(&now));
+    printf("%s pid %d: %u thread(s), %llu calls", ts, (int)o->pid, nthr, (unsigned long long)cur.calls);
+    if (!first) printf(", %.3f Mcalls/s", (double)delta.calls / dt * 1e-6);
+    printf("\n  %-8s", "status");
+    for (unsigned i = 0; i < BIGNUM_SUB_STAT_STATUSES; ++i) {
+        printf(" %s:%.2f%%", status_names[i], c->calls ? 100.0 * (double)c->status[i] / (double)c->calls : 0.0);
+    }
+    printf("\n");
+    print_hist("len_a", c->len, BIGNUM_SUB_STAT_LEN_BINS, ">32");
+    print_hist("borrow", c->borrow, BIGNUM_SUB_STAT_BORROW_BINS, NULL);
+
+    if (!o->threads) return;
+    unsigned shown = nthr < BIGNUM_SUB_STAT_MAX_THREADS ? nthr : BIGNUM_SUB_STAT_MAX_THREADS;
+    for (unsigned t = 0; t < shown; ++t) {
+        // Слот мог сменить владельца: тогда скорость считается от нуля
+        uint64_t before = !first && tids_prev[t] == tids[t] ? thr_prev[t].calls : thr[t].calls;
+        printf("    tid %-8d %14llu calls", (int)tids[t], (unsigned long long)thr[t].calls);
+        if (!first) printf("  %10.3f Mcalls/s", (double)(thr[t].calls - before) / dt * 1e-6);
+        printf("  ok %.2f%%\n", thr[t].calls ? 100.0 * (double)thr[t].status[0] / (double)thr[t].calls : 0.0);
+    }
+}
+
+static const char *arg_value(const char *arg, const char *key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 ? arg + n : NULL;
+}
+
+static int parse_options(int argc, char **argv, options_t *o) {
+    const char *v;
+    *o = (options_t){ .interval = 1.0 };
+    for (int i = 1; i < argc; ++i) {
+        if ((v = arg_value(argv[i], "--interval="))) o->interval = strtod(v, NULL);
+        else if ((v = arg_value(argv[i], "--count="))) o->count = (unsigned)strtoul(v, NULL, 10);
+        else if (strcmp(argv[i], "--threads") == 0) o->threads = 1;
+        else if (argv[i][0] != '-' && o->pid == 0) o->pid = (pid_t)strtol(argv[i], NULL, 10);
+        else return -1;
+    }
+    return o->pid > 0 && o->interval > 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    options_t opt;
+    bignum_sub_stat_reader_t rd;
+    if (parse_options(argc, argv, &opt) != 0) {
+        fprintf(stderr, "Usage: %s [--interval=SEC] [--count=N] [--threads] PID\n", argv[0]);
+        return 1;
+    }
+    if (bignum_sub_stat_open(&rd, opt.pid) != 0) {
+        fprintf(stderr, "No bignum_sub statistics for pid %d (start it with BIGNUM_SUB_STAT=1 "
+                        "and link with -Wl,--wrap=bignum_sub -lbignum_sub_instr)\n", (int)opt.pid);
+        return 1;
+    }
+
+    struct timespec ts = { (time_t)opt.interval, (long)((opt.interval - (time_t)opt.interval) * 1e9) };
+    for (unsigned n = 0; opt.count == 0 || n < opt.count; ++n) {
+        if (n > 0) nanosleep(&ts, NULL);
+        int alive = kill(opt.pid, 0) == 0 || errno != ESRCH;
+        unsigned nthr = bignum_sub_stat_read(&rd, &cur, thr, tids, BIGNUM_SUB_STAT_MAX_THREADS);
+        counts_sub(&delta, &cur, &prev);
+        print_snapshot(&opt, nthr, opt.interval, n == 0);
+        fflush(stdout);
+        prev = cur;
+        memcpy(thr_prev, thr, sizeof(thr));
+        memcpy(tids_prev, tids, sizeof(tids));
+        if (!alive) {
+            printf("Process %d exited.\n", (int)opt.pid);
+            break;
+        }
+    }
+    bignum_sub_stat_close(&rd);
+    return 0;
+}